@@ -0,0 +1,70 @@
+#!/bin/zsh
+
+# builds the game logic natively (gcc/clang) against the host HAL backend in host/
+# the result, build_host/infest_host, runs frames as fast as the host can and prints frames/sec and a state hash
+# see hal.h for what the host backend does and does not emulate
+#
+# golden check: every build runs a fixed seed with the scripted player against the frame and state hashes checked in
+#   as host/golden_hashes.txt (see the end of this script), and fails if they don't match.
+#   a change that is meant to change the game: run that line again with -u, and check in the new golden_hashes.txt
+# golden-frame check for render path changes, with pictures of what changed (see host/compositor.h):
+#   before the change:  build_host/infest_host -f 5000 -g build_host/golden -u
+#   after the change:   build_host/infest_host -f 5000 -g build_host/golden
+#   any mismatch exits with 2 and leaves frame_NNNNNN.new.ppm / .diff.ppm next to the golden
+
+PROJECT=$(cd "$(dirname "$0")" && pwd)
+
+# debug logging levels: 1=error, 2=warn, 3=info, 4=debug general, 5=allocations
+# host builds log to the kernel file path only, so leave these off unless that path has been stubbed
+DEBUG_DEFS=
+
+# input recording/replay: same switches as _build_vbcc.sh. host replay file goes to the current directory.
+#REPLAY_DEF="-DINPUT_RECORD"
+#REPLAY_DEF="-DINPUT_PLAYBACK"
+REPLAY_DEF=
+
+# per-frame telemetry (telemetry.h). packets go to the file or pty given to infest_host -t.
+#   live:  python3 tools/telemetry_capture.py --pty -o session.csv -p session.svg, then infest_host -t <the pty it names>
+#TELEMETRY_DEF="-DUSE_TELEMETRY"
+
+# text shadow: same switch as _build_vbcc.sh. infest_host prints text VRAM bytes/frame either way, to compare.
+#TEXT_SHADOW_DEF="-DUSE_TEXT_SHADOW"
+TEXT_SHADOW_DEF=
+
+# -O2 -g for perf/gprof; add -fsanitize=address,undefined to check for out of range accesses
+OPTI="-O2 -g"
+
+CC=${CC:-gcc}
+BUILD_DIR=$PROJECT/build_host
+
+cd $PROJECT
+
+echo "\n**************************\nHost compile start...\n**************************\n"
+
+mkdir -p $BUILD_DIR $BUILD_DIR/golden
+
+# same zero page layout check as the F256 build. host builds define the variables from zp_layout.h
+python3 $PROJECT/tools/zp_layout.py $PROJECT/zp_layout.txt -c $PROJECT/config_cc65/infest_overlay_f256.cfg -i $PROJECT/zp_layout.inc -H $PROJECT/zp_layout.h || exit 1
+
+# UI strings: same packing as the F256 build. infest_host loads data/strings.bin where the pgZ would put it
+python3 $PROJECT/tools/string_pack.py $PROJECT/strings.txt -o $PROJECT/data/strings.bin -H $PROJECT/strings.h || exit 1
+
+$CC -DHOST_BUILD $DEBUG_DEFS $REPLAY_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $OPTI -Wall -Wno-unknown-pragmas \
+	-o $BUILD_DIR/infest_host \
+	host/hal_host.c host/compositor.c host/infest_host.c \
+	anim.c app.c asset_stream.c comm_buffer.c file_io.c flow_field.c general.c level.c object.c player.c playfield.c present.c replay.c save_state.c overlay_startup.c screen.c strings.c sys.c telemetry.c text.c || exit 1
+
+# asset streamer check (host/stream_test.c): loads real files from data/ through asset_stream.c and FileIO
+$CC -DHOST_BUILD $OPTI -Wall -Wno-unknown-pragmas \
+	-o $BUILD_DIR/stream_test \
+	host/stream_test.c host/hal_host.c asset_stream.c file_io.c || exit 1
+$BUILD_DIR/stream_test > $BUILD_DIR/stream_test.txt || { cat $BUILD_DIR/stream_test.txt; exit 1; }
+tail -1 $BUILD_DIR/stream_test.txt
+
+# golden check. INPUT_PLAYBACK takes its input from a replay file instead of the scripted player, and INPUT_RECORD
+#   writes one to the current directory, so it only runs without REPLAY_DEF
+if [ -z "$REPLAY_DEF" ]; then
+	$BUILD_DIR/infest_host -d $PROJECT/data -s 7 -f 3000 -c 500 -G $PROJECT/host/golden_hashes.txt -q || exit 1
+fi
+
+echo "\n**************************\nHost build complete: $BUILD_DIR/infest_host\n**************************\n"
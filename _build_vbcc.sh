@@ -24,6 +24,45 @@ DEBUG_DEF_5=
 DEBUG_VIA_SERIAL="-DUSE_SERIAL_LOGGING"
 #DEBUG_VIA_SERIAL=
 
+# serial debug as binary records instead of text (needs DEBUG_VIA_SERIAL). a log call only queues a 16 byte record,
+#   and the UART is fed from the wait at the end of each frame. the build writes the table to decode them with:
+#   python3 tools/log_decode.py build_cc65/log_table.json /dev/tty.usbserial-FT53JP031
+#DEBUG_BINARY="-DUSE_BINARY_LOGGING"
+DEBUG_BINARY=
+
+# input recording/replay for repeatable benchmark sessions. define at most one.
+#   INPUT_RECORD writes RNG seed + per-frame input to 0:infest_replay.bin (or to serial, if serial debug logging is on)
+#   INPUT_PLAYBACK reads 0:infest_replay.bin back in place of live input
+#REPLAY_DEF="-DINPUT_RECORD"
+#REPLAY_DEF="-DINPUT_PLAYBACK"
+REPLAY_DEF=
+
+# asset packing. "--lz4" carries sprites/tiles/tilemap LZ4-compressed in the pgZ; Startup_ExpandAssets() unpacks them at boot.
+#   the packer prints raw vs. compressed asset bytes and the final pgZ size either way.
+#ASSET_LZ4="--lz4"
+ASSET_LZ4=
+
+# per-frame profiling, timed with timer 0 and logged (LOG_INFO) every 64 frames. needs DEBUG_DEF_3 on to see the output.
+#   PROFILE_SPRITE_LOOPS: average CPU cycles per frame spent in Level_UpdateSprites()
+#   PROFILE_PRESENT: average and worst CPU cycles per start-of-frame flush (sprites incl. Level_RenderSprites(), scroll,
+#     tiles, HUD), and how many flushes came late because the frame before ran long
+#   PROFILE_STARTUP: CPU cycles for each stage of boot (App_InitializeApp(), first App_InitializeGame()), and the total
+#     ms from boot to the first frame. logged once, not every 64 frames.
+#PROFILE_DEF="-DPROFILE_SPRITE_LOOPS"
+#PROFILE_DEF="-DPROFILE_PRESENT"
+#PROFILE_DEF="-DPROFILE_STARTUP"
+PROFILE_DEF=
+
+# per-frame telemetry over serial (telemetry.h): player, HP, sprite counts, busy cycles, IO page swaps. can't go with PROFILE_DEF.
+#   python3 tools/telemetry_capture.py /dev/tty.usbserial-FT53JP031 -o session.csv -p session.svg
+#TELEMETRY_DEF="-DUSE_TELEMETRY"
+TELEMETRY_DEF=
+
+# text shadow (text.h): Text_* draw into a copy of the screen in RAM (2.4K), and each frame only the cells that changed
+#   go to VICKY. PROFILE_PRESENT logs text VRAM bytes/frame either way, to compare.
+#TEXT_SHADOW_DEF="-DUSE_TEXT_SHADOW"
+TEXT_SHADOW_DEF=
+
 #STACK_CHECK="--check-stack"
 STACK_CHECK=
 
@@ -43,6 +82,15 @@ DATADIR=data
 
 cd $PROJECT
 
+# zero page: check the layout fits in ZP_LK and regenerate the asm/C views of it before anything includes them
+python3 $PROJECT/tools/zp_layout.py $PROJECT/zp_layout.txt -c $CONFIG_DIR/$OVERLAY_CONFIG -i $PROJECT/zp_layout.inc -H $PROJECT/zp_layout.h || exit 1
+
+# UI strings: pack strings.txt into the strings.bin asset (and say how much MAIN that saves), regenerate strings.h
+python3 $PROJECT/tools/string_pack.py $PROJECT/strings.txt -o $PROJECT/$DATADIR/strings.bin -H $PROJECT/strings.h || exit 1
+
+# asset addresses: check the pgZ layout and regenerate pgz_layout.h before anything includes it
+python3 $PROJECT/tools/pgz_pack.py $PROJECT/pgz_manifest.txt -d $PROJECT/$DATADIR -H $PROJECT/pgz_layout.h $ASSET_LZ4 || exit 1
+
 echo "\n**************************\nCC65 compile start...\n**************************\n"
 which cc65
 
@@ -50,22 +98,38 @@ mkdir -p $BUILD_DIR
 mkdir -p $BUILD_DIR/infest_install/
 mkdir -p $BUILD_DIR/infest_install/disk
 
+# binary log records: check every log call fits in a record, and write the table log_decode.py reads,
+#   and the LOG_SITE_ macros general.h includes from the build directory
+if [ -n "$DEBUG_BINARY" ]; then
+	python3 $PROJECT/tools/log_table.py $PROJECT/general.h -o $BUILD_DIR/log_table.json -s $BUILD_DIR/log_sites.h $PROJECT/*.c || exit 1
+	DEBUG_BINARY="$DEBUG_BINARY -I $BUILD_DIR"
+fi
+
 rm -r $BUILD_DIR/*.s
 rm -r $BUILD_DIR/*.o
 
 # compile
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T app.c -o $BUILD_DIR/app.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T comm_buffer.c -o $BUILD_DIR/comm_buffer.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T general.c -o $BUILD_DIR/general.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T keyboard.c -o $BUILD_DIR/keyboard.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T level.c -o $BUILD_DIR/level.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T object.c -o $BUILD_DIR/object.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_STARTUP $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T overlay_startup.c -o $BUILD_DIR/overlay_startup.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T player.c -o $BUILD_DIR/player.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_SCREEN $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T screen.c -o $BUILD_DIR/screen.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T strings.c -o $BUILD_DIR/strings.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T sys.c -o $BUILD_DIR/sys.s
-cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $STACK_CHECK -T text.c -o $BUILD_DIR/text.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T anim.c -o $BUILD_DIR/anim.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T app.c -o $BUILD_DIR/app.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T asset_stream.c -o $BUILD_DIR/asset_stream.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T comm_buffer.c -o $BUILD_DIR/comm_buffer.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T file_io.c -o $BUILD_DIR/file_io.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T flow_field.c -o $BUILD_DIR/flow_field.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T general.c -o $BUILD_DIR/general.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T keyboard.c -o $BUILD_DIR/keyboard.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T level.c -o $BUILD_DIR/level.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T object.c -o $BUILD_DIR/object.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_STARTUP $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T overlay_startup.c -o $BUILD_DIR/overlay_startup.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T player.c -o $BUILD_DIR/player.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T playfield.c -o $BUILD_DIR/playfield.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T present.c -o $BUILD_DIR/present.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T replay.c -o $BUILD_DIR/replay.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T save_state.c -o $BUILD_DIR/save_state.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT --code-name OVERLAY_SCREEN $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T screen.c -o $BUILD_DIR/screen.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T strings.c -o $BUILD_DIR/strings.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T sys.c -o $BUILD_DIR/sys.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T telemetry.c -o $BUILD_DIR/telemetry.s
+cc65 -g --cpu $CC65CPU -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS $DEBUG_DEF_1 $DEBUG_DEF_2 $DEBUG_DEF_3 $DEBUG_DEF_4 $DEBUG_DEF_5 $DEBUG_VIA_SERIAL $DEBUG_BINARY $REPLAY_DEF $PROFILE_DEF $TELEMETRY_DEF $TEXT_SHADOW_DEF $STACK_CHECK -T text.c -o $BUILD_DIR/text.s
 
 # Kernel access
 cc65 -g --cpu 65C02 -t $CC65TGT $OPTI -I $CONFIG_DIR $TARGET_DEFS $PLATFORM_DEFS -T kernel.c -o $BUILD_DIR/kernel.s
@@ -75,17 +139,26 @@ echo "\n**************************\nCA65 assemble start...\n********************
 
 # assemble into object files
 cd $BUILD_DIR
+ca65 -t $CC65TGT anim.s
 ca65 -t $CC65TGT app.s
+ca65 -t $CC65TGT asset_stream.s
 ca65 -t $CC65TGT comm_buffer.s
+ca65 -t $CC65TGT file_io.s
+ca65 -t $CC65TGT flow_field.s
 ca65 -t $CC65TGT general.s
 ca65 -t $CC65TGT keyboard.s
 ca65 -t $CC65TGT level.s
 ca65 -t $CC65TGT object.s
 ca65 -t $CC65TGT overlay_startup.s
 ca65 -t $CC65TGT player.s
+ca65 -t $CC65TGT playfield.s
+ca65 -t $CC65TGT present.s
+ca65 -t $CC65TGT replay.s
+ca65 -t $CC65TGT save_state.s
 ca65 -t $CC65TGT screen.s
 ca65 -t $CC65TGT strings.s
 ca65 -t $CC65TGT sys.s
+ca65 -t $CC65TGT telemetry.s
 ca65 -t $CC65TGT text.s
 
 # Kernel access
@@ -93,44 +166,28 @@ ca65 -t $CC65TGT kernel.s -o kernel.o
 
 # name 'header'
 #ca65 -t $CC65TGT ../name.s -o name.o
-ca65 -t $CC65TGT ../memory.asm -o memory.o
+ca65 -t $CC65TGT -I $PROJECT ../memory.asm -o memory.o
 
 
 echo "\n**************************\nLD65 link start...\n**************************\n"
 
 # link files into an executable
-ld65 -C $CONFIG_DIR/$OVERLAY_CONFIG -o infest.rom kernel.o app.o comm_buffer.o general.o keyboard.o level.o memory.o object.o player.o overlay_startup.o screen.o strings.o sys.o text.o $CC65LIB -m infest_$CC65TGT.map -Ln labels.lbl
+ld65 -C $CONFIG_DIR/$OVERLAY_CONFIG -o infest.rom kernel.o anim.o app.o asset_stream.o comm_buffer.o file_io.o flow_field.o general.o keyboard.o level.o memory.o object.o player.o playfield.o present.o replay.o save_state.o overlay_startup.o screen.o strings.o sys.o telemetry.o text.o $CC65LIB -m infest_$CC65TGT.map -Ln labels.lbl
 
 
 echo "\n**************************\nCC65 tasks complete\n**************************\n"
 
-# get copy of sprite data
-cp $PROJECT/data/robot.bin $BUILD_DIR/
-cp $PROJECT/data/human1.bin $BUILD_DIR/
-cp $PROJECT/data/bullets_s.bin $BUILD_DIR/
-cp $PROJECT/data/bullets_l.bin $BUILD_DIR/
-cp $PROJECT/data/tiles.bin $BUILD_DIR/
-cp $PROJECT/data/tilemap.bin $BUILD_DIR/
-
-#build pgZ for disk
-fname=("infest.rom" "infest.rom.1" "infest.rom.2" "robot.bin" "human1.bin" "bullets_s.bin" "bullets_l.bin" "tilemap.bin" "tiles.bin")
-addr=("990700" "000001" "002001" "004002" "005002" "005802" "005A02" "A85D02" "006002")
-
-for ((i = 1; i <= $#fname; i++)); do
-v1=$(stat -f%z $fname[$i]); v2=$(printf '%04x\n' $v1); v3='00'$v2; v4=$(echo -n $v3 | tac -rs ..); v5=$addr[$i]$v4;v6=$(sed -Ee 's/([A-Za-z0-9]{2})/\\\x\1/g' <<< "$v5"); echo -n $v6 > $fname[$i]'.hdr'
-done
-
-echo -n 'Z' >> pgZ_start.hdr
-echo -n '\x99\x07\x00\x00\x00\x00' >> pgZ_end.hdr
-
-cat pgZ_start.hdr infest.rom.hdr infest.rom infest.rom.1.hdr infest.rom.1 infest.rom.2.hdr infest.rom.2 robot.bin.hdr robot.bin human1.bin.hdr human1.bin bullets_s.bin.hdr bullets_s.bin bullets_l.bin.hdr bullets_l.bin tilemap.bin.hdr tilemap.bin tiles.bin.hdr tiles.bin pgZ_end.hdr > infest.pgZ 
-
-rm *.hdr
+#build pgZ for disk: segments, load addresses, and start address all come from pgz_manifest.txt
+python3 $PROJECT/tools/pgz_pack.py $PROJECT/pgz_manifest.txt -d $BUILD_DIR -d $PROJECT/$DATADIR -o infest.pgZ $ASSET_LZ4 -v || exit 1
 
 cp infest.pgZ infest_install/disk/
 
+# assets the game streams in from disk at run time (asset_stream.h), instead of carrying in the pgZ
+cp $PROJECT/$DATADIR/bullets_l.bin infest_install/disk/
+
 # copy pgz binary to SD Card on F256 via fnxmanager
 python3 $FOENIXMGR/FoenixMgr/fnxmgr.py --copy infest.pgZ
+python3 $FOENIXMGR/FoenixMgr/fnxmgr.py --copy $PROJECT/$DATADIR/bullets_l.bin
 
 
 # clear temp files
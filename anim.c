@@ -0,0 +1,100 @@
+/*
+ * anim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "anim.h"
+#include "app.h"
+#include "pgz_layout.h"
+#include "player.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+// base cell of the tank facing the_direction. the 16 tank shapes go clockwise from 12:00, base then alt for each direction.
+#define ANIM_PLAYER_FRAME(the_direction)	(SPRITE_ROBOT_16F_LOMED_ADDR + ((uint16_t)(the_direction) << PLAYER_L_SHIFT_PER_SHAPE))
+
+#define ANIM_PLAYER_FRAME_ROW(cell_offset)	\
+	{	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_NORTH) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_NORTHEAST) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_EAST) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_SOUTHEAST) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_SOUTH) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_SOUTHWEST) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_WEST) + (cell_offset),	\
+		ANIM_PLAYER_FRAME(PLAYER_DIR_NORTHWEST) + (cell_offset),	\
+	}
+
+#define ANIM_PLAYER_NUM_DIRS		8
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+// LO+MED sprite address of every tank cell, by [cell][direction]
+static const uint16_t	anim_player_frame[ANIM_NUM_CELLS][ANIM_PLAYER_NUM_DIRS] =
+{
+	ANIM_PLAYER_FRAME_ROW(0),
+	ANIM_PLAYER_FRAME_ROW(ANIM_ALT_CELL_OFFSET),
+};
+
+static uint8_t			anim_player_countdown;	// frames left before the tank flips cells
+static uint8_t			anim_player_cell;		// ANIM_CELL_BASE or ANIM_CELL_ALT
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// put the tank back on its base cell with a full countdown. call when a game starts and whenever the tank turns.
+void Anim_ResetPlayer(void)
+{
+	anim_player_countdown = PLAYER_FRAMES_PER_ANIM_CELL;
+	anim_player_cell = ANIM_CELL_BASE;
+}
+
+
+// count the tank's animation down one frame, and return the LO+MED sprite address of the cell to show for the_direction
+uint16_t Anim_TickPlayer(uint8_t the_direction)
+{
+	if (--anim_player_countdown == 0)
+	{
+		anim_player_countdown = PLAYER_FRAMES_PER_ANIM_CELL;
+		anim_player_cell ^= ANIM_CELL_ALT;
+	}
+	
+	return anim_player_frame[anim_player_cell][the_direction];
+}
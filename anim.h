@@ -0,0 +1,86 @@
+/*
+ * anim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef ANIM_H_
+#define ANIM_H_
+
+
+/* about this class: Anim
+ *
+ * Decides when sprites flip between their two animation cells (tank treads, left foot/right foot), and which sprite
+ *   graphics address each cell is at. Every sprite shape has its alternate cell 256 bytes after it.
+ *
+ *** things this class needs to be able to do
+ * count frames down per entity, so the flip rate doesn't depend on how far or which way the entity has moved
+ * give the player's frame address for a direction and cell from a table, with no multiplies or divides per frame
+ *
+ *** how to use it
+ *
+ * humans: each Sprite has an anim_countdown_. ANIM_TICK_SPRITE(the_sprite, HUMAN_FRAMES_PER_ANIM_CELL) once per frame
+ *   it moves. the countdown needs to start at 1 or more: 0 means the first flip is 256 frames away.
+ * player: Anim_ResetPlayer() at the start of a game and whenever the tank turns, then Anim_TickPlayer() once per frame
+ *   for the address to put in the tank's sprite registers.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define ANIM_CELL_BASE				0
+#define ANIM_CELL_ALT				1
+#define ANIM_NUM_CELLS				2
+#define ANIM_ALT_CELL_OFFSET		0x0100	// alt cells are 256 bytes after the base cell (= 1 in addr_med_)
+
+// count the_sprite's anim_countdown_ down; when it runs out, reload it and swap addr_med_ with addr_med_alt_
+// a macro rather than a function so the per-sprite loops in level.c don't pay for a call per sprite per frame
+#define ANIM_TICK_SPRITE(the_sprite, frames_per_cell)	\
+	do	\
+	{	\
+		if (--(the_sprite)->anim_countdown_ == 0)	\
+		{	\
+			(the_sprite)->anim_countdown_ = (frames_per_cell);	\
+			(the_sprite)->addr_med_ ^= (the_sprite)->addr_med_alt_;	\
+			(the_sprite)->addr_med_alt_ ^= (the_sprite)->addr_med_;	\
+			(the_sprite)->addr_med_ ^= (the_sprite)->addr_med_alt_;	\
+		}	\
+	} while (0)
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// put the tank back on its base cell with a full countdown. call when a game starts and whenever the tank turns.
+void Anim_ResetPlayer(void);
+
+// count the tank's animation down one frame, and return the LO+MED sprite address of the cell to show for the_direction
+// the_direction: PLAYER_DIR_NORTH... PLAYER_DIR_NORTHWEST
+uint16_t Anim_TickPlayer(uint8_t the_direction);
+
+
+#endif /* ANIM_H_ */
@@ -17,7 +17,10 @@
 
 // project includes
 #include "app.h"
+#include "anim.h"
+#include "asset_stream.h"
 #include "comm_buffer.h"
+#include "flow_field.h"
 #include "general.h"
 #include "keyboard.h"
 #include "level.h"
@@ -25,8 +28,13 @@
 //#include "overlay_em.h"
 #include "overlay_startup.h"
 #include "player.h"
+#include "playfield.h"
+#include "present.h"
+#include "save_state.h"
+#include "replay.h"
 #include "text.h"
 #include "screen.h"
+#include "strings.h"
 #include "sys.h"
 
 // C includes
@@ -37,11 +45,13 @@
 #include <string.h>
 
 // cc65 includes
-#include <device.h>
-//#include <unistd.h>
-#include <cc65.h>
+#ifndef HOST_BUILD
+	#include <device.h>
+	//#include <unistd.h>
+	#include <cc65.h>
+	#include "api.h"
+#endif
 #include "f256.h"
-#include "api.h"
 #include "kernel.h"
 
 
@@ -50,8 +60,24 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_APP
+
 #define CH_PROGRESS_BAR_FULL	CH_CHECKERBOARD
 
+// boot, as PROFILE_STARTUP times it: one stage per step of App_InitializeApp(), then the first App_InitializeGame()
+#define STARTUP_STAGE_SYSTEM	0		// kernel, machine detect, screen size, gamma, fat pixels, borders
+#define STARTUP_STAGE_ASSETS	1		// LZ4 asset expansion (nothing to do unless packed with --lz4)
+#define STARTUP_STAGE_VICKY		2		// graphics mode, LUTs, font, tile and sprite registers
+#define STARTUP_STAGE_SPRITES	3		// RNG seed, comms buffer, human and missile sprites
+#define STARTUP_STAGE_SCREEN	4		// first draw of the UI
+#define STARTUP_STAGE_GAME		5		// player, level, HUD: after this, the first frame
+
+#ifdef PROFILE_STARTUP
+	#define END_STARTUP_STAGE(the_stage)	App_EndStartupStage(the_stage)
+#else
+	#define END_STARTUP_STAGE(the_stage)
+#endif
+
 
 /*****************************************************************************/
 /*                          File-scoped Variables                            */
@@ -61,11 +87,23 @@ static uint8_t	joy2playerdir[11] = {0xff, 0, 4, 0xff, 6, 7, 5, 0xff, 2, 1, 3};	/
 
 static bool					game_is_over = false;
 
+static uint16_t				tank_sprite_loc;		// med/lo addr of the tank sprite shape currently displayed
+
+#ifdef PROFILE_SPRITE_LOOPS
+	static uint32_t			profile_ticks;			// timer 0 ticks spent in the sprite update/render loops since the last report
+	static uint8_t			profile_frames;
+#endif
+
+#ifdef PROFILE_STARTUP
+	static uint32_t			startup_ticks;			// timer 0 ticks from the start of App_InitializeApp() to the end of the last stage
+	static bool				startup_is_done;
+#endif
+
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
-char*						global_string_buff1 = (char*)STORAGE_STRING_BUFFER_1;
+char*						global_string_buff1 = (char*)HAL_CPU_PTR(STORAGE_STRING_BUFFER_1);
 // global_string_buff2char*					global_string_buff2 = (char*)STORAGE_STRING_BUFFER_2;
 
 extern uint8_t				zp_joy;	// tracks what's going on with j0/j1 (for this game, both do same thing)
@@ -73,6 +111,8 @@ extern uint8_t				zp_joy;	// tracks what's going on with j0/j1 (for this game, b
 extern uint8_t				zp_bank_num;
 extern uint16_t				zp_px;
 extern uint16_t				zp_py;
+extern uint16_t				global_camera_x;
+extern uint16_t				global_camera_y;
 extern uint8_t				zp_player_dir;
 extern uint8_t				zp_player_dir_prev;
 extern uint16_t				zp_ticktock;
@@ -94,24 +134,59 @@ extern int8_t				zp_lives;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
-// initialize various objects - once
-void App_InitializeApp(void);
-
-// initialize game - once per game
-void App_InitializeGame(void);
-
 // handles user input
 uint8_t App_MainMenuLoop(void);
 
+#ifdef PROFILE_STARTUP
+	// stop timing the_stage of boot, log it, and add it to the boot total. starts timing the next stage, if any.
+	static void App_EndStartupStage(uint8_t the_stage);
+#endif
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
 
+#ifdef PROFILE_STARTUP
+// stop timing the_stage of boot, log it, and add it to the boot total. starts timing the next stage, if any.
+static void App_EndStartupStage(uint8_t the_stage)
+{
+	uint32_t	the_ticks;
+	
+	// LOGIC:
+	//   timer 0 wraps at 24 bits (~666ms), so each stage is timed on its own and the total kept here.
+	//   boot starts with App_InitializeApp(): the kernel loading the pgZ comes before that; compare pgZ sizes for it.
+	//   App_InitializeGame() runs again for every new game, but only the first one is part of boot.
+	if (startup_is_done)
+	{
+		return;
+	}
+	
+	the_ticks = Sys_Timer0Stop();
+	startup_ticks += the_ticks;
+	
+	LOG_INFO(("%s %d: startup stage %u: %lu cycles", __func__, __LINE__, the_stage, the_ticks / TIMER0_TICKS_PER_CPU_CYCLE));
+	
+	if (the_stage == STARTUP_STAGE_GAME)
+	{
+		LOG_INFO(("%s %d: boot to first frame: %lu ms", __func__, __LINE__, startup_ticks / TIMER0_TICKS_PER_MS));
+		startup_is_done = true;
+		return;
+	}
+	
+	Sys_Timer0Start();
+}
+#endif
+
+
 // initialize various objects - once
 void App_InitializeApp(void)
 {
+#ifdef PROFILE_STARTUP
+	Sys_Timer0Start();
+#endif
+
 	kernel_init();
 
 	App_LoadOverlay(OVERLAY_STARTUP);
@@ -122,8 +197,15 @@ void App_InitializeApp(void)
 	}
 	
 	Sys_SetBorderSize(0, 0); // want all 80 cols and 60 rows!
+	END_STARTUP_STAGE(STARTUP_STAGE_SYSTEM);
+	
+	// put assets in place if the pgZ carried them compressed. must happen before VICKY is pointed at them.
+	Startup_ExpandAssets();
+	END_STARTUP_STAGE(STARTUP_STAGE_ASSETS);
 	
-	Startup_SetUpSprites();
+	// one pass of block copies: text LUTs, font, sprite LUT, and where VICKY finds the sprites, tiles, and tilemap
+	Startup_UploadToVICKY();
+	END_STARTUP_STAGE(STARTUP_STAGE_VICKY);
 	
 	// initialize the random number generator embedded in the Vicky
 	Startup_InitializeRandomNumGen();
@@ -131,18 +213,15 @@ void App_InitializeApp(void)
 	// initialize the ptps for the comms buff
 	Startup_InitializeCommsBuffer();
 	
-	// copy LUT into VICKY memory
-	
-	// teach VICKY where the sprites are and configure each one
+	// configure each human and missile sprite
 	Startup_InitializeSprites();
-	
-	// set up tilemap
-	Startup_SetUpTileMap();
+	END_STARTUP_STAGE(STARTUP_STAGE_SPRITES);
 	
 	// Do first draw of UI
 	App_LoadOverlay(OVERLAY_SCREEN);
 	Screen_Render();
 	Screen_ShowAppAboutInfo();
+	END_STARTUP_STAGE(STARTUP_STAGE_SCREEN);
 }
 
 
@@ -152,8 +231,17 @@ void App_InitializeGame(void)
 	App_LoadOverlay(OVERLAY_SCREEN);
 	Screen_ShowAppAboutInfo();
 	
+	// nothing queued for the screen yet; start the frame timer Present_EndFrame() waits on
+	Present_Init();
+	
 	// set up player
 	App_LoadOverlay(OVERLAY_STARTUP);
+	
+	// every recorded/replayed game starts from its own seed, before anything below draws a random number
+	#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+		Startup_SyncReplaySeed();
+	#endif
+	
 	Startup_InitializePlayer();
 	
 	// initialize level (draw tiles, place humans, etc.) - can move to startup if run short of memory
@@ -181,273 +269,332 @@ void App_InitializeGame(void)
 	Buffer_RefreshStatDisplay(true);
 	
 	// initial message
-	Buffer_NewMessage("Infestation detected! Stop the humans!");
+	Buffer_NewMessage(General_GetString(ID_STR_MSG_INFESTATION));
 	
 	// reset the game over flag
 	game_is_over = false;
 	
 	// reset joystick condition map so it doesn't hang on from last game (or from junk on startup)
-	*(uint8_t*)ZP_JOY = 0;
+	zp_joy = 0;
+	
+	Anim_ResetPlayer();	// start the tank on its base cell
+	zp_player_dir_prev = zp_player_dir;
+	
+	END_STARTUP_STAGE(STARTUP_STAGE_GAME);
 }
 
 
 // handles user input
 uint8_t App_MainMenuLoop(void)
+{
+	// main loop
+	while (App_RunFrame())
+	{
+	} // while for exit loop
+	
+	// normal returns all handled above. this is a catch-all
+	return 0;
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// run one pass of the main loop: get input, move the player, update and render everything else
+// returns false once the game is over
+bool App_RunFrame(void)
 {
 	uint8_t				user_input;
 	bool				player_wants_to_fire;
-	uint16_t			tank_sprite_loc;
-	uint16_t			base_tank_sprite_loc;
+	uint16_t			prev_px;	// where the player was before this frame's input, for Player_StopAtWalls()
+	uint16_t			prev_py;
 
+	// turn off cursor - seems to turn itself off when kernal detects cursor position has changed. 
+	//Sys_EnableTextModeCursor(false);
 	
-	tank_sprite_loc = base_tank_sprite_loc = SPRITE_ROBOT_16F_LOMED_ADDR;	// starting med/lo addr of tank sprite
-	zp_player_dir_prev = zp_player_dir;
+	//DEBUG: track software stack pointer
+	//sprintf(global_string_buffer, "sp: %x%x", *(char*)0x52, *(char*)0x51);
+	//Buffer_NewMessage(global_string_buffer);
 	
-	// main loop
-	while (! game_is_over)
+	// increment the frame counter we use to check when sprite animations should change from cell0 to cell1 to cell0, etc. 
+	++zp_ticktock;
+	player_wants_to_fire = false;
+	
+					
+	// keep any asset loads, game saves/loads, and log writes moving: at most one disk chunk each per frame
+	Stream_Service();
+	Save_Service();
+	LOG_FLUSH();
+	
+	// a load Save_Service() just finished may have moved the player, so this has to come after it
+	prev_px = zp_px;
+	prev_py = zp_py;
+	
+	// ask Screen to establish which menu items should be available (this just keeps this code out of MAIN to maximize heap space)
+	//App_LoadOverlay(OVERLAY_SCREEN);
+	
+	// ask Screen to get user input and vet it against the menu items that are currently enabled
+	// only inputs for active menu items will cause an input to be returned here
+	user_input = Keyboard_GetKeyIfPressed();
+	
+	// when recording, capture this frame's input; when playing back, replace it (and ZP_JOY) with the recorded input
+	user_input = REPLAY_PROCESS_FRAME(user_input);
+	// Get user input and vet it against the menu items that are currently enabled
+	// returns ACTION_INVALID_INPUT if the key pressed was for a disabled menu item
+	// returns the key pressed if it matched an enabled menu item, or if wasn't a known (to Screen) input. This lets App still allow for cursor keys, etc, which aren't represented by menu items
+
+	//DEBUG_OUT(("%s %d: user_input=%u", __func__ , __LINE__, user_input));
+	
+	// first switch: normalize any alt keyboard input so we can merge with Joy input afterwards
+	switch (user_input)
 	{
-		// turn off cursor - seems to turn itself off when kernal detects cursor position has changed. 
-		//Sys_EnableTextModeCursor(false);
-		
-		//DEBUG: track software stack pointer
-		//sprintf(global_string_buffer, "sp: %x%x", *(char*)0x52, *(char*)0x51);
-		//Buffer_NewMessage(global_string_buffer);
-		
-		// increment the frame counter we use to check when sprite animations should change from cell0 to cell1 to cell0, etc. 
-		++zp_ticktock;
-		player_wants_to_fire = false;
-		
-						
-		// ask Screen to establish which menu items should be available (this just keeps this code out of MAIN to maximize heap space)
-		//App_LoadOverlay(OVERLAY_SCREEN);
-		
-		// ask Screen to get user input and vet it against the menu items that are currently enabled
-		// only inputs for active menu items will cause an input to be returned here
-		user_input = Keyboard_GetKeyIfPressed();
-		// Get user input and vet it against the menu items that are currently enabled
-		// returns ACTION_INVALID_INPUT if the key pressed was for a disabled menu item
-		// returns the key pressed if it matched an enabled menu item, or if wasn't a known (to Screen) input. This lets App still allow for cursor keys, etc, which aren't represented by menu items
-
-		//DEBUG_OUT(("%s %d: user_input=%u", __func__ , __LINE__, user_input));
-		
-		// first switch: normalize any alt keyboard input so we can merge with Joy input afterwards
-		switch (user_input)
-		{
-			case MOVE_UP:
-				zp_py -= 2;
-				zp_player_dir = PLAYER_DIR_NORTH;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_RIGHT:
-				zp_px += 2;
-				zp_player_dir = PLAYER_DIR_EAST;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_DOWN:
-				zp_py += 2;
-				zp_player_dir = PLAYER_DIR_SOUTH;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_LEFT:
-				zp_px -= 2;
-				zp_player_dir = PLAYER_DIR_WEST;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_UP_RIGHT:
-				zp_px += 2;
-				zp_py -= 2;
-				zp_player_dir = PLAYER_DIR_NORTHEAST;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_DOWN_RIGHT:
-				zp_px += 2;
-				zp_py += 2;
-				zp_player_dir = PLAYER_DIR_SOUTHEAST;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_DOWN_LEFT:
-				zp_px -= 2;
-				zp_py += 2;
-				zp_player_dir = PLAYER_DIR_SOUTHWEST;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case MOVE_UP_LEFT:
-				zp_px -= 2;
-				zp_py -= 2;
-				zp_player_dir = PLAYER_DIR_NORTHWEST;
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case ACTION_FIRE:
-				player_wants_to_fire = true;
-				break;
-				
-			case ACTION_WARP:
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case ACTION_BOMB:
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			case ACTION_CYCLE_WEAPON:
-				Player_SetNextWeapon();
-				break;
-								
-			case 0:
-				user_input = ACTION_INVALID_INPUT;
-				break;
-				
-			default:
-				//sprintf(global_string_buff1, "didn't know key %u", user_input);
-				//Buffer_NewMessage(global_string_buff1);
-				//DEBUG_OUT(("%s %d: didn't know key %u", __func__, __LINE__, user_input));
-				//fatal(user_input);
-				//sprintf(global_string_buff1, "%d %x '%c'", user_input, user_input, user_input);
-				//Text_DrawStringAtXY(0, 0, global_string_buff1, COLOR_BRIGHT_WHITE, COLOR_BLUE);
-				//Text_SetCharAtXY(++zp_px, zp_py, user_input);
-				user_input = ACTION_INVALID_INPUT;
-				break;
-		}
-		
-		// handle joystick actions if no keyboard input was received
-		if (user_input == ACTION_INVALID_INPUT)
-		{
-			if (*(uint8_t*)ZP_JOY & JOY_UP_BIT)
+		case MOVE_UP:
+			zp_py -= 2;
+			zp_player_dir = PLAYER_DIR_NORTH;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_RIGHT:
+			zp_px += 2;
+			zp_player_dir = PLAYER_DIR_EAST;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_DOWN:
+			zp_py += 2;
+			zp_player_dir = PLAYER_DIR_SOUTH;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_LEFT:
+			zp_px -= 2;
+			zp_player_dir = PLAYER_DIR_WEST;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_UP_RIGHT:
+			zp_px += 2;
+			zp_py -= 2;
+			zp_player_dir = PLAYER_DIR_NORTHEAST;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_DOWN_RIGHT:
+			zp_px += 2;
+			zp_py += 2;
+			zp_player_dir = PLAYER_DIR_SOUTHEAST;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_DOWN_LEFT:
+			zp_px -= 2;
+			zp_py += 2;
+			zp_player_dir = PLAYER_DIR_SOUTHWEST;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case MOVE_UP_LEFT:
+			zp_px -= 2;
+			zp_py -= 2;
+			zp_player_dir = PLAYER_DIR_NORTHWEST;
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case ACTION_FIRE:
+			player_wants_to_fire = true;
+			break;
+			
+		case ACTION_WARP:
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case ACTION_BOMB:
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case ACTION_CYCLE_WEAPON:
+			Player_SetNextWeapon();
+			break;
+			
+		case ACTION_SAVE_GAME:
+			if (Save_IsDiskBusy() == true)
 			{
-				zp_py -= 2;
+				Buffer_NewMessage(General_GetString(ID_STR_MSG_SAVE_BUSY));
 			}
-
-			if (*(uint8_t*)ZP_JOY & JOY_DOWN_BIT)
+			else
 			{
-				zp_py += 2;
-				zp_player_dir += 2;
+				// Save_Service() says ID_STR_MSG_GAME_SAVED once it's on disk
+				Save_Snapshot();
+				
+				if (Save_WriteToDisk() == false)
+				{
+					Buffer_NewMessage(General_GetString(ID_STR_MSG_SAVED_NOT_TO_DISK));
+				}
 			}
-
-			if (*(uint8_t*)ZP_JOY & JOY_LEFT_BIT)
+			
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		case ACTION_LOAD_GAME:
+			if (Save_IsDiskBusy() == true)
 			{
-				zp_px -= 2;
+				Buffer_NewMessage(General_GetString(ID_STR_MSG_SAVE_BUSY));
 			}
-
-			if (*(uint8_t*)ZP_JOY & JOY_RIGHT_BIT)
+			else if (Save_Restore() == true)
 			{
-				zp_px += 2;
-				zp_player_dir += 1;
+				// the player didn't walk here: don't let Player_StopAtWalls() pull them back to where they were
+				prev_px = zp_px;
+				prev_py = zp_py;
+				Buffer_NewMessage(General_GetString(ID_STR_MSG_GAME_RESTORED));
 			}
-
-			if (*(uint8_t*)ZP_JOY & JOY_FIRE1_BIT)
+			else if (Save_ReadFromDisk() == true)
 			{
-				player_wants_to_fire = true;
+				// Save_Service() restores it once it's all in
+				Buffer_NewMessage(General_GetString(ID_STR_MSG_LOADING_SAVE));
 			}
-
-			if (*(uint8_t*)ZP_JOY & JOY_FIRE2_BIT)
+			else
 			{
-				Player_SetNextWeapon();
+				Buffer_NewMessage(General_GetString(ID_STR_MSG_NO_SAVED_GAME));
 			}
-
-			// got joy buttons, clear them and set current player dir based on joy directions pushed
-			zp_joy &= 0b00001111;
 			
-			if (zp_joy)	// any joy not fire button
-			{
-				// dir changed
-				zp_player_dir = joy2playerdir[*(uint8_t*)ZP_JOY];
-			}
+			user_input = ACTION_INVALID_INPUT;
+			break;
+							
+		case 0:
+			user_input = ACTION_INVALID_INPUT;
+			break;
+			
+		default:
+			//sprintf(global_string_buff1, "didn't know key %u", user_input);
+			//Buffer_NewMessage(global_string_buff1);
+			//DEBUG_OUT(("%s %d: didn't know key %u", __func__, __LINE__, user_input));
+			//fatal(user_input);
+			//sprintf(global_string_buff1, "%d %x '%c'", user_input, user_input, user_input);
+			//Text_DrawStringAtXY(0, 0, global_string_buff1, COLOR_BRIGHT_WHITE, COLOR_BLUE);
+			//Text_SetCharAtXY(++zp_px, zp_py, user_input);
+			user_input = ACTION_INVALID_INPUT;
+			break;
+	}
+	
+	// handle joystick actions if no keyboard input was received
+	if (user_input == ACTION_INVALID_INPUT)
+	{
+		if (zp_joy & JOY_UP_BIT)
+		{
+			zp_py -= 2;
 		}
-				
-		Player_ValidateLocation();
 
-		// point to the appropriate tank shape
-		// LOGIC:
-		//   each sprite shape is 16x16=256 bytes. there are 16 total shapes, so exactly 4k of data.
-		//   sprites are arranged in clockwise order, from 12:00. each position has 2 shapes, frame1/frame2, for per-frame anim.
-		//   to get the right shape:
-		//     1. add 0 or FF for the frame offset
-		//     2. multiply zp_player_dir by 512 (PLAYER_DIR_NORTH = 0... PLAYER_DIR_NORTHWEST=7)
-		//        to make things fast, we have a preset offset calculation table.
-
-
-		if (zp_player_dir != zp_player_dir_prev)
+		if (zp_joy & JOY_DOWN_BIT)
 		{
-			tank_sprite_loc = SPRITE_ROBOT_16F_LOMED_ADDR;
-			tank_sprite_loc += (uint16_t)zp_player_dir * (uint16_t)512;
-			base_tank_sprite_loc = tank_sprite_loc;
-			zp_player_dir_prev = zp_player_dir;
-
-			// animate by swapping to the other frame of sprite
-			//tank_sprite_loc -= 0xff * (frame_odd_even % 2);
-// 				if ( (frame_odd_even % 2) == 0)
-// 				{
-// 					tank_sprite_loc -= 0xff;
-// 				}
+			zp_py += 2;
+			zp_player_dir += 2;
 		}
-		else
-		{
-			// animate by swapping to the other frame of sprite
 
-			//tank_sprite_loc += 0xff * (frame_odd_even % 2);
-			if ( (zp_ticktock % PLAYER_SPRITE_TICKTOCK_DIVISOR) == 0)
-			{
-				tank_sprite_loc += (uint16_t)0x0100;
-			}
-			else
-			{
-				tank_sprite_loc = base_tank_sprite_loc;
-			}
+		if (zp_joy & JOY_LEFT_BIT)
+		{
+			zp_px -= 2;
 		}
 
-		//General_DelayTicks(800);
-		
-		Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-		R8(SPRITE0_ADDR_LO) = tank_sprite_loc & 0xFF;
-		R8(SPRITE0_ADDR_MED) = (tank_sprite_loc) >> 8;
+		if (zp_joy & JOY_RIGHT_BIT)
+		{
+			zp_px += 2;
+			zp_player_dir += 1;
+		}
 
-		//R8(SPRITE0_ADDR_HI) = 0x03;	// we are placing robot sprites starting at 03 6000 in EM
-		Sys_DisableIOBank();
-		
-		// update sprite pos
-		Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-		R16(SPRITE0_X_LO) = zp_px;		
-		R16(SPRITE0_Y_LO) = zp_py;		
-		Sys_DisableIOBank();
-		
-		if (player_wants_to_fire == true)
+		if (zp_joy & JOY_FIRE1_BIT)
 		{
-			Level_PlayerAttemptShoot();
+			player_wants_to_fire = true;
 		}
-		
-		// update and move humans around, check for deaths, etc. 
-		Level_UpdateSprites();
-		Level_RenderSprites();
 
-		// check if player died, etc. 
-		if (zp_hp < 1)
+		if (zp_joy & JOY_FIRE2_BIT)
 		{
-			Player_LoseLife();
+			Player_SetNextWeapon();
 		}
+
+		// got joy buttons, clear them and set current player dir based on joy directions pushed
+		zp_joy &= 0b00001111;
 		
-		Buffer_RefreshStatDisplay(true);
-		
-		//DEBUG_OUT(("%s %d: X/Y=%u,%u; player_wants_to_fire=%u", __func__, __LINE__, zp_px, zp_py, player_wants_to_fire));
+		if (zp_joy)	// any joy not fire button
+		{
+			// dir changed
+			zp_player_dir = joy2playerdir[zp_joy];
+		}
+	}
+			
+	Player_ValidateLocation();
+	Player_StopAtWalls(prev_px, prev_py);
+
+	// scroll the world to keep up with the player. brings in at most one new tile row/column per direction.
+	Playfield_FollowPlayer();
+
+	// carry on the humans' search for the player. a fixed number of tiles a frame, however many humans there are.
+	FlowField_Update();
+
+	// point to the appropriate tank shape
+	// LOGIC:
+	//   each sprite shape is 16x16=256 bytes. there are 16 total shapes, so exactly 4k of data.
+	//   sprites are arranged in clockwise order, from 12:00. each position has 2 shapes, frame1/frame2, for per-frame anim.
+	//   Anim keeps a table of the address of every shape, and a countdown for when to flip frames.
+	//   turning starts the new direction on frame1, with a full countdown.
+	if (zp_player_dir != zp_player_dir_prev)
+	{
+		zp_player_dir_prev = zp_player_dir;
+		Anim_ResetPlayer();
+	}
+	
+	tank_sprite_loc = Anim_TickPlayer(zp_player_dir);
 
-	} // while for exit loop
+	//General_DelayTicks(800);
 	
-	// normal returns all handled above. this is a catch-all
-	return 0;
-}
+	// shape and position (world to screen) go to VICKY at the next Present flush
+	Present_SetPlayerSprite(tank_sprite_loc, zp_px - global_camera_x, zp_py - global_camera_y);
+	
+	if (player_wants_to_fire == true)
+	{
+		Level_PlayerAttemptShoot();
+	}
+	
+	// update and move humans around, check for deaths, etc. 
+#ifdef PROFILE_SPRITE_LOOPS
+	Sys_Timer0Start();
+#endif
+	Level_UpdateSprites();
+#ifdef PROFILE_SPRITE_LOOPS
+	// LOGIC:
+	//   timer 0 runs at the dot clock, 4 ticks per CPU cycle. the start/stop calls cost ~150 cycles, which cancel out
+	//   when comparing two builds. log the average over a few dozen frames so one wave's worth of spawns doesn't skew it.
+	profile_ticks += Sys_Timer0Stop();
+	
+	if (++profile_frames == PROFILE_FRAMES_PER_REPORT)
+	{
+		LOG_INFO(("%s %d: sprite update: %lu cycles/frame", __func__, __LINE__, profile_ticks / (PROFILE_FRAMES_PER_REPORT * TIMER0_TICKS_PER_CPU_CYCLE)));
+		profile_ticks = 0;
+		profile_frames = 0;
+	}
+#endif
 
+	// check if player died, etc. 
+	if (zp_hp < 1)
+	{
+		Player_LoseLife();
+	}
+	
+	// only the stats that changed get drawn, at the flush
+	Buffer_RefreshStatDisplay(false);
+	
+	//DEBUG_OUT(("%s %d: X/Y=%u,%u; player_wants_to_fire=%u", __func__, __LINE__, zp_px, zp_py, player_wants_to_fire));
 
+	// humans and missiles that changed go into this frame as register images
+	Level_RenderSprites();
+	
+	// everything above only simulated and queued: wait for the start of the next frame and put it all on screen
+	Present_EndFrame();
 
-/*****************************************************************************/
-/*                        Public Function Definitions                        */
-/*****************************************************************************/
+	return (! game_is_over);
+}
 
 
 
@@ -467,11 +614,16 @@ void App_LoadOverlay(uint8_t the_overlay_em_bank_number)
 void App_GameOver(void)
 {
 	//Buffer_NewMessage("Your last chassis has been destroyed. You being re-assigned to: street sweeper");
-	Buffer_NewMessage("You blew it. Hoomans get this planet.");
+	Buffer_NewMessage(General_GetString(ID_STR_MSG_GAME_LOST));
 				
 	// set the game over flag so that main menu knows to stop doing what it's doing
 	game_is_over = true;
 	
+	// end of this game in the recorded/replayed session. the stream stays open for the next game
+	#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+		Replay_EndGame();
+	#endif
+	
 	App_LoadOverlay(OVERLAY_SCREEN);
 	Screen_ShowGameOver();
 }
@@ -481,11 +633,19 @@ void App_GameOver(void)
 // if no error, just exit
 void App_Exit(uint8_t the_error_number)
 {	
+	#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+		Replay_Finish();
+	#endif
+	
 	R8(0xD6A2) = 0xDE;
 	R8(0xD6A3) = 0xAD;
 	R8(0xD6A0) = 0xF0;
 	R8(0xD6A0) = 0x00;
-	asm("JMP ($FFFC)");
+	#ifdef HOST_BUILD
+		exit(the_error_number);
+	#else
+		asm("JMP ($FFFC)");
+	#endif
 }
 
 
@@ -506,7 +666,7 @@ uint16_t App_GetRandom(uint16_t the_range)
 	// need to have vicky registers available
 	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
 
-	the_random = R16(RANDOM_NUM_GEN_LOW);
+	the_random = HAL_RANDOM16();
 	the_num = the_random % the_range + 1;
 
 	Sys_RestoreIOPage();
@@ -515,6 +675,9 @@ uint16_t App_GetRandom(uint16_t the_range)
 }
 
 
+// host builds supply their own main() that drives App_RunFrame() directly (see host/infest_host.c)
+#ifndef HOST_BUILD
+
 int main(void)
 {
 	App_InitializeApp();
@@ -530,4 +693,6 @@ int main(void)
 	App_Exit(ERROR_NO_ERROR);
 	
 	return 0;
-}
\ No newline at end of file
+}
+
+#endif
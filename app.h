@@ -17,6 +17,7 @@
 
 
 // project includes
+#include "pgz_layout.h"
 
 // C includes
 #include <stdint.h>
@@ -56,70 +57,49 @@
 /*****************************************************************************/
 
 // temp storage for data outside of normal cc65 visibility - extra memory!
+// LOGIC:
+//   the cc65 config starts MAIN at CODE_START, so $0400 up to there is never linked into. it's handed out here as
+//   fixed pools, each starting where the one before it ends, with STORAGE_STRING_BUFFER_1 at the top. the #if below
+//   stops the build if the pools grow into it, and the file that owns a pool checks what it puts there fits
+//   (STORAGE_CHECK_FITS). addresses are CPU addresses: use them through HAL_CPU_PTR().
 #define CODE_START							0x799
 #define STORAGE_GETSTRING_BUFFER			0x0400	// interbank buffer to temporarily store string data into; used by debug and possibly other code. DO NOT REMOVE.
 #define STORAGE_GETSTRING_BUFFER_LEN		256	// 1-page buffer. see cc65 memory config file. this is outside cc65 space.
-#define STORAGE_PLAYER						(STORAGE_GETSTRING_BUFFER + STORAGE_GETSTRING_BUFFER_LEN)
+#define STORAGE_PLAYER						(STORAGE_GETSTRING_BUFFER + STORAGE_GETSTRING_BUFFER_LEN)	// global_player
 #define STORAGE_PLAYER_LEN            		26
-#define STORAGE_MISSILES					(STORAGE_PLAYER + STORAGE_PLAYER_LEN)
-#define STORAGE_MISSILES_LEN            	(6*10)
-#define STORAGE_MONSTERS					(STORAGE_MISSILES + STORAGE_MISSILES_LEN)
-#define STORAGE_MONSTERS_LEN            	(10*20)
-#define STORAGE_CHIPS						(STORAGE_MONSTERS + STORAGE_MONSTERS_LEN)
-#define STORAGE_CHIPS_LEN            		(5*6)
+#define STORAGE_PLAYFIELD_SOLID				(STORAGE_PLAYER + STORAGE_PLAYER_LEN)	// playfield.c's solid tile bits.
+#define STORAGE_PLAYFIELD_SOLID_LEN			45	// PLAYFIELD_SOLID_LEN
+#define STORAGE_STRING_CACHE				(STORAGE_PLAYFIELD_SOLID + STORAGE_PLAYFIELD_SOLID_LEN)	// General_GetString()'s recently used strings
+#define STORAGE_STRING_CACHE_LEN			128
+#define STORAGE_SAVE_DISK_BUFFER			(STORAGE_STRING_CACHE + STORAGE_STRING_CACHE_LEN)	// save_state.c: saves go to/from disk through here
+#define STORAGE_SAVE_DISK_BUFFER_LEN		254	// FILEIO_CHUNK_LEN
+#define STORAGE_POOLS_END					(STORAGE_SAVE_DISK_BUFFER + STORAGE_SAVE_DISK_BUFFER_LEN)
 
 #define STORAGE_STRING_BUFFER_1				(CODE_START - STORAGE_STRING_BUFFER_1_LEN)	// temp string merge/etc buff
 #define STORAGE_STRING_BUFFER_1_LEN			204	// 204b buffer. see cc65 memory config file. this is outside cc65 space.
 #define MAX_ALLOWED_STRING_SIZE				(STORAGE_STRING_BUFFER_1_LEN - 1)	// arbitrary
 
-#define SPRITE_ROBOT_16F_PHYS_ADDR			0x24000	// player graphic. 16x16, 8 primary shapes, 8 alt shapes for ticktocking
-#define SPRITE_ROBOT_16F_LOMED_ADDR			0x4000	// for use when setting sprite registers, assuming we set the 02 part already.
-#define SPRITE_ROBOT_16F_LO_ADDR			0x00	// for use when setting sprite registers byte by byte
-#define SPRITE_ROBOT_16F_MED_ADDR			0x40	// for use when setting sprite registers byte by byte
-#define SPRITE_ROBOT_16F_HI_ADDR			0x02	// for use when setting sprite registers byte by byte
-
-#define SPRITE_HUMAN_1_8F_PHYS_ADDR			0x25000	// Human graphic style 1. 16x16, 4 primary shapes, 4 alt shapes for ticktocking
-#define SPRITE_HUMAN_1_8F_LOMED_ADDR		0x5000	// for use when setting sprite registers, assuming we set the 02 part already.
-#define SPRITE_HUMAN_1_8F_LO_ADDR			0x00	// for use when setting sprite registers byte by byte
-#define SPRITE_HUMAN_1_8F_MED_ADDR			0x50	// for use when setting sprite registers byte by byte
-#define SPRITE_HUMAN_1_8F_HI_ADDR			0x02	// for use when setting sprite registers byte by byte
-
-#define SPRITE_BULLET_S_PHYS_ADDR			0x25800	// the smaller bullet graphic. 8x8, 8 shapes, no alt shapes
-#define SPRITE_BULLET_S_LOMED_ADDR			0x5800	// for use when setting sprite registers, assuming we set the 02 part already.
-#define SPRITE_BULLET_S_LO_ADDR				0x00	// for use when setting sprite registers byte by byte
-#define SPRITE_BULLET_S_MED_ADDR			0x58	// for use when setting sprite registers byte by byte
-#define SPRITE_BULLET_S_HI_ADDR				0x02	// for use when setting sprite registers byte by byte
-
-#define SPRITE_BULLET_L_PHYS_ADDR			0x25A00	// the larger bullet graphic. 8x8, 8 shapes, no alt shapes
-#define SPRITE_BULLET_L_LOMED_ADDR			0x5A00	// for use when setting sprite registers, assuming we set the 02 part already.
-#define SPRITE_BULLET_L_LO_ADDR				0x00	// for use when setting sprite registers byte by byte
-#define SPRITE_BULLET_L_MED_ADDR			0x5A	// for use when setting sprite registers byte by byte
-#define SPRITE_BULLET_L_HI_ADDR				0x02	// for use when setting sprite registers byte by byte
-
-#define TILEMAP_PHYS_ADDR					0x25DA8
-#define TILEMAP_LEN							0x600	// 20 tiles across, 15 tiles call @16x16 each = 320x240, store each index as 2 bytes = 600 bytes
-#define TILEMAP_LO_ADDR						0xA8	// for use when setting tilemap registers byte by byte
-#define TILEMAP_MED_ADDR					0x5D	// for use when setting tilemap registers byte by byte
-#define TILEMAP_HI_ADDR						0x02	// for use when setting tilemap registers byte by byte
-#define TILEMAP_SLOT						0x05	// CPU slot to map it into temporarily when need to adjust
-#define TILEMAP_VALUE						0x12	// EM slot it lives in
-#define TILEMAP_ADDR_IN_CPU_SPACE			(TILEMAP_PHYS_ADDR - 0x24000 + 0xA000)	// when mapped into CPU space, the local ADDR
+#if STORAGE_POOLS_END > STORAGE_STRING_BUFFER_1
+	#error "app.h: the STORAGE_ pools run into STORAGE_STRING_BUFFER_1. shrink one, or leave something in BSS"
+#endif
 
-#define TILESET_PHYS_ADDR					0x26000
-#define TILESET_LEN							4864
-#define TILESET_LO_ADDR						0x00	// for use when setting tileset registers byte by byte
-#define TILESET_MED_ADDR					0x60	// for use when setting tileset registers byte by byte
-#define TILESET_HI_ADDR						0x02	// for use when setting tileset registers byte by byte
+// stop the build if the_len bytes don't fit in the_pool. use at file scope, once per pool, in the file that owns it.
+#define STORAGE_CHECK_FITS(the_pool, the_len)	typedef char the_pool##_fits_check[((the_len) <= the_pool##_LEN) ? 1 : -1]
+
+// asset load addresses (SPRITE_*_ADDR, TILEMAP_*_ADDR, TILESET_*_ADDR, and their _LEN) are generated from pgz_manifest.txt into pgz_layout.h
+#define TILEMAP_SLOT						0x05	// CPU slot to map it into temporarily when need to adjust
+#define TILEMAP_VALUE						((uint8_t)(TILEMAP_PHYS_ADDR / 0x2000))	// EM bank it lives in (pgz_pack.py won't let it cross into the next one)
+#define TILEMAP_ADDR_IN_CPU_SPACE			((TILEMAP_PHYS_ADDR & 0x1FFF) + 0xA000)	// when mapped into CPU space, the local ADDR
 
 #define PLAYER_SPRITE_WIDTH					16		// used for collision detection, etc. 
 #define PLAYER_SPRITE_HEIGHT				16		// used for collision detection, etc. 
-#define PLAYER_SPRITE_TICKTOCK_DIVISOR		20000		// used for control timing of flipping between animation cells for a given sprite (tank treads, etc.)
+#define PLAYER_FRAMES_PER_ANIM_CELL			8		// frames each animation cell of the tank is shown for before flipping to the other (tank treads)
 #define PLAYER_BYTES_PER_SHAPE				(16*16*2)	// 512 bytes between each primary shape. (1 alt shape per primary)
 #define PLAYER_L_SHIFT_PER_SHAPE			9		// 9 left shifts multiplies by 512
 
 #define HUMAN_SPRITE_WIDTH					16		// used for collision detection, etc. 
 #define HUMAN_SPRITE_HEIGHT					16		// used for collision detection, etc. 
-#define HUMAN_SPRITE_TICKTOCK_DIVISOR		300		// used for control timing of flipping between animation cells for a given sprite (left foot, right foot, etc.)
+#define HUMAN_FRAMES_PER_ANIM_CELL			4		// frames each animation cell of a human is shown for before flipping to the other (left foot, right foot)
 #define HUMAN_BYTES_PER_SHAPE				(16*16*2)	// 512 bytes between each primary shape. (1 alt shape per primary)
 #define HUMAN_L_SHIFT_PER_SHAPE				9		// 9 left shifts multiplies by 512
 
@@ -130,6 +110,8 @@
 
 #define POINTS_PER_HUMAN					100		// points scored for each human invader eliminated
 
+#define PROFILE_FRAMES_PER_REPORT			64		// PROFILE_SPRITE_LOOPS, PROFILE_PRESENT: frames averaged per log line
+
 
 /*****************************************************************************/
 /*                           App-wide color choices                          */
@@ -175,6 +157,9 @@
 #define ACTION_BOMB					'b'
 
 #define ACTION_CYCLE_WEAPON			']'
+
+#define ACTION_SAVE_GAME			CH_F5	// snapshot the game into EM, then write it to disk
+#define ACTION_LOAD_GAME			CH_F9	// go back to the EM snapshot, or the one on disk if this session hasn't made one
 				
 
 /*****************************************************************************/
@@ -256,6 +241,16 @@
 /*                       Public Function Prototypes                          */
 /*****************************************************************************/
 
+// initialize various objects - once
+void App_InitializeApp(void);
+
+// initialize game - once per game
+void App_InitializeGame(void);
+
+// run one pass of the main loop: get input, move the player, update and render everything else
+// returns false once the game is over
+bool App_RunFrame(void);
+
 // get random number between 1 and the_range + 1
 // must have seeded the number generator first with call to _randomize() --> cc65 function
 // if passed 0, returns 0.
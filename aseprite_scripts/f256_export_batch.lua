@@ -0,0 +1,135 @@
+-- Headless batch export: every .aseprite file in a folder -> F256 binary + C headers, in one pass
+--
+-- usage (from the project folder):
+--   aseprite -b --script-param src=aseprite_projects --script-param dst=data --script aseprite_scripts/f256_export_batch.lua
+--
+-- for each <name>.aseprite in src, writes to dst:
+--   <out>.bin           all frames, 1 byte per pixel, one frame after another (same as f256_export_bin_merged_frames.lua)
+--   <out>.h             the same pixels, one uint8_t <out>_frame_N[] per frame (same as f256_export_c_sep_frames.lua)
+--   <out>_palette.h     uint8_t <out>_palette[], 4 bytes per color in VICKY CLUT order (B, G, R, 0)
+-- <out> is the name the game loads the file as (see outputNames), or <name> if it isn't listed
+
+local outputNames = {
+	small_tank = "robot",
+	human1 = "human1",
+	small_bullet = "bullets_s",
+	large_bullet = "bullets_l",
+	tiles = "tiles",
+}
+
+local srcDir = app.params["src"] or "aseprite_projects"
+local dstDir = app.params["dst"] or "data"
+
+local function getPaletteData(palette)
+	local ncolors = #palette
+	local res = {}
+
+	for i=0, ncolors-1 do
+		local color = palette:getColor(i)
+		res[i+1] = string.format("\t0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
+	end
+
+	return table.concat(res)
+end
+
+-- one string.char() per row, rows joined by the caller. never build these up with .. per pixel: that is O(n^2).
+local function getBinaryRows(img, w, h, rows)
+	local row = {}
+	for y = 0,h-1 do
+		for x = 0, w-1 do
+			row[x+1] = img:getPixel(x, y)
+		end
+		rows[#rows+1] = string.char(table.unpack(row, 1, w))
+	end
+end
+
+local function getCData(img, w, h)
+	local res = {}
+	local n = 0
+	for y = 0,h-1 do
+		for x = 0, w-1 do
+			n = n + 1
+			res[n] = string.format("0x%02x,", img:getPixel(x, y))
+		end
+		n = n + 1
+		res[n] = "\n"
+	end
+
+	return table.concat(res)
+end
+
+local function writeFile(path, data, mode)
+	local f = io.open(path, mode)
+	if f == nil then
+		print("could not write " .. path)
+		return false
+	end
+	f:write(data)
+	f:close()
+	return true
+end
+
+local function exportSprite(srcPath)
+	local sprite = app.open(srcPath)
+	if sprite == nil then
+		print("could not open " .. srcPath)
+		return false
+	end
+	if sprite.colorMode ~= ColorMode.INDEXED then
+		print(srcPath .. ": sprite needs to be indexed, skipped")
+		sprite:close()
+		return false
+	end
+
+	local title = app.fs.fileTitle(srcPath)
+	local outName = outputNames[title] or title
+	local cName = string.gsub(outName, "[^%w_]", "_")
+	local binRows = {}
+	local cFrames = {}
+
+	for i = 1,#sprite.frames do
+		local img = Image(sprite.spec)
+		img:drawSprite(sprite, i)
+		getBinaryRows(img, sprite.width, sprite.height, binRows)
+		cFrames[i] = string.format("uint8_t %s_frame_%d[] = \n{\n%s};\n\n", cName, i, getCData(img, sprite.width, sprite.height))
+	end
+
+	local bin = table.concat(binRows)
+	local palette = string.format("uint8_t %s_palette[] = \n{\n%s};\n\n", cName, getPaletteData(sprite.palettes[1]))
+	local ok = writeFile(app.fs.joinPath(dstDir, outName .. ".bin"), bin, "wb")
+		and writeFile(app.fs.joinPath(dstDir, outName .. ".h"), table.concat(cFrames), "w")
+		and writeFile(app.fs.joinPath(dstDir, outName .. "_palette.h"), palette, "w")
+
+	if ok then
+		print(string.format("%s -> %s.bin (%d frames, %d bytes)", title, outName, #sprite.frames, #bin))
+	end
+
+	sprite:close()
+	return ok
+end
+
+
+-- sort so the log (and any failure) comes out in the same order every run
+local files = {}
+for _, name in ipairs(app.fs.listFiles(srcDir)) do
+	if app.fs.fileExtension(name) == "aseprite" then
+		files[#files+1] = name
+	end
+end
+table.sort(files)
+
+if #files == 0 then
+	print("no .aseprite files in " .. srcDir)
+	return
+end
+
+app.fs.makeAllDirectories(dstDir)
+
+local numFailed = 0
+for _, name in ipairs(files) do
+	if not exportSprite(app.fs.joinPath(srcDir, name)) then
+		numFailed = numFailed + 1
+	end
+end
+
+print(string.format("%d of %d exported to %s", #files - numFailed, #files, dstDir))
@@ -12,28 +12,30 @@ end
 
 local function getPaletteData(palette)
 	local ncolors = #palette
-	local res = string.format("%i\n", ncolors)
+	local res = {}
+
+	res[1] = string.format("%i\n", ncolors)
 
 	for i=0, ncolors-1 do
 		local color = palette:getColor(i)
-		res = res .. string.format("\t0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
+		res[i+2] = string.format("\t0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
 	end
 
-	return res
+	return table.concat(res)
 end
 
+-- LOGIC: each row goes out as one string.char() call, and the rows are joined once. building a string with .. per pixel is O(n^2).
 local function getIndexData(img, x, y, w, h)
-	local res = ""
+	local rows = {}
+	local row = {}
 	for y = 0,h-1 do
 		for x = 0, w-1 do
-			px = img:getPixel(x, y)
-			res = res .. string.format("%c", px)
-			--res = res .. px
+			row[x+1] = img:getPixel(x, y)
 		end
-		--res = res .. "\n"
+		rows[y+1] = string.char(table.unpack(row, 1, w))
 	end
 
-	return res
+	return table.concat(rows)
 end
 
 local function exportFrame(frm)
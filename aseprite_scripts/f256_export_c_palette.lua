@@ -12,14 +12,14 @@ end
 
 local function getPaletteData(palette)
 	local ncolors = #palette
-	local res = ""
+	local res = {}
 
 	for i=0, ncolors-1 do
 		local color = palette:getColor(i)
-		res = res .. string.format("\t0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
+		res[i+1] = string.format("\t0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
 	end
 
-	return res
+	return table.concat(res)
 end
 
 local function getIndexData(img, x, y, w, h)
@@ -12,27 +12,31 @@ end
 
 local function getPaletteData(palette)
 	local ncolors = #palette
-	local res = string.format("%i\n", ncolors)
+	local res = {}
+
+	res[1] = string.format("%i\n", ncolors)
 
 	for i=0, ncolors-1 do
 		local color = palette:getColor(i)
-		res = res .. string.format("0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
+		res[i+2] = string.format("0x%02x,0x%02x,0x%02x,0x00, \n", color.blue, color.green, color.red)		-- don't need , color.alpha
 	end
 
-	return res
+	return table.concat(res)
 end
 
 local function getIndexData(img, x, y, w, h)
-	local res = ""
+	local res = {}
+	local n = 0
 	for y = 0,h-1 do
 		for x = 0, w-1 do
-			px = img:getPixel(x, y)
-			res = res .. string.format("0x%02x,", px)
+			n = n + 1
+			res[n] = string.format("0x%02x,", img:getPixel(x, y))
 		end
-		res = res .. "\n"
+		n = n + 1
+		res[n] = "\n"
 	end
 
-	return res
+	return table.concat(res)
 end
 
 local function exportFrame(frm)
@@ -0,0 +1,482 @@
+/*
+ * asset_stream.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "asset_stream.h"
+#include "app.h"
+#include "file_io.h"
+#include "general.h"
+#include "memory.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef HOST_BUILD
+	#include <stdio.h>
+#endif
+
+// F256 includes
+#include "f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define LOG_FILE_ID		LOG_FILE_ASSET_STREAM
+
+#define STREAM_BANK_SIZE			0x2000
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static StreamSet		stream_set[STREAM_MAX_SETS];
+static uint16_t			stream_bank_in_use;				// bit n set = bank EM_STREAM_FIRST_PHYS_BANK_NUM + n is reserved by a set
+static uint16_t			stream_clock;					// source of last_used_ stamps
+static uint8_t			stream_current = STREAM_INVALID_HANDLE;	// index entry being loaded. none: next Stream_Service() starts the next queued set
+static uint8_t			stream_file = FILEIO_INVALID_HANDLE;	// FileIO handle of the file being loaded
+static bool				stream_read_pending;			// a FileIO_Read() has gone out and its chunk isn't stored yet
+static bool				stream_release_when_done;		// Stream_Release() was called on the set being loaded
+static uint8_t			stream_queue_stamp;				// queue order: a set's last_used_ is its queue position until it is resident
+
+// LOGIC:
+//   chunks get their own buffer. the interbank buffer is also where General_GetString() and logging write,
+//   so a message between a read and its copy to EM would corrupt the chunk.
+static uint8_t			stream_chunk[STREAM_CHUNK_LEN];
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern uint8_t				zp_bank_num;
+#pragma zpsym ("zp_bank_num");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// bit mask covering the_num_banks banks starting at pool bank the_first
+static uint16_t Stream_BankMask(uint8_t the_first, uint8_t the_num_banks);
+
+// find a run of free pool banks. returns the pool index of the first one, or STREAM_INVALID_HANDLE
+static uint8_t Stream_FindFreeBanks(uint8_t the_num_banks);
+
+// evict the least recently used resident set. returns false if there was nothing to evict
+static bool Stream_EvictOne(void);
+
+// give back a set's banks and free its index entry
+static void Stream_FreeSet(uint8_t the_handle);
+
+// pick the oldest queued set and open its file
+static void Stream_StartNext(void);
+
+// copy a chunk that has arrived at stream_chunk into the current set's banks. false if the set failed instead
+static bool Stream_StoreChunk(uint8_t the_len);
+
+// the current file is finished, one way or the other: record the outcome and close it
+static void Stream_FinishFile(bool succeeded);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// bit mask covering the_num_banks banks starting at pool bank the_first
+static uint16_t Stream_BankMask(uint8_t the_first, uint8_t the_num_banks)
+{
+	return (uint16_t)(((1U << the_num_banks) - 1) << the_first);
+}
+
+
+// find a run of free pool banks. returns the pool index of the first one, or STREAM_INVALID_HANDLE
+static uint8_t Stream_FindFreeBanks(uint8_t the_num_banks)
+{
+	uint8_t		i;
+	uint16_t	the_mask;
+
+	the_mask = Stream_BankMask(0, the_num_banks);
+
+	for (i = 0; i + the_num_banks <= EM_STREAM_NUM_BANKS; i++)
+	{
+		if ((stream_bank_in_use & the_mask) == 0)
+		{
+			return i;
+		}
+
+		the_mask <<= 1;
+	}
+
+	return STREAM_INVALID_HANDLE;
+}
+
+
+// evict the least recently used resident set. returns false if there was nothing to evict
+static bool Stream_EvictOne(void)
+{
+	uint8_t		i;
+	uint8_t		the_oldest = STREAM_INVALID_HANDLE;
+	uint16_t	the_oldest_age = 0;
+	uint16_t	this_age;
+
+	// LOGIC:
+	//   only resident sets can go: queued/loading ones were asked for more recently than anything resident was loaded.
+	//   ages are compared as distance from the clock, so the stamps can wrap without upsetting the order.
+	for (i = 0; i < STREAM_MAX_SETS; i++)
+	{
+		if (stream_set[i].state_ == STREAM_SET_RESIDENT)
+		{
+			this_age = stream_clock - stream_set[i].last_used_;
+
+			if (the_oldest == STREAM_INVALID_HANDLE || this_age > the_oldest_age)
+			{
+				the_oldest = i;
+				the_oldest_age = this_age;
+			}
+		}
+	}
+
+	if (the_oldest == STREAM_INVALID_HANDLE)
+	{
+		return false;
+	}
+
+	LOG_INFO(("%s %d: evicting '%s' (bank %x)", __func__, __LINE__, stream_set[the_oldest].name_, stream_set[the_oldest].first_bank_));
+	Stream_FreeSet(the_oldest);
+
+	return true;
+}
+
+
+// give back a set's banks and free its index entry
+static void Stream_FreeSet(uint8_t the_handle)
+{
+	StreamSet*	the_set = &stream_set[the_handle];
+
+	if (the_set->state_ != STREAM_SET_FAILED)
+	{
+		stream_bank_in_use &= ~Stream_BankMask(the_set->first_bank_ - EM_STREAM_FIRST_PHYS_BANK_NUM, the_set->num_banks_);
+	}
+
+	the_set->state_ = STREAM_SET_FREE;
+	the_set->name_ = NULL;
+}
+
+
+// pick the oldest queued set and open its file
+static void Stream_StartNext(void)
+{
+	uint8_t		i;
+	uint8_t		the_next = STREAM_INVALID_HANDLE;
+	uint8_t		the_oldest_age = 0;
+	uint8_t		this_age;
+	#ifdef HOST_BUILD
+		const char*	the_name;
+	#endif
+
+	for (i = 0; i < STREAM_MAX_SETS; i++)
+	{
+		if (stream_set[i].state_ == STREAM_SET_QUEUED)
+		{
+			this_age = stream_queue_stamp - (uint8_t)stream_set[i].last_used_;
+
+			if (the_next == STREAM_INVALID_HANDLE || this_age > the_oldest_age)
+			{
+				the_next = i;
+				the_oldest_age = this_age;
+			}
+		}
+	}
+
+	if (the_next == STREAM_INVALID_HANDLE)
+	{
+		return;
+	}
+
+	#ifdef HOST_BUILD
+		the_name = stream_set[the_next].name_;
+
+		// drop any "n:" drive prefix: on the host, every drive is STREAM_HOST_DIR
+		if (the_name[0] != 0 && the_name[1] == ':')
+		{
+			the_name += 2;
+		}
+
+		sprintf((char*)stream_chunk, "%s%s", STREAM_HOST_DIR, the_name);
+		stream_file = FileIO_Open((char*)stream_chunk, false);
+	#else
+		stream_file = FileIO_Open(stream_set[the_next].name_, false);
+	#endif
+
+	if (stream_file == FILEIO_INVALID_HANDLE)
+	{
+		// every handle is busy (the last set's may still be closing): it stays queued, and gets another go next frame
+		return;
+	}
+
+	// a refused open comes back FILEIO_FAILED, and the next Stream_Service() deals with it like any other failure
+	stream_current = the_next;
+	stream_read_pending = false;
+	stream_release_when_done = false;
+	stream_set[the_next].state_ = STREAM_SET_LOADING;
+	stream_set[the_next].bytes_loaded_ = 0;
+}
+
+
+// copy a chunk that has arrived at stream_chunk into the current set's banks. false if the set failed instead
+static bool Stream_StoreChunk(uint8_t the_len)
+{
+	StreamSet*	the_set = &stream_set[stream_current];
+	uint8_t*	the_src = stream_chunk;
+	uint16_t	the_offset;
+	uint16_t	this_len;
+
+	// LOGIC:
+	//   map the bank the next byte goes to into the EM storage slot and copy. a chunk can straddle two banks,
+	//   so that can take two passes. a file bigger than the banks reserved for it fails rather than spilling over.
+	if ((uint32_t)the_set->bytes_loaded_ + the_len > (uint32_t)the_set->num_banks_ * STREAM_BANK_SIZE)
+	{
+		LOG_ERR(("%s %d: '%s' is bigger than the %u banks reserved for it", __func__, __LINE__, the_set->name_, the_set->num_banks_));
+		Stream_FinishFile(false);
+		return false;
+	}
+
+	while (the_len > 0)
+	{
+		the_offset = the_set->bytes_loaded_ & (STREAM_BANK_SIZE - 1);
+		this_len = STREAM_BANK_SIZE - the_offset;
+
+		if (this_len > the_len)
+		{
+			this_len = the_len;
+		}
+
+		zp_bank_num = the_set->first_bank_ + (uint8_t)(the_set->bytes_loaded_ / STREAM_BANK_SIZE);
+		Memory_SwapInNewBank(EM_STORAGE_START_SLOT);
+		memcpy(HAL_CPU_PTR(EM_STORAGE_START_CPU_ADDR + the_offset), the_src, this_len);
+		Memory_RestorePreviousBank(EM_STORAGE_START_SLOT);
+
+		the_src += this_len;
+		the_len -= (uint8_t)this_len;
+		the_set->bytes_loaded_ += this_len;
+	}
+
+	return true;
+}
+
+
+// the current file is finished, one way or the other: record the outcome and close it
+static void Stream_FinishFile(bool succeeded)
+{
+	StreamSet*	the_set = &stream_set[stream_current];
+
+	if (succeeded)
+	{
+		the_set->state_ = STREAM_SET_RESIDENT;
+		the_set->last_used_ = ++stream_clock;
+		LOG_INFO(("%s %d: '%s' resident at bank %x, %u bytes", __func__, __LINE__, the_set->name_, the_set->first_bank_, the_set->bytes_loaded_));
+	}
+	else
+	{
+		// banks go back right away; the entry stays so the game can see it failed
+		stream_bank_in_use &= ~Stream_BankMask(the_set->first_bank_ - EM_STREAM_FIRST_PHYS_BANK_NUM, the_set->num_banks_);
+		the_set->state_ = STREAM_SET_FAILED;
+	}
+
+	if (stream_release_when_done)
+	{
+		Stream_FreeSet(stream_current);
+	}
+
+	stream_current = STREAM_INVALID_HANDLE;
+	stream_read_pending = false;
+
+	// FileIO closes the file (if it ever opened) in the background, and frees the handle once the kernel says it's closed
+	FileIO_Release(stream_file);
+	stream_file = FILEIO_INVALID_HANDLE;
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// ask for a file to be loaded into the_num_banks 8K banks of EM
+// if it is already in the index (resident or on its way), returns that handle and touches it
+// evicts least recently used resident sets if there isn't room. returns STREAM_INVALID_HANDLE if there still isn't.
+uint8_t Stream_Request(const char* the_file_name, uint8_t the_num_banks)
+{
+	uint8_t		i;
+	uint8_t		the_handle = STREAM_INVALID_HANDLE;
+	uint8_t		the_first;
+
+	for (i = 0; i < STREAM_MAX_SETS; i++)
+	{
+		if (stream_set[i].state_ == STREAM_SET_FREE)
+		{
+			if (the_handle == STREAM_INVALID_HANDLE)
+			{
+				the_handle = i;
+			}
+		}
+		else if (stream_set[i].state_ != STREAM_SET_FAILED && strcmp(stream_set[i].name_, the_file_name) == 0)
+		{
+			Stream_Touch(i);
+			return i;
+		}
+	}
+
+	if (the_num_banks == 0 || the_num_banks > EM_STREAM_NUM_BANKS)
+	{
+		LOG_ERR(("%s %d: '%s' asked for %u banks", __func__, __LINE__, the_file_name, the_num_banks));
+		return STREAM_INVALID_HANDLE;
+	}
+
+	// out of index entries: an evicted resident set frees one up
+	if (the_handle == STREAM_INVALID_HANDLE)
+	{
+		if (Stream_EvictOne() == false)
+		{
+			LOG_WARN(("%s %d: index full, nothing evictable for '%s'", __func__, __LINE__, the_file_name));
+			return STREAM_INVALID_HANDLE;
+		}
+
+		return Stream_Request(the_file_name, the_num_banks);
+	}
+
+	while ((the_first = Stream_FindFreeBanks(the_num_banks)) == STREAM_INVALID_HANDLE)
+	{
+		if (Stream_EvictOne() == false)
+		{
+			LOG_WARN(("%s %d: no room for %u banks for '%s'", __func__, __LINE__, the_num_banks, the_file_name));
+			return STREAM_INVALID_HANDLE;
+		}
+	}
+
+	stream_bank_in_use |= Stream_BankMask(the_first, the_num_banks);
+
+	stream_set[the_handle].name_ = the_file_name;
+	stream_set[the_handle].first_bank_ = EM_STREAM_FIRST_PHYS_BANK_NUM + the_first;
+	stream_set[the_handle].num_banks_ = the_num_banks;
+	stream_set[the_handle].bytes_loaded_ = 0;
+	stream_set[the_handle].last_used_ = ++stream_queue_stamp;
+	stream_set[the_handle].state_ = STREAM_SET_QUEUED;
+
+	return the_handle;
+}
+
+
+// advance the current load by (at most) one chunk, or start the next queued one. call once per frame.
+void Stream_Service(void)
+{
+	if (stream_current == STREAM_INVALID_HANDLE)
+	{
+		Stream_StartNext();
+		return;
+	}
+
+	// LOGIC:
+	//   FileIO talks to the kernel. each frame this stores the chunk the last read brought in, if it's there yet,
+	//   and asks for the next one: a set loads at up to a chunk a frame, and never holds up a frame waiting on the disk.
+	switch (FileIO_GetState(stream_file))
+	{
+		case FILEIO_READY:
+			if (stream_read_pending)
+			{
+				stream_read_pending = false;
+
+				if (Stream_StoreChunk((uint8_t)FileIO_GetCount(stream_file)) == false)
+				{
+					return;
+				}
+			}
+
+			if (FileIO_Read(stream_file, stream_chunk, STREAM_CHUNK_LEN) == false)
+			{
+				LOG_ERR(("%s %d: read refused for '%s'", __func__, __LINE__, stream_set[stream_current].name_));
+				Stream_FinishFile(false);
+				return;
+			}
+
+			stream_read_pending = true;
+			break;
+
+		case FILEIO_AT_END:
+			Stream_FinishFile(true);
+			break;
+
+		case FILEIO_FAILED:
+			LOG_ERR(("%s %d: could not load '%s'", __func__, __LINE__, stream_set[stream_current].name_));
+			Stream_FinishFile(false);
+			break;
+
+		default:
+			// waiting on the kernel
+			break;
+	}
+}
+
+
+// true once the whole file for this handle is in EM
+bool Stream_IsResident(uint8_t the_handle)
+{
+	return (the_handle < STREAM_MAX_SETS && stream_set[the_handle].state_ == STREAM_SET_RESIDENT);
+}
+
+
+// true if the load for this handle failed. the handle stays valid (so the game can check) until released.
+bool Stream_HasFailed(uint8_t the_handle)
+{
+	return (the_handle < STREAM_MAX_SETS && stream_set[the_handle].state_ == STREAM_SET_FAILED);
+}
+
+
+// physical bank number the set starts at
+uint8_t Stream_GetBank(uint8_t the_handle)
+{
+	return stream_set[the_handle].first_bank_;
+}
+
+
+// mark a set as just used, moving it to the back of the eviction line
+void Stream_Touch(uint8_t the_handle)
+{
+	// queued/loading sets use last_used_ for their place in the queue instead
+	if (stream_set[the_handle].state_ == STREAM_SET_RESIDENT)
+	{
+		stream_set[the_handle].last_used_ = ++stream_clock;
+	}
+}
+
+
+// give a set's banks back and free its index entry. a set that is still loading is left to finish, then released.
+void Stream_Release(uint8_t the_handle)
+{
+	if (the_handle >= STREAM_MAX_SETS || stream_set[the_handle].state_ == STREAM_SET_FREE)
+	{
+		return;
+	}
+
+	if (the_handle == stream_current)
+	{
+		stream_release_when_done = true;
+		return;
+	}
+
+	Stream_FreeSet(the_handle);
+}
@@ -0,0 +1,124 @@
+/*
+ * asset_stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef ASSET_STREAM_H_
+#define ASSET_STREAM_H_
+
+
+/* about this class: Stream
+ *
+ * Loads named asset files (sprite sets, tilemaps, etc.) from disk into extended memory on demand, a chunk at a time,
+ *   so nothing waits on the disk and content a session never uses never gets loaded.
+ *   Everything baked into the pgZ stays where it is; this is for what gets added after it.
+ *
+ *** things this class needs to be able to do
+ * accept a request for a file, and find it room in the stream banks (EM_STREAM_* in memory.h)
+ * evict the least recently used sets when there isn't room
+ * read the file in chunks of up to 255 bytes across frames, driven by Stream_Service(), through FileIO (file_io.h)
+ * tell the game whether a set is resident yet, and which bank it is in
+ *
+ *** things objects of this class have
+ *
+ * an index of up to STREAM_MAX_SETS sets: file name, first bank, bank count, bytes loaded, last-used stamp, state
+ * at most one file open at a time. other requests queue up in the index in the order they were made.
+ *
+ *** how to use it
+ *
+ * between waves (or whenever): handle = Stream_Request("1:tank2.bin", 1);
+ * each frame: Stream_Service() (App_RunFrame() does this)
+ * once Stream_IsResident(handle): Stream_GetBank(handle) * 0x2000 is the set's physical address, for VICKY or DMA.
+ *   call Stream_Touch(handle) whenever it is used, so it doesn't get evicted ahead of sets that aren't.
+ * Stream_Release(handle) when done, or leave it and let eviction have it when the room is needed.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define STREAM_MAX_SETS				8		// entries in the resident index
+#define STREAM_CHUNK_LEN			255		// most the kernel will deliver per File.Read
+#define STREAM_INVALID_HANDLE		0xFF
+
+#ifdef HOST_BUILD
+	#define STREAM_HOST_DIR			"data/"	// host builds read the same files from here, with any "n:" drive prefix dropped
+#endif
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+typedef enum stream_set_state
+{
+	STREAM_SET_FREE = 0,		// index entry not in use
+	STREAM_SET_QUEUED,			// banks reserved, waiting for the file to be opened
+	STREAM_SET_LOADING,			// file open, chunks arriving
+	STREAM_SET_RESIDENT,		// whole file is in EM
+	STREAM_SET_FAILED,			// not found, read error, or bigger than the banks reserved for it. banks have been given back.
+} stream_set_state;
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+typedef struct StreamSet
+{
+	const char*	name_;				// file name, as passed to Stream_Request(). not copied: must stay valid until the set is released
+	uint8_t		first_bank_;		// physical bank number of the first 8K bank
+	uint8_t		num_banks_;			// banks reserved for it
+	uint16_t	bytes_loaded_;		// grows as chunks come in. final value is the file size (well, up to 64K)
+	uint16_t	last_used_;			// Stream_Touch() stamp. lowest gets evicted first
+	uint8_t		state_;				// stream_set_state
+} StreamSet;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// ask for a file to be loaded into the_num_banks 8K banks of EM
+// if it is already in the index (resident or on its way), returns that handle and touches it
+// evicts least recently used resident sets if there isn't room. returns STREAM_INVALID_HANDLE if there still isn't.
+uint8_t Stream_Request(const char* the_file_name, uint8_t the_num_banks);
+
+// advance the current load by (at most) one chunk, or start the next queued one. call once per frame.
+void Stream_Service(void);
+
+// true once the whole file for this handle is in EM
+bool Stream_IsResident(uint8_t the_handle);
+
+// true if the load for this handle failed. the handle stays valid (so the game can check) until released.
+bool Stream_HasFailed(uint8_t the_handle);
+
+// physical bank number the set starts at
+uint8_t Stream_GetBank(uint8_t the_handle);
+
+// mark a set as just used, moving it to the back of the eviction line
+void Stream_Touch(uint8_t the_handle);
+
+// give a set's banks back and free its index entry. a set that is still loading is left to finish, then released.
+void Stream_Release(uint8_t the_handle);
+
+
+#endif /* ASSET_STREAM_H_ */
@@ -20,6 +20,7 @@
 #include "keyboard.h"
 #include "memory.h"
 #include "player.h"
+#include "present.h"
 
 // C includes
 #include <stdbool.h>
@@ -35,6 +36,22 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_COMM_BUFFER
+
+#define STAT_NUM_TEXT_FIELDS	7
+
+// first and last col of each stat text field. the icons between them keep whatever color the font gives them.
+static const uint8_t	stat_text_field_cols[STAT_NUM_TEXT_FIELDS][2] = 
+{
+	{STAT_COL_WEAPON_TEXT,	STAT_COL_CLIPS_ICON - 1},
+	{STAT_COL_CLIPS_TEXT,	STAT_COL_BULLETS_ICON - 1},
+	{STAT_COL_BULLETS_TEXT,	STAT_COL_LIVES_ICON - 1},
+	{STAT_COL_LIVES_TEXT,	STAT_COL_HP_ICON - 1},
+	{STAT_COL_HP_TEXT,		STAT_COL_WARPS_ICON - 1},
+	{STAT_COL_WARPS_TEXT,	STAT_COL_SCORE_ICON - 1},
+	{STAT_COL_SCORE_TEXT,	STAT_COL_SCORE_TEXT + 4},	// "%05u"
+};
+
 
 /*****************************************************************************/
 /*                             Global Variables                              */
@@ -167,8 +184,15 @@ void Buffer_RefreshStatDisplay(bool refresh_background)
 {
 	//if (!global_buffer_vis) return;	// do nothing if the comms buffer is not supposed to be visible right now
 	
+	// LOGIC:
+	//   the stat row is a Present HUD shadow: the text below only reaches the screen at the next flush, and only the
+	//   characters that changed since the last one. the HUD only carries characters, so the text fields get their colors
+	//   here, once, instead of with every string drawn.
 	if (refresh_background)
 	{
+		uint8_t		i;
+
+
 		// redraw the only solid background part, which is the single row at the bottom of the screen used for stats
 		Text_FillBox(		
 			STAT_BOX_FIRST_COL, STAT_BOX_FIRST_ROW, 
@@ -177,70 +201,46 @@ void Buffer_RefreshStatDisplay(bool refresh_background)
 			COLOR_BRIGHT_WHITE, 
 			COLOR_BRIGHT_MAGENTA
 		);
+		Present_ClearHud();
+
+		for (i = 0; i < STAT_NUM_TEXT_FIELDS; i++)
+		{
+			Text_FillBoxAttrOnly(
+				stat_text_field_cols[i][0], STAT_FIRST_ROW, 
+				stat_text_field_cols[i][1], STAT_FIRST_ROW, 
+				COLOR_BRIGHT_WHITE, 
+				COLOR_BRIGHT_MAGENTA
+			);
+		}
 
 		// draw icons individually -- don't need to set color, as we already set it when drawing the background line
-		Text_SetCharAtXY(STAT_COL_CLIPS_ICON,	STAT_FIRST_ROW,	CH_CLIP_ICON);
-		Text_SetCharAtXY(STAT_COL_BULLETS_ICON,	STAT_FIRST_ROW,	CH_BULLETS_ICON);
-		Text_SetCharAtXY(STAT_COL_LIVES_ICON,	STAT_FIRST_ROW,	CH_LIVES_ICON);
-		Text_SetCharAtXY(STAT_COL_HP_ICON,		STAT_FIRST_ROW, CH_HP_ICON);
-		Text_SetCharAtXY(STAT_COL_WARPS_ICON,	STAT_FIRST_ROW, CH_WARPS_ICON);
+		Present_SetHudChar(STAT_COL_CLIPS_ICON,		CH_CLIP_ICON);
+		Present_SetHudChar(STAT_COL_BULLETS_ICON,	CH_BULLETS_ICON);
+		Present_SetHudChar(STAT_COL_LIVES_ICON,		CH_LIVES_ICON);
+		Present_SetHudChar(STAT_COL_HP_ICON,		CH_HP_ICON);
+		Present_SetHudChar(STAT_COL_WARPS_ICON,		CH_WARPS_ICON);
 	}
 
 	// draw individual stats each with its own string
-	Text_DrawStringAtXY(
-		STAT_COL_WEAPON_TEXT, STAT_FIRST_ROW, 
-		global_weapon[global_player->current_weapon_id_].name_, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_WEAPON_TEXT, global_weapon[global_player->current_weapon_id_].name_);
 
 	sprintf(global_string_buff1, "%02X", zp_num_clips);
-	Text_DrawStringAtXY(
-		STAT_COL_CLIPS_TEXT, STAT_FIRST_ROW, 
-		global_string_buff1, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_CLIPS_TEXT, global_string_buff1);
 
 	sprintf(global_string_buff1, "%02X", zp_num_bullets);
-	Text_DrawStringAtXY(
-		STAT_COL_BULLETS_TEXT, STAT_FIRST_ROW, 
-		global_string_buff1, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_BULLETS_TEXT, global_string_buff1);
 
 	sprintf(global_string_buff1, "%01X", zp_lives);
-	Text_DrawStringAtXY(
-		STAT_COL_LIVES_TEXT, STAT_FIRST_ROW, 
-		global_string_buff1, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_LIVES_TEXT, global_string_buff1);
 
 	sprintf(global_string_buff1, "%02X", zp_hp);
-	Text_DrawStringAtXY(
-		STAT_COL_HP_TEXT, STAT_FIRST_ROW, 
-		global_string_buff1, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_HP_TEXT, global_string_buff1);
 
 	sprintf(global_string_buff1, "%01X", zp_num_warps);
-	Text_DrawStringAtXY(
-		STAT_COL_WARPS_TEXT, STAT_FIRST_ROW, 
-		global_string_buff1, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_WARPS_TEXT, global_string_buff1);
 
 	sprintf(global_string_buff1, "%05u", zp_points);
-	Text_DrawStringAtXY(
-		STAT_COL_SCORE_TEXT, STAT_FIRST_ROW, 
-		global_string_buff1, 
-		COLOR_BRIGHT_WHITE, 
-		COLOR_BRIGHT_MAGENTA
-	);
+	Present_SetHudString(STAT_COL_SCORE_TEXT, global_string_buff1);
 }
 
 
@@ -60,7 +60,7 @@
 #define COMM_AREA_FIRST_ROW				((SCREEN_NUM_ROWS - COMM_BUFFER_NUM_ROWS) - 2)	// -2 so it starts/ends above the final row, which is the status line.
 #define COMM_AREA_LAST_ROW				(COMM_AREA_FIRST_ROW + COMM_BUFFER_NUM_ROWS)
 #define COMM_BUFFER_FIRST_COL			0	// not 1 because no box draw chars for this usage
-#define COMM_BUFFER_LAST_COL			(COMM_BUFFER_NUM_COLS)	// allow for 1 col of box draw chars
+#define COMM_BUFFER_LAST_COL			(COMM_BUFFER_NUM_COLS - 1)	// last col on screen: any further and fills wrap onto the stat row
 #define COMM_BUFFER_FIRST_ROW			(COMM_AREA_FIRST_ROW + 1) // account for top box draw chars
 #define COMM_BUFFER_LAST_ROW			((COMM_BUFFER_FIRST_ROW + COMM_BUFFER_NUM_ROWS) - 1) // account for box draw chars and row of stats
 #define COMM_BUFF_SIZE					(COMM_BUFFER_NUM_ROWS * (COMM_BUFFER_NUM_COLS + 1))
@@ -151,8 +151,8 @@
 // Draw the status and message area framework
 void Buffer_DrawCommunicationArea(void);
 
-// shows stats from the passed player object in the status area of the screen
-// if refresh_background=true, will redraw the background in black and redraw the icons
+// shows stats from the passed player object in the status area of the screen, at the next Present flush
+// if refresh_background=true, will redraw the background in black right away, and redraw the icons
 void Buffer_RefreshStatDisplay(bool refresh_background);
 
 // fake allocs the buffer memory area. does not change screen display
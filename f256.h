@@ -14,7 +14,10 @@
 /*                                Includes                                   */
 /*****************************************************************************/
 
-#include "api.h"
+#ifndef HOST_BUILD
+	#include "api.h"	// kernel API structs are sized for the 6502; host builds don't talk to the kernel
+#endif
+#include "hal.h"
 #include <stdint.h>
 
 
@@ -24,9 +27,10 @@
 
 
 // adapted from vinz67
-#define R8(x)						*((volatile uint8_t* const)(x))			// make sure we read an 8 bit byte; for VICKY registers, etc.
-#define P8(x)						(volatile uint8_t* const)(x)			// make sure we read an 8 bit byte; for VICKY registers, etc.
-#define R16(x)						*((volatile uint16_t* const)(x))		// make sure we read an 16 bit byte; for RNG etc.
+// routed through HAL_CPU_PTR so host builds land in the emulated CPU space (see hal.h). identical on F256.
+#define R8(x)						*((volatile uint8_t* const)HAL_CPU_PTR(x))			// make sure we read an 8 bit byte; for VICKY registers, etc.
+#define P8(x)						(volatile uint8_t* const)HAL_CPU_PTR(x)			// make sure we read an 8 bit byte; for VICKY registers, etc.
+#define R16(x)						*((volatile uint16_t* const)HAL_CPU_PTR(x))		// make sure we read an 16 bit byte; for RNG etc.
 
 
 // ** F256jr MMU
@@ -172,6 +176,16 @@
 #define RTC_MONTH						0xd699		//    4: second digit, 3210: 1st digit
 #define RTC_YEAR						0xd69a		// 7654: second digit, 3210: 1st digit
 #define RTC_CONTROL						0xd69e		// set bit 3 to disable update of reg, to read secs. 
+#define TIMER0_CTRL						0xd650		// bit 0: enable, 1: clear, 2: load, 3: count up. counts at the 25.175 MHz dot clock
+#define TIMER0_VALUE_LOW				0xd651		// 24-bit count, low byte
+#define TIMER0_VALUE_MED				0xd652
+#define TIMER0_VALUE_HI					0xd653
+#define TIMER_CTRL_ENABLE				0x01
+#define TIMER_CTRL_CLEAR				0x02
+#define TIMER_CTRL_LOAD					0x04
+#define TIMER_CTRL_COUNT_UP				0x08
+#define TIMER0_TICKS_PER_MS				25175		// wraps after ~666ms
+#define TIMER0_TICKS_PER_CPU_CYCLE		4			// 25.175 MHz dot clock / 6.29 MHz CPU clock
 #define RANDOM_NUM_GEN_LOW				0xd6a4		// both the SEEDL and the RNDL (depends on bit 1 of RND_CTRL)
 #define RANDOM_NUM_GEN_HI				0xd6a5		// both the SEEDH and the RNDH (depends on bit 1 of RND_CTRL)
 #define RANDOM_NUM_GEN_ENABLE			0xd6a6		// bit 0: enable/disable. bit 1: seed mode on/off. "RND_CTRL"
@@ -0,0 +1,525 @@
+/*
+ * file_io.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Non-blocking file open/read/write/close, driven by kernel file events
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "file_io.h"
+#include "app.h"
+#include "general.h"
+#include "kernel.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef HOST_BUILD
+	#include <unistd.h>
+	#include <fcntl.h>
+#endif
+
+// F256 includes
+#include "f256.h"
+#ifndef HOST_BUILD
+	#include "api.h"
+#endif
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define LOG_FILE_ID		LOG_FILE_FILE_IO
+
+#ifndef HOST_BUILD
+	#define VECTOR(member) (size_t) (&((struct call*) 0xff00)->member)
+	#define EVENT(member)  (size_t) (&((struct events*) 0)->member)
+	#define CALL(fn) (unsigned char) ( \
+					   asm("jsr %w", VECTOR(fn)), \
+					   asm("stz %v", error), \
+					   asm("ror %v", error), \
+					   __A__)
+#endif
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static FileIOHandle		fileio_handle[FILEIO_MAX_HANDLES];
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+#ifndef HOST_BUILD
+	extern struct event_t	event;
+	extern char				error;
+	#pragma zpsym ("event");
+	#pragma zpsym ("error");
+#endif
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// hand the kernel the next chunk of a FileIO_Write() buffer. false if it refused
+static bool FileIO_WriteNextChunk(FileIOHandle* the_file);
+
+// something went wrong: mark the handle failed, and close the file if one is open
+static void FileIO_Fail(FileIOHandle* the_file);
+
+// the kernel has no stream open for this handle any more: record how it ended, and free it if it was released
+static void FileIO_Closed(FileIOHandle* the_file, uint8_t the_final_state);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+
+// hand the kernel the next chunk of a FileIO_Write() buffer. false if it refused
+static bool FileIO_WriteNextChunk(FileIOHandle* the_file)
+{
+	uint16_t	this_len = the_file->len_ - the_file->count_;
+
+	if (this_len > FILEIO_CHUNK_LEN)
+	{
+		this_len = FILEIO_CHUNK_LEN;
+	}
+
+	#ifdef HOST_BUILD
+		return (write(the_file->stream_, the_file->buffer_ + the_file->count_, this_len) == (ssize_t)this_len);
+	#else
+		return Kernel_WriteAsync((uint8_t)the_file->stream_, the_file->buffer_ + the_file->count_, (uint8_t)this_len);
+	#endif
+}
+
+
+// something went wrong: mark the handle failed, and close the file if one is open
+static void FileIO_Fail(FileIOHandle* the_file)
+{
+	if (the_file->stream_ < 0)
+	{
+		FileIO_Closed(the_file, FILEIO_FAILED);
+		return;
+	}
+
+	#ifdef HOST_BUILD
+		close(the_file->stream_);
+		FileIO_Closed(the_file, FILEIO_FAILED);
+	#else
+		// LOGIC:
+		//   stays FILEIO_FAILED while the close goes through. stream_ is kept so the file.CLOSED that comes back is
+		//   recognized and swallowed. if the kernel won't even take the close, there's nothing more to wait for.
+		the_file->state_ = FILEIO_FAILED;
+
+		if (Kernel_CloseAsync((uint8_t)the_file->stream_) == false)
+		{
+			FileIO_Closed(the_file, FILEIO_FAILED);
+		}
+	#endif
+}
+
+
+// the kernel has no stream open for this handle any more: record how it ended, and free it if it was released
+static void FileIO_Closed(FileIOHandle* the_file, uint8_t the_final_state)
+{
+	the_file->stream_ = -1;
+	the_file->state_ = the_file->release_when_closed_ ? FILEIO_FREE : the_final_state;
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// start opening a file, for writing (created, or emptied if it's there) or for reading. name may start with a drive ("1:name").
+// returns a handle, or FILEIO_INVALID_HANDLE if all handles are in use
+// if the kernel refuses the open, the handle comes back already FILEIO_FAILED
+uint8_t FileIO_Open(const char* the_file_name, bool for_write)
+{
+	uint8_t			i;
+	FileIOHandle*	the_file;
+
+	for (i = 0; i < FILEIO_MAX_HANDLES; i++)
+	{
+		if (fileio_handle[i].state_ == FILEIO_FREE)
+		{
+			break;
+		}
+	}
+
+	if (i == FILEIO_MAX_HANDLES)
+	{
+		LOG_WARN(("%s %d: no free handle for '%s'", __func__, __LINE__, the_file_name));
+		return FILEIO_INVALID_HANDLE;
+	}
+
+	the_file = &fileio_handle[i];
+	the_file->count_ = 0;
+	the_file->release_when_closed_ = false;
+
+	#ifdef HOST_BUILD
+		// drop any "n:" drive prefix: on the host, every drive is the current directory
+		if (the_file_name[0] != 0 && the_file_name[1] == ':')
+		{
+			the_file_name += 2;
+		}
+
+		the_file->stream_ = open(the_file_name, for_write ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+		the_file->state_ = FILEIO_READY;
+	#else
+		the_file->stream_ = Kernel_OpenAsync(the_file_name, for_write ? WRITE : READ);
+		the_file->state_ = FILEIO_OPENING;
+	#endif
+
+	if (the_file->stream_ < 0)
+	{
+		LOG_ERR(("%s %d: could not open '%s'", __func__, __LINE__, the_file_name));
+		FileIO_Closed(the_file, FILEIO_FAILED);
+	}
+
+	return i;
+}
+
+
+// start writing the_len bytes from the_data. the file must be FILEIO_READY. returns false if it wasn't, or the kernel refused
+bool FileIO_Write(uint8_t the_handle, const void* the_data, uint16_t the_len)
+{
+	FileIOHandle*	the_file;
+
+	if (the_handle >= FILEIO_MAX_HANDLES)
+	{
+		return false;
+	}
+
+	the_file = &fileio_handle[the_handle];
+
+	if (the_file->state_ != FILEIO_READY)
+	{
+		return false;
+	}
+
+	the_file->buffer_ = the_data;
+	the_file->len_ = the_len;
+	the_file->count_ = 0;
+
+	if (the_len == 0)
+	{
+		return true;
+	}
+
+	#ifdef HOST_BUILD
+		// all the chunks go now. the file is FILEIO_READY again (or failed) before this returns.
+		while (the_file->count_ < the_len)
+		{
+			if (FileIO_WriteNextChunk(the_file) == false)
+			{
+				FileIO_Fail(the_file);
+				return false;
+			}
+
+			the_file->count_ += (the_len - the_file->count_ > FILEIO_CHUNK_LEN) ? FILEIO_CHUNK_LEN : the_len - the_file->count_;
+		}
+	#else
+		if (FileIO_WriteNextChunk(the_file) == false)
+		{
+			FileIO_Fail(the_file);
+			return false;
+		}
+
+		the_file->state_ = FILEIO_WRITING;
+	#endif
+
+	return true;
+}
+
+
+// start reading up to the_len (max 255) bytes into the_buffer. the file must be FILEIO_READY. returns false if it wasn't, or the kernel refused
+bool FileIO_Read(uint8_t the_handle, void* the_buffer, uint8_t the_len)
+{
+	FileIOHandle*	the_file;
+
+	if (the_handle >= FILEIO_MAX_HANDLES)
+	{
+		return false;
+	}
+
+	the_file = &fileio_handle[the_handle];
+
+	if (the_file->state_ != FILEIO_READY)
+	{
+		return false;
+	}
+
+	the_file->buffer_ = the_buffer;
+	the_file->len_ = the_len;
+	the_file->count_ = 0;
+
+	#ifdef HOST_BUILD
+	{
+		ssize_t		bytes_read = read(the_file->stream_, the_buffer, the_len);
+
+		if (bytes_read < 0)
+		{
+			FileIO_Fail(the_file);
+			return false;
+		}
+
+		the_file->count_ = bytes_read;
+		the_file->state_ = (bytes_read == 0) ? FILEIO_AT_END : FILEIO_READY;
+	}
+	#else
+		if (Kernel_ReadAsync((uint8_t)the_file->stream_, the_len) == false)
+		{
+			FileIO_Fail(the_file);
+			return false;
+		}
+
+		the_file->state_ = FILEIO_READING;
+	#endif
+
+	return true;
+}
+
+
+// start closing the file. the file must be FILEIO_READY or FILEIO_AT_END. returns false if it wasn't
+bool FileIO_Close(uint8_t the_handle)
+{
+	FileIOHandle*	the_file;
+
+	if (the_handle >= FILEIO_MAX_HANDLES)
+	{
+		return false;
+	}
+
+	the_file = &fileio_handle[the_handle];
+
+	if (the_file->state_ != FILEIO_READY && the_file->state_ != FILEIO_AT_END)
+	{
+		return false;
+	}
+
+	#ifdef HOST_BUILD
+		close(the_file->stream_);
+		FileIO_Closed(the_file, FILEIO_CLOSED);
+	#else
+		if (Kernel_CloseAsync((uint8_t)the_file->stream_) == false)
+		{
+			// the kernel only answers a close it accepted: nothing to wait for, and no telling what state the file is in
+			FileIO_Closed(the_file, FILEIO_FAILED);
+			return true;
+		}
+
+		the_file->state_ = FILEIO_CLOSING;
+	#endif
+
+	return true;
+}
+
+
+// stop caring about a handle. it's freed now if nothing is open, or once the kernel has closed the file if something is
+void FileIO_Release(uint8_t the_handle)
+{
+	FileIOHandle*	the_file;
+
+	if (the_handle >= FILEIO_MAX_HANDLES)
+	{
+		return;
+	}
+
+	the_file = &fileio_handle[the_handle];
+
+	if (the_file->state_ == FILEIO_FREE)
+	{
+		return;
+	}
+
+	if (the_file->stream_ < 0)
+	{
+		the_file->state_ = FILEIO_FREE;
+		return;
+	}
+
+	the_file->release_when_closed_ = true;
+
+	// a file that is between requests can be closed now. anything in flight closes when its answer comes back.
+	FileIO_Close(the_handle);
+}
+
+
+// where the handle has got to: a fileio_state
+uint8_t FileIO_GetState(uint8_t the_handle)
+{
+	if (the_handle >= FILEIO_MAX_HANDLES)
+	{
+		return FILEIO_FREE;
+	}
+
+	return fileio_handle[the_handle].state_;
+}
+
+
+// bytes the last FileIO_Read() delivered, or the last FileIO_Write() got through before it finished or failed
+uint16_t FileIO_GetCount(uint8_t the_handle)
+{
+	if (the_handle >= FILEIO_MAX_HANDLES)
+	{
+		return 0;
+	}
+
+	return fileio_handle[the_handle].count_;
+}
+
+
+// pump kernel events until the handle has nothing in flight. events that aren't for a file are dropped, as the kernel's
+// own blocking calls do, so only for where the game can't go on without the answer (starting a replay, shutting down)
+void FileIO_Wait(uint8_t the_handle)
+{
+#ifndef HOST_BUILD
+	uint8_t		the_state;
+
+	for (;;)
+	{
+		the_state = FileIO_GetState(the_handle);
+
+		if (the_state != FILEIO_OPENING && the_state != FILEIO_WRITING && the_state != FILEIO_READING && the_state != FILEIO_CLOSING)
+		{
+			return;
+		}
+
+		event.type = 0;
+		CALL(NextEvent);
+
+		if (error)
+		{
+			asm("jsr %w", VECTOR(Yield));
+		}
+		else if (event.type >= EVENT(file.NOT_FOUND) && event.type <= EVENT(file.SEEK))
+		{
+			FileIO_HandleFileEvent();
+		}
+	}
+#else
+	(void)the_handle;	// host file calls finish before they return: nothing is ever in flight
+#endif
+}
+
+
+// F256 only: Keyboard_ProcessEvents() passes every file.* event here.
+// returns true if it was for one of these handles
+bool FileIO_HandleFileEvent(void)
+{
+#ifdef HOST_BUILD
+	return false;
+#else
+	uint8_t			i;
+	FileIOHandle*	the_file;
+
+	for (i = 0; i < FILEIO_MAX_HANDLES; i++)
+	{
+		if (fileio_handle[i].state_ != FILEIO_FREE && fileio_handle[i].stream_ == event.file.stream)
+		{
+			break;
+		}
+	}
+
+	if (i == FILEIO_MAX_HANDLES)
+	{
+		return false;
+	}
+
+	the_file = &fileio_handle[i];
+
+	switch (event.type)
+	{
+		case EVENT(file.OPENED):
+			the_file->state_ = FILEIO_READY;
+			break;
+
+		case EVENT(file.NOT_FOUND):
+			LOG_ERR(("%s %d: file for handle %u not found", __func__, __LINE__, i));
+			FileIO_Closed(the_file, FILEIO_FAILED);	// never opened: nothing to close
+			return true;
+
+		case EVENT(file.WROTE):
+			the_file->count_ += event.file.wrote.delivered;
+
+			if (event.file.wrote.delivered == 0)
+			{
+				LOG_ERR(("%s %d: kernel took none of a write on handle %u", __func__, __LINE__, i));
+				FileIO_Fail(the_file);
+			}
+			else if (the_file->count_ < the_file->len_)
+			{
+				if (FileIO_WriteNextChunk(the_file) == false)
+				{
+					FileIO_Fail(the_file);
+				}
+			}
+			else
+			{
+				the_file->state_ = FILEIO_READY;
+			}
+			break;
+
+		case EVENT(file.DATA):
+			the_file->count_ = Kernel_ReadData((void*)the_file->buffer_);
+			the_file->state_ = FILEIO_READY;
+			break;
+
+		case EVENT(file.EOFx):
+			the_file->count_ = 0;
+			the_file->state_ = FILEIO_AT_END;
+			break;
+
+		case EVENT(file.CLOSED):
+			FileIO_Closed(the_file, (the_file->state_ == FILEIO_FAILED) ? FILEIO_FAILED : FILEIO_CLOSED);
+			return true;
+
+		case EVENT(file.ERROR):
+			if (the_file->state_ == FILEIO_CLOSING || the_file->state_ == FILEIO_FAILED)
+			{
+				// the close itself failed. nothing more will come for this stream.
+				FileIO_Closed(the_file, FILEIO_FAILED);
+				return true;
+			}
+
+			if (the_file->state_ == FILEIO_OPENING)
+			{
+				the_file->stream_ = -1;		// never opened: nothing to close
+			}
+
+			LOG_ERR(("%s %d: error on handle %u", __func__, __LINE__, i));
+			FileIO_Fail(the_file);
+			return true;
+
+		default:
+			return false;
+	}
+
+	// a released file gets closed as soon as it is between requests
+	if (the_file->release_when_closed_ && (the_file->state_ == FILEIO_READY || the_file->state_ == FILEIO_AT_END))
+	{
+		FileIO_Close(i);
+	}
+
+	return true;
+#endif
+}
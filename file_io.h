@@ -0,0 +1,137 @@
+/*
+ * file_io.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef FILE_IO_H_
+#define FILE_IO_H_
+
+
+/* about this class: FileIO
+ *
+ * Open, read, write, and close files without waiting on the disk.
+ *   Every call hands the kernel a request and returns straight away. The kernel's answers come back as file.* events,
+ *   which Keyboard_ProcessEvents() passes to FileIO_HandleFileEvent() as part of the per-frame event pump,
+ *   and the caller polls FileIO_GetState() to see where things have got to.
+ *   It's the one way the game gets at files: the log file, save states, the asset streamer (asset_stream.h),
+ *   and input replay (replay.h) all go through it.
+ *
+ *** things this class needs to be able to do
+ * keep up to FILEIO_MAX_HANDLES files going at once, each with at most one request in flight
+ * write a buffer of any length, handing it to the kernel FILEIO_CHUNK_LEN bytes at a time as each chunk is taken
+ * read up to 255 bytes per request, straight into the caller's buffer
+ * close a file, and free its handle once the kernel says it's closed, even if the caller has stopped caring
+ *
+ *** how to use it
+ *
+ * the_file = FileIO_Open("0:scores.bin", true);		// FILEIO_OPENING, then FILEIO_READY
+ * once FILEIO_READY: FileIO_Write(the_file, the_data, the_len);	// FILEIO_WRITING, then FILEIO_READY again
+ *   (or FileIO_Read(the_file, the_buffer, 255): FILEIO_READING, then FILEIO_READY with FileIO_GetCount() bytes, or FILEIO_AT_END)
+ * once FILEIO_READY: FileIO_Close(the_file);		// FILEIO_CLOSING, then FILEIO_CLOSED
+ * FileIO_Release(the_file) when done with the handle. anything but FILEIO_CLOSED/_FAILED gets closed first.
+ * data passed to FileIO_Write() is read by the kernel as the chunks go out: leave it alone until FILEIO_READY.
+ * FileIO_Wait(the_file) sits out the request in flight, for the rare caller that can't carry on without the answer.
+ *
+ *** host builds
+ *
+ * every request is done on the spot with POSIX calls, so a file never sits in FILEIO_OPENING/_WRITING/_READING/_CLOSING.
+ *   any "n:" drive prefix is dropped: all drives are the current directory.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define FILEIO_MAX_HANDLES			5		// log, save, asset streamer, replay, and one more for a handle still closing
+#define FILEIO_INVALID_HANDLE		0xFF
+#define FILEIO_CHUNK_LEN			254		// most handed to the kernel per File.Write. kernel.c's write() uses the same.
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+typedef enum fileio_state
+{
+	FILEIO_FREE = 0,			// handle not in use
+	FILEIO_OPENING,				// File.Open issued, waiting on file.OPENED
+	FILEIO_READY,				// open, nothing in flight. next read/write/close can go.
+	FILEIO_WRITING,				// going through the FileIO_Write() buffer a chunk at a time
+	FILEIO_READING,				// File.Read issued, waiting on file.DATA or file.EOFx
+	FILEIO_AT_END,				// a read found the end of the file. still open: close it.
+	FILEIO_CLOSING,				// File.Close issued, waiting on file.CLOSED
+	FILEIO_CLOSED,				// closed cleanly
+	FILEIO_FAILED,				// not found, refused, or a read/write error. closed (or being closed) for you.
+} fileio_state;
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+typedef struct FileIOHandle
+{
+	const uint8_t*	buffer_;		// FileIO_Write() data, or FileIO_Read() destination
+	uint16_t		len_;			// bytes to write, or most to read
+	uint16_t		count_;			// bytes written so far, or delivered by the last read
+	int16_t			stream_;		// kernel stream id (host: POSIX fd), -1 if there isn't one open
+	uint8_t			state_;			// fileio_state
+	bool			release_when_closed_;	// FileIO_Release() came while the file was still open
+} FileIOHandle;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// start opening a file, for writing (created, or emptied if it's there) or for reading. name may start with a drive ("1:name").
+// returns a handle, or FILEIO_INVALID_HANDLE if all handles are in use
+// if the kernel refuses the open, the handle comes back already FILEIO_FAILED
+uint8_t FileIO_Open(const char* the_file_name, bool for_write);
+
+// start writing the_len bytes from the_data. the file must be FILEIO_READY. returns false if it wasn't, or the kernel refused
+bool FileIO_Write(uint8_t the_handle, const void* the_data, uint16_t the_len);
+
+// start reading up to the_len (max 255) bytes into the_buffer. the file must be FILEIO_READY. returns false if it wasn't, or the kernel refused
+bool FileIO_Read(uint8_t the_handle, void* the_buffer, uint8_t the_len);
+
+// start closing the file. the file must be FILEIO_READY or FILEIO_AT_END. returns false if it wasn't
+bool FileIO_Close(uint8_t the_handle);
+
+// stop caring about a handle. it's freed now if nothing is open, or once the kernel has closed the file if something is
+void FileIO_Release(uint8_t the_handle);
+
+// where the handle has got to: a fileio_state
+uint8_t FileIO_GetState(uint8_t the_handle);
+
+// bytes the last FileIO_Read() delivered, or the last FileIO_Write() got through before it finished or failed
+uint16_t FileIO_GetCount(uint8_t the_handle);
+
+// pump kernel events until the handle has nothing in flight. events that aren't for a file are dropped, as the kernel's
+// own blocking calls do, so only for where the game can't go on without the answer (starting a replay, shutting down)
+void FileIO_Wait(uint8_t the_handle);
+
+// F256 only: Keyboard_ProcessEvents() passes every file.* event here.
+// returns true if it was for one of these handles
+bool FileIO_HandleFileEvent(void);
+
+
+#endif /* FILE_IO_H_ */
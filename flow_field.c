@@ -0,0 +1,323 @@
+/*
+ * flow_field.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Breadth-first distance-to-player map that humans steer by, built a few tiles per frame
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "flow_field.h"
+#include "app.h"
+#include "player.h"
+#include "playfield.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define FLOW_FIELD_UNSEEN			0xFF		// the search hasn't reached this tile (yet)
+#define FLOW_FIELD_SOLID			0xFE		// the search reached it and found a wall. never expanded, never steered into.
+#define FLOW_FIELD_MAX_DIST			0xFD		// distances stop counting up here. only a maze could go that far in 300 tiles.
+
+// world px of a 16x16 sprite's x1/y1 to the world tile under its center: VICKY's 32 px sprite offset, less half a sprite
+#define FLOW_FIELD_CENTER_OFFSET	(32 - 8)
+
+// the tables, in the playfield bank after the world map. each is FLOW_FIELD_LEN bytes, row by row.
+#define FLOW_FIELD_CPU_ADDR			PLAYFIELD_SPARE_CPU_ADDR
+#define FLOW_DIST					((uint8_t*)HAL_CPU_PTR(FLOW_FIELD_CPU_ADDR))						// the search being built: tiles from the player, or FLOW_FIELD_UNSEEN/_SOLID
+#define FLOW_DONE_DIST				((uint8_t*)HAL_CPU_PTR(FLOW_FIELD_CPU_ADDR + FLOW_FIELD_LEN))		// the last search that finished. humans steer by this one.
+#define FLOW_QUEUE_COL				((uint8_t*)HAL_CPU_PTR(FLOW_FIELD_CPU_ADDR + FLOW_FIELD_LEN * 2))	// the BFS queue. every tile goes in at most
+#define FLOW_QUEUE_ROW				((uint8_t*)HAL_CPU_PTR(FLOW_FIELD_CPU_ADDR + FLOW_FIELD_LEN * 3))	//   once per search, so it never needs to wrap.
+#define FLOW_FIELD_TABLES_LEN		(FLOW_FIELD_LEN * 4)
+
+#if FLOW_FIELD_TABLES_LEN > PLAYFIELD_SPARE_LEN
+	#error "flow_field: the tables don't fit in the playfield bank after the world map. shrink the world or the window"
+#endif
+
+#if FLOW_FIELD_ROWS != 15
+	#error "flow_field: flow_row_start[] has 1 entry per window row. update it to match FLOW_FIELD_ROWS"
+#endif
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint16_t		flow_queue_head;				// next tile to expand
+static uint16_t		flow_queue_tail;				// where the next tile found goes. search is done when head catches up.
+static bool			flow_is_done;					// the search being built has been copied to FLOW_DONE_DIST
+
+static uint8_t		flow_origin_col;				// world col/row of the window's top left, for the search being built
+static uint8_t		flow_origin_row;
+static uint8_t		flow_done_origin_col;			// and for the one that finished
+static uint8_t		flow_done_origin_row;
+static uint8_t		flow_player_col = 0xFF;			// world col/row of the player's tile the search is running from.
+static uint8_t		flow_player_row = 0xFF;			//   0xFF: no search yet
+
+static uint8_t		flow_neighbour_dist[4];			// FlowField_GetDirection(): N, E, S, W of the sprite's tile
+
+static const uint16_t	flow_row_start[FLOW_FIELD_ROWS] =
+{
+	0 * FLOW_FIELD_COLS, 1 * FLOW_FIELD_COLS, 2 * FLOW_FIELD_COLS, 3 * FLOW_FIELD_COLS, 4 * FLOW_FIELD_COLS,
+	5 * FLOW_FIELD_COLS, 6 * FLOW_FIELD_COLS, 7 * FLOW_FIELD_COLS, 8 * FLOW_FIELD_COLS, 9 * FLOW_FIELD_COLS,
+	10 * FLOW_FIELD_COLS, 11 * FLOW_FIELD_COLS, 12 * FLOW_FIELD_COLS, 13 * FLOW_FIELD_COLS, 14 * FLOW_FIELD_COLS,
+};
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern uint16_t				zp_px;
+extern uint16_t				zp_py;
+#pragma zpsym ("zp_px");
+#pragma zpsym ("zp_py");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// center the window on the player's tile (pushed back inside the world at its edges) and start a new search from it
+void FlowField_Restart(uint8_t the_player_col, uint8_t the_player_row);
+
+// give an unseen window tile its distance and queue it, or mark it solid. tiles already seen are left alone.
+void FlowField_Visit(uint8_t the_col, uint8_t the_row, uint16_t the_index, uint8_t the_dist);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+
+// center the window on the player's tile (pushed back inside the world at its edges) and start a new search from it
+void FlowField_Restart(uint8_t the_player_col, uint8_t the_player_row)
+{
+	flow_player_col = the_player_col;
+	flow_player_row = the_player_row;
+
+	if (the_player_col < FLOW_FIELD_COLS / 2)
+	{
+		flow_origin_col = 0;
+	}
+	else if (the_player_col - FLOW_FIELD_COLS / 2 > PLAYFIELD_WORLD_COLS - FLOW_FIELD_COLS)
+	{
+		flow_origin_col = PLAYFIELD_WORLD_COLS - FLOW_FIELD_COLS;
+	}
+	else
+	{
+		flow_origin_col = the_player_col - FLOW_FIELD_COLS / 2;
+	}
+
+	if (the_player_row < FLOW_FIELD_ROWS / 2)
+	{
+		flow_origin_row = 0;
+	}
+	else if (the_player_row - FLOW_FIELD_ROWS / 2 > PLAYFIELD_WORLD_ROWS - FLOW_FIELD_ROWS)
+	{
+		flow_origin_row = PLAYFIELD_WORLD_ROWS - FLOW_FIELD_ROWS;
+	}
+	else
+	{
+		flow_origin_row = the_player_row - FLOW_FIELD_ROWS / 2;
+	}
+
+	memset(FLOW_DIST, FLOW_FIELD_UNSEEN, FLOW_FIELD_LEN);
+	flow_queue_head = 0;
+	flow_queue_tail = 0;
+	flow_is_done = false;
+
+	the_player_col -= flow_origin_col;
+	the_player_row -= flow_origin_row;
+	FlowField_Visit(the_player_col, the_player_row, flow_row_start[the_player_row] + the_player_col, 0);
+}
+
+
+// give an unseen window tile its distance and queue it, or mark it solid. tiles already seen are left alone.
+void FlowField_Visit(uint8_t the_col, uint8_t the_row, uint16_t the_index, uint8_t the_dist)
+{
+	if (FLOW_DIST[the_index] != FLOW_FIELD_UNSEEN)
+	{
+		return;
+	}
+
+	// LOGIC:
+	//   the solid check happens here, the first time the search touches a tile, rather than for the whole window
+	//   at restart: each tile costs one Playfield_IsSolid() per search, and that cost is spread out like the rest.
+	if (Playfield_IsSolid(flow_origin_col + the_col, flow_origin_row + the_row) == true)
+	{
+		FLOW_DIST[the_index] = FLOW_FIELD_SOLID;
+		return;
+	}
+
+	FLOW_DIST[the_index] = the_dist;
+	FLOW_QUEUE_COL[flow_queue_tail] = the_col;
+	FLOW_QUEUE_ROW[flow_queue_tail] = the_row;
+	++flow_queue_tail;
+}
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// forget the current search and the finished one. the next FlowField_Update() starts a new one from wherever the player is.
+// call at the start of a game, or after the player is moved somewhere other than by walking. leaves the playfield bank mapped.
+void FlowField_Reset(void)
+{
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	flow_player_col = 0xFF;
+	flow_player_row = 0xFF;
+	flow_queue_head = 0;
+	flow_queue_tail = 0;
+	flow_is_done = true;
+	memset(FLOW_DIST, FLOW_FIELD_UNSEEN, FLOW_FIELD_LEN);
+
+	// nothing to steer by until the first search finishes: a stale one would point at where the player was
+	flow_done_origin_col = 0;
+	flow_done_origin_row = 0;
+	memset(FLOW_DONE_DIST, FLOW_FIELD_UNSEEN, FLOW_FIELD_LEN);
+}
+
+
+// restart the search if the player is on a new tile, then carry it on by up to FLOW_FIELD_CELLS_PER_FRAME tiles.
+// call once per frame, after the player moves. leaves the playfield bank mapped.
+void FlowField_Update(void)
+{
+	uint8_t		the_col;
+	uint8_t		the_row;
+	uint8_t		the_dist;
+	uint16_t	the_index;
+	uint8_t		the_budget;
+
+	the_col = (zp_px - FLOW_FIELD_CENTER_OFFSET) / PLAYFIELD_TILE_SIZE;
+	the_row = (zp_py - FLOW_FIELD_CENTER_OFFSET) / PLAYFIELD_TILE_SIZE;
+
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	if (the_col != flow_player_col || the_row != flow_player_row)
+	{
+		FlowField_Restart(the_col, the_row);
+	}
+
+	for (the_budget = FLOW_FIELD_CELLS_PER_FRAME; the_budget > 0 && flow_queue_head != flow_queue_tail; --the_budget)
+	{
+		the_col = FLOW_QUEUE_COL[flow_queue_head];
+		the_row = FLOW_QUEUE_ROW[flow_queue_head];
+		++flow_queue_head;
+
+		the_index = flow_row_start[the_row] + the_col;
+		the_dist = FLOW_DIST[the_index];
+
+		if (the_dist < FLOW_FIELD_MAX_DIST)
+		{
+			++the_dist;
+		}
+
+		if (the_row > 0)
+		{
+			FlowField_Visit(the_col, the_row - 1, the_index - FLOW_FIELD_COLS, the_dist);
+		}
+
+		if (the_col < FLOW_FIELD_COLS - 1)
+		{
+			FlowField_Visit(the_col + 1, the_row, the_index + 1, the_dist);
+		}
+
+		if (the_row < FLOW_FIELD_ROWS - 1)
+		{
+			FlowField_Visit(the_col, the_row + 1, the_index + FLOW_FIELD_COLS, the_dist);
+		}
+
+		if (the_col > 0)
+		{
+			FlowField_Visit(the_col - 1, the_row, the_index - 1, the_dist);
+		}
+	}
+
+	// LOGIC:
+	//   a finished search replaces the one humans steer by all at once. one 300 byte copy per search (every 8+ frames)
+	//   keeps both tables at fixed addresses, so FlowField_GetDirection() reads them as cheaply as before.
+	if (flow_queue_head == flow_queue_tail && flow_is_done == false)
+	{
+		memcpy(FLOW_DONE_DIST, FLOW_DIST, FLOW_FIELD_LEN);
+		flow_done_origin_col = flow_origin_col;
+		flow_done_origin_row = flow_origin_row;
+		flow_is_done = true;
+	}
+}
+
+
+// direction (PLAYER_DIR_NORTH, _EAST, _SOUTH, _WEST) a 16x16 sprite at world x/y should take to get closer to the player.
+// the_cur_direction is kept if it's one of the ways that gets closer. the playfield bank must be mapped.
+// FLOW_FIELD_NO_DIRECTION if the sprite is outside the finished search's window, wasn't reached by it, or is on its start tile.
+uint8_t FlowField_GetDirection(uint16_t the_x, uint16_t the_y, uint8_t the_cur_direction)
+{
+	uint8_t		the_col;
+	uint8_t		the_row;
+	uint8_t		the_dist;
+	uint16_t	the_index;
+	uint8_t		i;
+
+	// LOGIC:
+	//   left of/above the window wraps around to a big number, so one compare each way covers both sides.
+	the_col = (uint8_t)((the_x - FLOW_FIELD_CENTER_OFFSET) / PLAYFIELD_TILE_SIZE) - flow_done_origin_col;
+	the_row = (uint8_t)((the_y - FLOW_FIELD_CENTER_OFFSET) / PLAYFIELD_TILE_SIZE) - flow_done_origin_row;
+
+	if (the_col >= FLOW_FIELD_COLS || the_row >= FLOW_FIELD_ROWS)
+	{
+		return FLOW_FIELD_NO_DIRECTION;
+	}
+
+	the_index = flow_row_start[the_row] + the_col;
+	the_dist = FLOW_DONE_DIST[the_index];
+
+	if (the_dist == 0 || the_dist > FLOW_FIELD_MAX_DIST)
+	{
+		return FLOW_FIELD_NO_DIRECTION;
+	}
+
+	// LOGIC:
+	//   off the edge of the window counts as unseen. unseen and solid are both bigger than any distance,
+	//   so they're never picked. a reached tile always has at least 1 neighbour that's closer: the one it was found from.
+	flow_neighbour_dist[0] = (the_row > 0) ? FLOW_DONE_DIST[the_index - FLOW_FIELD_COLS] : FLOW_FIELD_UNSEEN;
+	flow_neighbour_dist[1] = (the_col < FLOW_FIELD_COLS - 1) ? FLOW_DONE_DIST[the_index + 1] : FLOW_FIELD_UNSEEN;
+	flow_neighbour_dist[2] = (the_row < FLOW_FIELD_ROWS - 1) ? FLOW_DONE_DIST[the_index + FLOW_FIELD_COLS] : FLOW_FIELD_UNSEEN;
+	flow_neighbour_dist[3] = (the_col > 0) ? FLOW_DONE_DIST[the_index - 1] : FLOW_FIELD_UNSEEN;
+
+	// stick with the way it's going if that works, so humans don't zig-zag on the diagonal
+	if ((the_cur_direction & 1) == 0 && flow_neighbour_dist[the_cur_direction >> 1] < the_dist)
+	{
+		return the_cur_direction;
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		if (flow_neighbour_dist[i] < the_dist)
+		{
+			return i * 2;	// N, E, S, W are PLAYER_DIR_NORTH + 0, 2, 4, 6
+		}
+	}
+
+	return FLOW_FIELD_NO_DIRECTION;
+}
@@ -0,0 +1,100 @@
+/*
+ * flow_field.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+
+/* about this class: FlowField
+ *
+ * A distance-to-the-player map, in tiles, that humans steer by.
+ *   Instead of each human searching for the player, one breadth-first search runs out from the player's tile,
+ *   and every human just looks at the 4 tiles around it and walks toward the one that's closer.
+ *
+ *** things this class needs to be able to do
+ * start a new search whenever the player moves onto another tile
+ * carry the search on a fixed number of tiles per frame, so it costs the same whether 1 human or 40 are alive
+ * go around solid tiles (Playfield_IsSolid)
+ * tell a human which way to go from where it is, with a few table reads
+ *
+ *** the window
+ *
+ * the world is PLAYFIELD_WORLD_COLS x PLAYFIELD_WORLD_ROWS tiles: too many to search every few frames.
+ *   the search covers a screen-sized window (FLOW_FIELD_COLS x FLOW_FIELD_ROWS) with the player in the middle,
+ *   pushed back inside the world at its edges. humans outside the window don't chase: they're off screen anyway.
+ * the tables (2 windows of distances, and the search queue) live in the playfield bank, after the world map, not in
+ *   MAIN. FlowField_Update() maps the bank itself; callers of FlowField_GetDirection() map it first.
+ *
+ *** amortizing
+ *
+ * FlowField_Update() expands FLOW_FIELD_CELLS_PER_FRAME tiles per call. the player moves at most 2 px a frame, so it
+ *   stays on a tile for at least 8 frames, and that's enough to finish the whole window before the next restart.
+ * humans steer by the last search that finished, never the one being built: a search that just restarted has
+ *   reached almost nothing yet. the finished one is at most a tile or so behind the player, which a human several
+ *   tiles away can't tell from the real thing. it's copied over the moment the next one finishes.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "playfield.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define FLOW_FIELD_COLS				PLAYFIELD_SCREEN_COLS		// 20
+#define FLOW_FIELD_ROWS				PLAYFIELD_SCREEN_ROWS		// 15
+#define FLOW_FIELD_LEN				(FLOW_FIELD_COLS * FLOW_FIELD_ROWS)
+#define FLOW_FIELD_CELLS_PER_FRAME	40			// tiles expanded per FlowField_Update(). 300 / 8 frames, rounded up.
+
+#define FLOW_FIELD_NO_DIRECTION		0xFF		// FlowField_GetDirection(): keep going the way you were
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// forget the current search and the finished one. the next FlowField_Update() starts a new one from wherever the player is.
+// call at the start of a game, or after the player is moved somewhere other than by walking. leaves the playfield bank mapped.
+void FlowField_Reset(void);
+
+// restart the search if the player is on a new tile, then carry it on by up to FLOW_FIELD_CELLS_PER_FRAME tiles.
+// call once per frame, after the player moves. leaves the playfield bank mapped.
+void FlowField_Update(void);
+
+// direction (PLAYER_DIR_NORTH, _EAST, _SOUTH, _WEST) a 16x16 sprite at world x/y should take to get closer to the player.
+// the_cur_direction is kept if it's one of the ways that gets closer. the playfield bank must be mapped.
+// FLOW_FIELD_NO_DIRECTION if the sprite is outside the finished search's window, wasn't reached by it, or is on its start tile.
+uint8_t FlowField_GetDirection(uint16_t the_x, uint16_t the_y, uint8_t the_cur_direction);
+
+
+#endif /* FLOW_FIELD_H_ */
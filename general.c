@@ -18,6 +18,7 @@
 // project includes
 #include "general.h"
 #include "app.h"
+#include "file_io.h"
 #include "strings.h"
 #include "memory.h"
 #include "strings.h"
@@ -46,6 +47,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_GENERAL
+
 // ** serial comms related
 #define UART_BAUD_DIV_300		5244	// divisor for 300 baud
 #define UART_BAUD_DIV_600		2622	// divisor for 600 baud
@@ -73,6 +76,8 @@
 #define UART_ERROR_MASK			0b10011110
 
 #define UART_MAX_SEND_ATTEMPTS	1000
+#define UART_FIFO_ENABLE_AND_RESET	0b00000111	// FCR: FIFOs on, both emptied
+#define UART_TX_FIFO_LEN		16			// bytes the transmit FIFO takes once THR reads empty
 
 
 
@@ -88,8 +93,6 @@
 /*****************************************************************************/
 
 
-extern char*			global_string[NUM_STRINGS];
-
 extern char*			global_string_buff1;
 // extern char*			global_string_buff2;
 
@@ -111,7 +114,31 @@ extern uint8_t			zp_bank_num;
 	#ifndef USE_SERIAL_LOGGING
 
 		//static FILE*			global_log_file;
-		static int16_t			global_log_file_handle;
+		static uint8_t			global_log_file_handle = FILEIO_INVALID_HANDLE;	// a FileIO handle
+
+		// LOGIC:
+		//   log lines pile up in one buffer while the other is being written out. General_LogFlush() swaps them
+		//   once a frame, if the last write is done. lines that don't fit before then are dropped (and counted).
+		static char				global_log_buffer[2][GENERAL_LOG_BUFFER_LEN];
+		static uint8_t			global_log_fill_index;		// which buffer new lines go into
+		static uint16_t			global_log_fill_len;
+		static uint16_t			global_log_lines_dropped;
+	#endif
+
+	#ifdef USE_BINARY_LOGGING
+		static uint16_t			log_records_dropped;		// ring was full. reported in the next record that fits.
+	#endif
+#endif
+
+#ifdef USE_SERIAL_TX_RING
+	// LOGIC:
+	//   data goes in at serial_tx_head a whole packet at a time, and out of serial_tx_tail a byte at a time as the
+	//   UART takes it. both are byte offsets into 1 page, so they wrap on their own.
+	static uint8_t			serial_tx_ring[SERIAL_TX_RING_LEN];
+	static uint8_t			serial_tx_head;
+	static uint8_t			serial_tx_tail;
+	#ifdef HOST_BUILD
+		static int				serial_host_fd = -1;		// stands in for the UART. Serial_SetHostOutput().
 	#endif
 #endif
 
@@ -121,6 +148,11 @@ extern uint8_t			zp_bank_num;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+#if (defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5) && !defined USE_SERIAL_LOGGING
+	// add a log line to the buffer the next General_LogFlush() writes out
+	static void General_LogAppend(const char* the_text, uint16_t the_len);
+#endif
+
 
 
 /*****************************************************************************/
@@ -221,14 +253,6 @@ extern uint8_t			zp_bank_num;
 
 // **** MISC STRING UTILITIES *****
 
-// // retrieves a string from extended memory and stashes in the first page of STORAGE_DOS_BOOT_BUFFER for the calling program to retrieve
-// // returns a pointer to the string (pointer will always be to STORAGE_DOS_BOOT_BUFFER)
-// char* General_GetString(uint8_t the_string_id)
-// {
-// 	return global_string[the_string_id];
-// }
-
-
 // //! Convert a string, in place, to lower case
 // //! This overwrites the string with a lower case version of itself.
 // //! Warning: no length check is in place. Calling function must verify string is well-formed (terminated).
@@ -816,9 +840,9 @@ void General_DelayTicks(uint16_t ticks)
 // **** LOGGING AND DEBUG UTILITIES *****
 
 
-#if defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5
+#if defined USE_SERIAL_PORT || defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5
 
-	#if defined USE_SERIAL_LOGGING
+	#if defined USE_SERIAL_PORT
 		// LOGIC FOR SERIAL LOGGING:
 		//   we will use the baud speed defined in by macro in build script. 81N.
 		//   we will NOT check if the other side is receiving, we just blast away
@@ -873,6 +897,7 @@ void General_DelayTicks(uint16_t ticks)
 			Serial_SetDLAB();
 			R16(UART_DLL) = UART_BAUD_DIV_57600;
 			Serial_ClearDLAB();
+			R8(UART_FCR) = UART_FIFO_ENABLE_AND_RESET;	// Serial_Drain() fills the transmit FIFO in bursts
 			Sys_RestoreIOPage();
 		}
 		
@@ -946,6 +971,150 @@ void General_DelayTicks(uint16_t ticks)
 		}
 		
     
+		#ifdef USE_SERIAL_TX_RING
+		
+		// queue the_len bytes for Serial_Drain() to send. all or nothing: returns false, and queues none, if they don't fit
+		bool Serial_QueueData(const uint8_t* the_data, uint8_t the_len)
+		{
+			// 1 byte is always kept free, so head == tail only ever means empty
+			if ((uint8_t)(serial_tx_head - serial_tx_tail) > SERIAL_TX_RING_LEN - 1 - the_len)
+			{
+				return false;
+			}
+			
+			while (the_len > 0)
+			{
+				serial_tx_ring[serial_tx_head] = *the_data++;
+				++serial_tx_head;
+				--the_len;
+			}
+			
+			return true;
+		}
+		
+		
+		// hand the UART as many queued bytes as it can take without waiting. no footprint unless something queues: use SERIAL_DRAIN()
+		void Serial_Drain(void)
+		{
+			#ifndef HOST_BUILD
+				uint8_t		the_room;
+			#endif
+			
+			if (serial_tx_head == serial_tx_tail)
+			{
+				return;
+			}
+			
+			#ifdef HOST_BUILD
+				// the host's "UART" is a file or pty, which takes everything
+				while (serial_tx_tail != serial_tx_head)
+				{
+					if (serial_host_fd >= 0)
+					{
+						write(serial_host_fd, &serial_tx_ring[serial_tx_tail], 1);
+					}
+					
+					++serial_tx_tail;
+				}
+			#else
+				Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+				
+				// THR reads empty once the whole transmit FIFO is, so then it can take a full FIFO's worth straight off
+				if (R8(UART_LSR) & UART_THR_IS_EMPTY)
+				{
+					for (the_room = UART_TX_FIFO_LEN; the_room > 0 && serial_tx_tail != serial_tx_head; --the_room)
+					{
+						R8(UART_THR) = serial_tx_ring[serial_tx_tail];
+						++serial_tx_tail;
+					}
+				}
+				
+				Sys_RestoreIOPage();
+			#endif
+		}
+		
+		
+		#ifdef HOST_BUILD
+			// host builds: send what Serial_Drain() would have put out the UART to the_fd instead (-1: nowhere)
+			void Serial_SetHostOutput(int the_fd)
+			{
+				serial_host_fd = the_fd;
+			}
+		#endif
+		
+		#endif
+		
+	#endif
+#endif
+
+#if defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5
+
+	#ifdef USE_BINARY_LOGGING
+		// binary logging: queue a record for log call the_file_id/the_line, with the arguments the_layout says follow. use the LOG_* macros.
+		void General_LogRecord(uint8_t the_file_id, uint16_t the_line, uint16_t the_layout, ...)
+		{
+			va_list		args;
+			uint8_t		the_record[LOG_RECORD_LEN];
+			uint8_t		the_offset;
+			uint8_t		i;
+			uint16_t	the_word;
+			uint32_t	the_long;
+			
+			// LOGIC:
+			//   after a drop, the count goes in first. if even that doesn't fit, this one is dropped too.
+			if (log_records_dropped > 0)
+			{
+				the_record[0] = LOG_RECORD_SYNC;
+				the_record[1] = LOG_FILE_DROPPED;
+				the_record[2] = log_records_dropped & 0xFF;
+				the_record[3] = log_records_dropped >> 8;
+				
+				if (Serial_QueueData(the_record, LOG_RECORD_LEN) == false)
+				{
+					++log_records_dropped;
+					return;
+				}
+				
+				log_records_dropped = 0;
+			}
+			
+			the_record[0] = LOG_RECORD_SYNC;
+			the_record[1] = the_file_id;
+			the_record[2] = the_line & 0xFF;
+			the_record[3] = the_line >> 8;
+			the_offset = 4;
+			
+			// LOGIC:
+			//   tools/log_table.py read the format at build time, and its LOG_SITE_ macro passes only what the record carries:
+			//   the_layout's low byte is how many arguments, and LOG_RECORD_LAYOUT_LONG << n is set if argument n is a long.
+			//   the rest are one word each (cc65 passes char, int, and pointers as 16 bits). it checked they fit in the record.
+			va_start(args, the_layout);
+			
+			for (i = 0; i < (uint8_t)the_layout; ++i)
+			{
+				if (the_layout & (LOG_RECORD_LAYOUT_LONG << i))
+				{
+					the_long = va_arg(args, uint32_t);
+					the_record[the_offset++] = the_long & 0xFF;
+					the_record[the_offset++] = (the_long >> 8) & 0xFF;
+					the_record[the_offset++] = (the_long >> 16) & 0xFF;
+					the_record[the_offset++] = the_long >> 24;
+				}
+				else
+				{
+					the_word = va_arg(args, unsigned int);
+					the_record[the_offset++] = the_word & 0xFF;
+					the_record[the_offset++] = the_word >> 8;
+				}
+			}
+			
+			va_end(args);
+			
+			if (Serial_QueueData(the_record, LOG_RECORD_LEN) == false)
+			{
+				++log_records_dropped;
+			}
+		}
 	#endif
     	
 
@@ -954,7 +1123,7 @@ void General_DelayTicks(uint16_t ticks)
 //   additional debug out function that leaves no footprint in compiled release version of code (calls to it also disappear)
 //   able to pass format string and multiple variables when needed
 
-#ifdef LOG_LEVEL_1 
+#if defined LOG_LEVEL_1 && !defined USE_BINARY_LOGGING
 void General_LogError(const char* format, ...)
 {
 	va_list		args;
@@ -965,19 +1134,19 @@ void General_LogError(const char* format, ...)
 	va_end(args);
 
 	//fprintf(global_log_file, "%s %s\n", kDebugFlag[LogError], debug_buffer);
-	sprintf((char*)STORAGE_GETSTRING_BUFFER, "%s %s\n", kDebugFlag[LogError], debug_buffer);
-	the_len = strlen((char*)STORAGE_GETSTRING_BUFFER);
+	sprintf((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), "%s %s\n", kDebugFlag[LogError], debug_buffer);
+	the_len = strlen((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER));
 
 	#if defined USE_SERIAL_LOGGING
-		Serial_SendData((char*)STORAGE_GETSTRING_BUFFER, the_len);
+		Serial_SendData((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 	#else
-		write(global_log_file_handle, (char*)STORAGE_GETSTRING_BUFFER, the_len);
+		General_LogAppend((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 	#endif
 }
 #endif
 
 
-#ifdef LOG_LEVEL_2
+#if defined LOG_LEVEL_2 && !defined USE_BINARY_LOGGING
 	void General_LogWarning(const char* format, ...)
 	{
 		va_list		args;
@@ -988,19 +1157,19 @@ void General_LogError(const char* format, ...)
 		va_end(args);
 	
 		//fprintf(global_log_file, "%s %s\n", kDebugFlag[LogWarning], debug_buffer);
-		sprintf((char*)STORAGE_GETSTRING_BUFFER, "%s %s\n", kDebugFlag[LogWarning], debug_buffer);
-		the_len = strlen((char*)STORAGE_GETSTRING_BUFFER);
+		sprintf((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), "%s %s\n", kDebugFlag[LogWarning], debug_buffer);
+		the_len = strlen((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER));
 	
 		#if defined USE_SERIAL_LOGGING
-			Serial_SendData((char*)STORAGE_GETSTRING_BUFFER, the_len);
+			Serial_SendData((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#else
-			write(global_log_file_handle, (char*)STORAGE_GETSTRING_BUFFER, the_len);
+			General_LogAppend((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#endif
 	}
 #endif
 
 
-#ifdef LOG_LEVEL_3
+#if defined LOG_LEVEL_3 && !defined USE_BINARY_LOGGING
 	void General_LogInfo(const char* format, ...)
 	{
 		va_list		args;
@@ -1011,18 +1180,18 @@ void General_LogError(const char* format, ...)
 		va_end(args);
 	
 		//fprintf(global_log_file, "%s %s\n", kDebugFlag[LogInfo], debug_buffer);
-		sprintf((char*)STORAGE_GETSTRING_BUFFER, "%s %s\n", kDebugFlag[LogInfo], debug_buffer);
-		the_len = strlen((char*)STORAGE_GETSTRING_BUFFER);
+		sprintf((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), "%s %s\n", kDebugFlag[LogInfo], debug_buffer);
+		the_len = strlen((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER));
 	
 		#if defined USE_SERIAL_LOGGING
-			Serial_SendData((char*)STORAGE_GETSTRING_BUFFER, the_len);
+			Serial_SendData((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#else
-			write(global_log_file_handle, (char*)STORAGE_GETSTRING_BUFFER, the_len);
+			General_LogAppend((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#endif
 	}	
 #endif
 
-#ifdef LOG_LEVEL_4
+#if defined LOG_LEVEL_4 && !defined USE_BINARY_LOGGING
 	void General_DebugOut(const char* format, ...)
 	{
 		va_list		args;
@@ -1033,18 +1202,18 @@ void General_LogError(const char* format, ...)
 		va_end(args);
 		
 		//fprintf(global_log_file, "%s %s\n", kDebugFlag[LogDebug], debug_buffer);
-		sprintf((char*)STORAGE_GETSTRING_BUFFER, "%s %s\n", kDebugFlag[LogDebug], debug_buffer);
-		the_len = strlen((char*)STORAGE_GETSTRING_BUFFER);
+		sprintf((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), "%s %s\n", kDebugFlag[LogDebug], debug_buffer);
+		the_len = strlen((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER));
 	
 		#if defined USE_SERIAL_LOGGING
-			Serial_SendData((char*)STORAGE_GETSTRING_BUFFER, the_len);
+			Serial_SendData((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#else
-			write(global_log_file_handle, (char*)STORAGE_GETSTRING_BUFFER, the_len);
+			General_LogAppend((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#endif
 	}
 #endif
 
-#ifdef LOG_LEVEL_5
+#if defined LOG_LEVEL_5 && !defined USE_BINARY_LOGGING
 	void General_LogAlloc(const char* format, ...)
 	{
 		va_list		args;
@@ -1055,13 +1224,13 @@ void General_LogError(const char* format, ...)
 		va_end(args);
 		
 		//fprintf(global_log_file, "%s %s\n", kDebugFlag[LogAlloc], debug_buffer);
-		sprintf((char*)STORAGE_GETSTRING_BUFFER, "%s %s\n", kDebugFlag[LogAlloc], debug_buffer);
-		the_len = strlen((char*)STORAGE_GETSTRING_BUFFER);
+		sprintf((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), "%s %s\n", kDebugFlag[LogAlloc], debug_buffer);
+		the_len = strlen((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER));
 	
 		#if defined USE_SERIAL_LOGGING
-			Serial_SendData((char*)STORAGE_GETSTRING_BUFFER, the_len);
+			Serial_SendData((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#else
-			write(global_log_file_handle, (char*)STORAGE_GETSTRING_BUFFER, the_len);
+			General_LogAppend((char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER), the_len);
 		#endif
 	}
 #endif
@@ -1084,17 +1253,19 @@ bool General_LogInitialize(void)
 	#else
 		const char*		the_file_path = "0:fmanager_log.txt";
 	
+		// LOGIC:
+		//   the open finishes a few frames from now. lines logged until then wait in the buffer.
 		//global_log_file = fopen( the_file_path, "w");
-		global_log_file_handle = open(the_file_path, O_WRONLY);
+		global_log_file_handle = FileIO_Open(the_file_path, true);
 		
-		if (global_log_file_handle < 1)
+		if (global_log_file_handle == FILEIO_INVALID_HANDLE || FileIO_GetState(global_log_file_handle) == FILEIO_FAILED)
 		//if (global_log_file == NULL)
 		{
 			printf("General_LogInitialize: log file could not be opened! \n");
 			return false;
 		}
 		
-		write(global_log_file_handle, "started log file", 16);
+		General_LogAppend("started log file\n", 17);
 	#endif
 	
 	return true;
@@ -1105,13 +1276,64 @@ void General_LogCleanUp(void)
 {
 	#if defined USE_SERIAL_LOGGING
 	#else
-		if (global_log_file_handle > 0)
+		if (global_log_file_handle != FILEIO_INVALID_HANDLE)
 		//if (global_log_file != NULL)
 		{
-			close(global_log_file_handle);
+			// whatever is still buffered goes if the file is free now. the close waits on any write still going.
+			General_LogFlush();
+			FileIO_Release(global_log_file_handle);
+			global_log_file_handle = FILEIO_INVALID_HANDLE;
 		}
 	#endif
 }
 
+
+#ifndef USE_SERIAL_LOGGING
+
+// add a log line to the buffer the next General_LogFlush() writes out
+static void General_LogAppend(const char* the_text, uint16_t the_len)
+{
+	if (global_log_fill_len + the_len > GENERAL_LOG_BUFFER_LEN)
+	{
+		++global_log_lines_dropped;
+		return;
+	}
+	
+	memcpy(&global_log_buffer[global_log_fill_index][global_log_fill_len], the_text, the_len);
+	global_log_fill_len += the_len;
+}
+
+
+// start writing out the lines logged since the last flush, if the log file isn't still busy with the ones before.
+// call once per frame (LOG_FLUSH()).
+void General_LogFlush(void)
+{
+	if (global_log_fill_len == 0 || FileIO_GetState(global_log_file_handle) != FILEIO_READY)
+	{
+		return;
+	}
+	
+	if (global_log_lines_dropped > 0)
+	{
+		// say so in the next buffer, which starts empty
+		if (FileIO_Write(global_log_file_handle, global_log_buffer[global_log_fill_index], global_log_fill_len) == true)
+		{
+			global_log_fill_index ^= 1;
+			global_log_fill_len = sprintf(global_log_buffer[global_log_fill_index], "%s %u lines dropped\n", kDebugFlag[LogWarning], global_log_lines_dropped);
+			global_log_lines_dropped = 0;
+		}
+		
+		return;
+	}
+	
+	if (FileIO_Write(global_log_file_handle, global_log_buffer[global_log_fill_index], global_log_fill_len) == true)
+	{
+		global_log_fill_index ^= 1;
+		global_log_fill_len = 0;
+	}
+}
+
+#endif
+
 #endif
 
@@ -36,6 +36,9 @@
 
 // project includes
 //#include "text.h"
+#ifdef USE_BINARY_LOGGING
+	#include "log_sites.h"	// made by tools/log_table.py for this build: a LOG_SITE_<file ID>_<line> macro per log call
+#endif
 
 // C includes
 #include <stdint.h>
@@ -61,31 +64,116 @@
 #define GEN_NO_STRLEN_CAP		-1		//!< for the xxx_DrawString function's max_chars parameter, the value that corresponds to 'draw the entire string if it fits, do not cap it at n characters' 
 #define WORD_WRAP_MAX_LEN		192	//!< For the xxx_DrawStringInBox function, the strnlen char limit. 40*25. 
 
+// LOGIC:
+//   with USE_BINARY_LOGGING, a log call doesn't format anything. it queues a LOG_RECORD_LEN byte record: which file and
+//   line it came from (together, the message ID) and the raw argument words. Serial_Drain() sends it later. the format strings stay behind in a
+//   table tools/log_table.py makes at build time, and tools/log_decode.py puts the text back together on the host.
+//   every source file that logs says which file it is with "#define LOG_FILE_ID  LOG_FILE_xxx" (list below).
+//   LOG_RECORD() hands the call's arguments to the LOG_SITE_ macro log_table.py made for that file ID and line. it passes on
+//   only the argument words, so neither the format nor __func__ is compiled in. the 2-step paste gets both expanded first.
+#if defined USE_BINARY_LOGGING
+	#if !defined USE_SERIAL_LOGGING
+		#error "USE_BINARY_LOGGING sends its records over serial: define USE_SERIAL_LOGGING too"
+	#endif
+	#ifdef HOST_BUILD
+		#error "USE_BINARY_LOGGING is F256 only: host builds have no UART"
+	#endif
+	#define LOG_SITE_NAME(the_file_id, the_line)	LOG_SITE_ ## the_file_id ## _ ## the_line
+	#define LOG_SITE(the_file_id, the_line)		LOG_SITE_NAME(the_file_id, the_line)
+	#define LOG_RECORD(x) LOG_SITE(LOG_FILE_ID, __LINE__) x
+#endif
+
 #ifdef LOG_LEVEL_1 
-	#define LOG_ERR(x) General_LogError x
+	#ifdef USE_BINARY_LOGGING
+		#define LOG_ERR(x) LOG_RECORD(x)
+	#else
+		#define LOG_ERR(x) General_LogError x
+	#endif
 #else
 	#define LOG_ERR(x)
 #endif
 #ifdef LOG_LEVEL_2
-	#define LOG_WARN(x) General_LogWarning x
+	#ifdef USE_BINARY_LOGGING
+		#define LOG_WARN(x) LOG_RECORD(x)
+	#else
+		#define LOG_WARN(x) General_LogWarning x
+	#endif
 #else
 	#define LOG_WARN(x)
 #endif
 #ifdef LOG_LEVEL_3
-	#define LOG_INFO(x) General_LogInfo x
+	#ifdef USE_BINARY_LOGGING
+		#define LOG_INFO(x) LOG_RECORD(x)
+	#else
+		#define LOG_INFO(x) General_LogInfo x
+	#endif
 #else
 	#define LOG_INFO(x)
 #endif
 #ifdef LOG_LEVEL_4
-	#define DEBUG_OUT(x) General_DebugOut x
+	#ifdef USE_BINARY_LOGGING
+		#define DEBUG_OUT(x) LOG_RECORD(x)
+	#else
+		#define DEBUG_OUT(x) General_DebugOut x
+	#endif
 #else
 	#define DEBUG_OUT(x)
 #endif
 #ifdef LOG_LEVEL_5
-	#define LOG_ALLOC(x) General_LogAlloc x
+	#ifdef USE_BINARY_LOGGING
+		#define LOG_ALLOC(x) LOG_RECORD(x)
+	#else
+		#define LOG_ALLOC(x) General_LogAlloc x
+	#endif
 #else
 	#define LOG_ALLOC(x)
 #endif
+#if (defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5) && !defined USE_SERIAL_LOGGING
+	#define LOG_FLUSH() General_LogFlush()
+#else
+	#define LOG_FLUSH()
+#endif
+
+// serial port: the UART code is built for text or binary serial logging, and for telemetry (telemetry.h).
+//   binary logs and telemetry both queue whole packets in one TX ring, so they can share the wire.
+#if ((defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5) && defined USE_BINARY_LOGGING) || defined USE_TELEMETRY
+	#define USE_SERIAL_TX_RING
+	#define SERIAL_DRAIN() Serial_Drain()
+#else
+	#define SERIAL_DRAIN()
+#endif
+#if ((defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5) && defined USE_SERIAL_LOGGING) || defined USE_SERIAL_TX_RING
+	#define USE_SERIAL_PORT
+#endif
+
+#define GENERAL_LOG_BUFFER_LEN	256		// each of the 2 buffers log lines wait in for the log file. not used with USE_SERIAL_LOGGING.
+
+// binary log records (USE_BINARY_LOGGING). tools/log_table.py and tools/log_decode.py read these from here.
+#define LOG_RECORD_LEN			16		// sync, file ID, line (2), then LOG_RECORD_MAX_WORDS argument words. all little-endian.
+#define LOG_RECORD_MAX_WORDS	6		// a %l conversion takes 2. arguments past these are dropped.
+#define LOG_RECORD_SYNC			0xA5	// first byte of every record, for the decoder to find its place in a capture
+#define LOG_RECORD_PREFIX		"%s %d: "	// formats starting like this must pass __func__, __LINE__ first. neither is sent.
+#define LOG_RECORD_LAYOUT_LONG	0x0100	// General_LogRecord() layout: low byte is the argument count, this << n is set if argument n is a long
+#define SERIAL_TX_RING_LEN		256		// binary log records and telemetry wait here for the UART. 1 page, so offsets wrap on their own.
+
+// binary log file IDs. 0 is reserved for the "records dropped" record, whose line is the number dropped.
+#define LOG_FILE_DROPPED		0
+#define LOG_FILE_APP			1
+#define LOG_FILE_ASSET_STREAM	2
+#define LOG_FILE_COMM_BUFFER	3
+#define LOG_FILE_FILE_IO		4
+#define LOG_FILE_GENERAL		5
+#define LOG_FILE_KEYBOARD		6
+#define LOG_FILE_LEVEL			7
+#define LOG_FILE_OBJECT			8
+#define LOG_FILE_OVERLAY_STARTUP	9
+#define LOG_FILE_PLAYER			10
+#define LOG_FILE_PRESENT		11
+#define LOG_FILE_REPLAY			12
+#define LOG_FILE_SAVE_STATE		13
+#define LOG_FILE_STRINGS		14
+#define LOG_FILE_SYS			15
+#define LOG_FILE_TEXT			16
 
 
 /*****************************************************************************/
@@ -157,9 +245,7 @@ int32_t General_Round(double the_float);
 
 // **** MISC STRING UTILITIES *****
 
-// return the global string for the passed ID
-// this is just a wrapper around the string, to make it easier to re-use and diff code in different overlays
-char* General_GetString(uint8_t the_string_id);
+// General_GetString(): see strings.h
 
 // //! Convert a string, in place, to lower case
 // //! This overwrites the string with a lower case version of itself.
@@ -311,6 +397,32 @@ void General_LogAlloc(const char* format, ...);
 bool General_LogInitialize(void);
 void General_LogCleanUp(void);
 
+// start writing buffered log lines out to the log file, if it's free. no footprint unless logging to a file: use LOG_FLUSH()
+void General_LogFlush(void);
+
+// binary logging: queue a record for log call the_file_id/the_line, with the arguments the_layout says follow. use the LOG_* macros.
+void General_LogRecord(uint8_t the_file_id, uint16_t the_line, uint16_t the_layout, ...);
+
+// set up the UART for serial comms: 57600 8N1, FIFOs on. only available with USE_SERIAL_PORT
+void Serial_InitUART(void);
+
+// send a byte over the UART serial connection. only available with USE_SERIAL_PORT
+bool Serial_SendByte(uint8_t the_byte);
+
+// send 1-255 bytes to the UART serial connection, waiting on it. only available with USE_SERIAL_PORT
+// returns # of bytes successfully sent (which may be less than number requested, in event of error, etc.)
+uint8_t Serial_SendData(uint8_t* the_buffer, uint16_t buffer_size);
+
+// queue the_len bytes for Serial_Drain() to send. all or nothing: returns false, and queues none, if they don't fit
+// only available with USE_SERIAL_TX_RING
+bool Serial_QueueData(const uint8_t* the_data, uint8_t the_len);
+
+// hand the UART as many queued bytes as it can take without waiting. no footprint unless something queues: use SERIAL_DRAIN()
+void Serial_Drain(void);
+
+// host builds: send what Serial_Drain() would have put out the UART to the_fd instead (-1: nowhere)
+void Serial_SetHostOutput(int the_fd);
+
 
 
 
@@ -0,0 +1,93 @@
+/*
+ * hal.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef HAL_H_
+#define HAL_H_
+
+
+/* about this class: HAL
+ *
+ * Thin hardware abstraction for register, VRAM, and MMU access, so the game logic can build with either cc65 or gcc.
+ *
+ *** backends
+ *
+ * F256 (default): every macro here collapses to the same raw pointer access the code always used. No cost.
+ * host (HOST_BUILD defined, see _build_host.sh): the 6502's 64K CPU space is an array (hal_cpu_space).
+ *   The MMU and IO page switching is emulated by swapping 8K windows in and out of that array, so
+ *   code that computes addresses in CPU space (text VRAM at $C000, sprite registers at $D900, the tilemap
+ *   mapped in at $A000, etc.) works unchanged once the base pointer goes through HAL_CPU_PTR.
+ *   Sys_SwapIOPage, Sys_RestoreIOPage, Sys_DisableIOBank, and the Memory_ bank functions are provided by
+ *   host/hal_host.c instead of sys.c and memory.asm.
+ *
+ *** rules for code that should build on both
+ *
+ * never cast a CPU address straight to a pointer: use HAL_CPU_PTR(addr)
+ * use R8/R16/P8 (f256.h) for registers; they go through HAL_CPU_PTR
+ * use HAL_RANDOM16() instead of reading the VICKY RNG registers directly
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define HAL_CPU_SPACE_SIZE			0x10000		// 64K of 6502 address space
+#define HAL_BANK_SIZE				0x2000		// 8K per MMU slot/bank
+#define HAL_PHYS_RAM_SIZE			0x80000		// 512K of physical RAM (banks 0x00-0x3F)
+#define HAL_NUM_IO_PAGES			4			// VICKY_IO_PAGE_REGISTERS ... VICKY_IO_PAGE_ATTR_MEM
+#define HAL_IO_SLOT					6			// MMU slot that IO pages are mapped over ($C000-$DFFF)
+
+#ifdef HOST_BUILD
+	#define HAL_CPU_PTR(addr)		(&hal_cpu_space[(uint16_t)(addr)])
+	#define HAL_RANDOM16()			Hal_Random16()
+#else
+	#define HAL_CPU_PTR(addr)		((uint8_t*)(addr))
+	#define HAL_RANDOM16()			R16(RANDOM_NUM_GEN_LOW)		// IO page 0 must be mapped in
+#endif
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+	extern uint8_t		hal_cpu_space[HAL_CPU_SPACE_SIZE];
+	extern uint8_t		hal_phys_ram[HAL_PHYS_RAM_SIZE];
+	extern uint8_t		hal_io_page[HAL_NUM_IO_PAGES][HAL_BANK_SIZE];
+#endif
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+	// reset emulated CPU space, physical RAM, IO pages, and MMU LUT to power-on state (LUT 0-7 identity, IO page 0 mapped)
+	void Hal_Initialize(void);
+
+	// make sure every window currently in CPU space has been written back to its physical bank or IO page
+	// call before inspecting hal_phys_ram or hal_io_page directly
+	void Hal_SyncAll(void);
+
+	// load a binary file into physical RAM at the passed 20-bit address. returns the number of bytes loaded, or -1 on error.
+	int32_t Hal_LoadFileToPhys(const char* the_file_path, uint32_t the_phys_addr);
+
+	// return the next number from the emulated VICKY random number generator
+	// seeded from whatever was last written to the RNG seed registers in IO page 0
+	uint16_t Hal_Random16(void);
+#endif
+
+
+#endif /* HAL_H_ */
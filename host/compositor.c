@@ -0,0 +1,500 @@
+/*
+ * compositor.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Host-only software compositor: emulated VICKY state -> RGB frame
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "compositor.h"
+#include "../hal.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "../f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define GFX_WIDTH					COMPOSITOR_WIDTH	// VICKY graphics layers are always 320x240
+#define GFX_HEIGHT					COMPOSITOR_HEIGHT
+#define TEXT_PLANE_SCALE			2		// the text plane is 640x480; 2x2 of it per frame pixel
+
+#define NUM_SPRITES					64
+#define NUM_SPRITE_LAYERS			4
+#define NUM_LAYERS					3
+#define NUM_TILEMAPS				3
+#define NUM_TILESETS				8
+#define SPRITE_SCREEN_OFFSET		32		// sprite x/y of 32,32 is the top left corner of the screen
+
+#define SPRITE_CTRL_ENABLE			0x01
+#define SPRITE_CTRL_LUT_MASK		0x06
+#define SPRITE_CTRL_LUT_SHIFT		1
+#define SPRITE_CTRL_LAYER_MASK		0x18
+#define SPRITE_CTRL_LAYER_SHIFT		3
+#define SPRITE_CTRL_SIZE_MASK		0x60
+#define SPRITE_CTRL_SIZE_SHIFT		5
+
+#define TILE_CTRL_ENABLE			0x01
+#define TILE_CTRL_SIZE_8			0x10	// 8x8 tiles if set, 16x16 if clear
+#define TILE_ENTRY_TILESET_SHIFT	8
+#define TILE_ENTRY_TILESET_MASK		0x07
+#define TILE_ENTRY_LUT_SHIFT		11
+#define TILE_ENTRY_LUT_MASK			0x03
+#define TILESET_SHAPE_SQUARE		0x08	// tiles laid out 256 pixels across instead of in one column
+#define TILESET_SQUARE_WIDTH		256
+
+#define LAYER_SOURCE_TILEMAP		0x04	// layer source values 0-2 are bitmaps, 4-6 are tilemaps 0-2
+#define LAYER_SOURCE_MASK			0x07
+
+#define CLUT_ENTRY_LEN				4		// B, G, R, A
+#define TEXT_LUT_ENTRY_LEN			4		// B, G, R, A
+
+#define IO_OFFSET(addr)				((addr) - 0xC000)		// offset of an IO page address within its 8K page
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint8_t			gfx_frame[GFX_HEIGHT][GFX_WIDTH][COMPOSITOR_BYTES_PER_PIXEL];	// graphics layers, before text and border
+
+static const uint8_t	sprite_sizes[4] = {32, 24, 16, 8};
+
+static const uint16_t	clut_addr[4] = {VICKY_CLUT0, VICKY_CLUT1, VICKY_CLUT2, VICKY_CLUT3};
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// read a byte from one of the emulated IO pages
+static uint8_t Compositor_IO(uint8_t the_page, uint16_t the_addr);
+
+// read a byte from VRAM (physical RAM on the F256)
+static uint8_t Compositor_VRAM(uint32_t the_phys_addr);
+
+// plot a graphics-layer pixel using the passed CLUT. color 0 is transparent and is skipped.
+static void Compositor_PlotIndexed(uint16_t x, uint16_t y, uint8_t the_lut, uint8_t the_color);
+
+// draw every enabled sprite assigned to the passed sprite layer
+static void Compositor_DrawSpriteLayer(uint8_t the_layer);
+
+// draw one tilemap
+static void Compositor_DrawTilemap(uint8_t the_tilemap);
+
+// draw the text layer over the graphics
+static void Compositor_DrawText(uint8_t* the_frame, uint8_t the_master_ctrl_l, uint8_t the_master_ctrl_h);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// read a byte from one of the emulated IO pages
+static uint8_t Compositor_IO(uint8_t the_page, uint16_t the_addr)
+{
+	return hal_io_page[the_page][IO_OFFSET(the_addr)];
+}
+
+
+// read a byte from VRAM (physical RAM on the F256)
+static uint8_t Compositor_VRAM(uint32_t the_phys_addr)
+{
+	return hal_phys_ram[the_phys_addr & (HAL_PHYS_RAM_SIZE - 1)];
+}
+
+
+// plot a graphics-layer pixel using the passed CLUT. color 0 is transparent and is skipped.
+static void Compositor_PlotIndexed(uint16_t x, uint16_t y, uint8_t the_lut, uint8_t the_color)
+{
+	uint16_t	the_entry;
+
+	if (the_color == 0 || x >= GFX_WIDTH || y >= GFX_HEIGHT)
+	{
+		return;
+	}
+
+	the_entry = clut_addr[the_lut] + (uint16_t)the_color * CLUT_ENTRY_LEN;
+
+	gfx_frame[y][x][0] = Compositor_IO(VICKY_IO_PAGE_FONT_AND_LUTS, the_entry + 2);
+	gfx_frame[y][x][1] = Compositor_IO(VICKY_IO_PAGE_FONT_AND_LUTS, the_entry + 1);
+	gfx_frame[y][x][2] = Compositor_IO(VICKY_IO_PAGE_FONT_AND_LUTS, the_entry + 0);
+}
+
+
+// draw every enabled sprite assigned to the passed sprite layer
+static void Compositor_DrawSpriteLayer(uint8_t the_layer)
+{
+	int8_t		i;
+	uint16_t	the_reg;
+	uint8_t		the_ctrl;
+	uint8_t		the_size;
+	uint8_t		the_lut;
+	uint32_t	the_addr;
+	int16_t		the_x;
+	int16_t		the_y;
+	uint8_t		px;
+	uint8_t		py;
+
+	// LOGIC: lower numbered sprites are in front, so paint from the highest number down
+	for (i = NUM_SPRITES - 1; i >= 0; i--)
+	{
+		the_reg = SPRITE0_CTRL + (uint16_t)i * SPRITE_REG_LEN;
+		the_ctrl = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg);
+
+		if ( (the_ctrl & SPRITE_CTRL_ENABLE) == 0 || ((the_ctrl & SPRITE_CTRL_LAYER_MASK) >> SPRITE_CTRL_LAYER_SHIFT) != the_layer)
+		{
+			continue;
+		}
+
+		the_size = sprite_sizes[(the_ctrl & SPRITE_CTRL_SIZE_MASK) >> SPRITE_CTRL_SIZE_SHIFT];
+		the_lut = (the_ctrl & SPRITE_CTRL_LUT_MASK) >> SPRITE_CTRL_LUT_SHIFT;
+		the_addr = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 1) | ((uint32_t)Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 2) << 8) | ((uint32_t)Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 3) << 16);
+		the_x = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 4) | (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 5) << 8)) - SPRITE_SCREEN_OFFSET;
+		the_y = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 6) | (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 7) << 8)) - SPRITE_SCREEN_OFFSET;
+
+		for (py = 0; py < the_size; py++)
+		{
+			if (the_y + py < 0)
+			{
+				continue;
+			}
+
+			for (px = 0; px < the_size; px++)
+			{
+				if (the_x + px < 0)
+				{
+					continue;
+				}
+
+				Compositor_PlotIndexed(the_x + px, the_y + py, the_lut, Compositor_VRAM(the_addr + (uint16_t)py * the_size + px));
+			}
+		}
+	}
+}
+
+
+// draw one tilemap
+static void Compositor_DrawTilemap(uint8_t the_tilemap)
+{
+	uint16_t	the_reg;
+	uint8_t		the_ctrl;
+	uint8_t		the_tile_size;
+	uint32_t	the_map_addr;
+	uint16_t	the_map_cols;
+	uint16_t	the_map_rows;
+	uint16_t	the_scroll_x;
+	uint16_t	the_scroll_y;
+	uint32_t	the_tileset_addr[NUM_TILESETS];
+	bool		the_tileset_is_square[NUM_TILESETS];
+	uint16_t	x;
+	uint16_t	y;
+	uint32_t	map_x;
+	uint32_t	map_y;
+	uint16_t	the_entry;
+	uint8_t		the_tileset;
+	uint8_t		the_tile;
+	uint32_t	the_pixel_addr;
+	uint8_t		i;
+
+	the_reg = TILE0_CTRL + (uint16_t)the_tilemap * TILE_REG_LEN;
+	the_ctrl = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg);
+
+	if ( (the_ctrl & TILE_CTRL_ENABLE) == 0)
+	{
+		return;
+	}
+
+	the_tile_size = (the_ctrl & TILE_CTRL_SIZE_8) ? 8 : 16;
+	the_map_addr = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_ADDR_LO) | ((uint32_t)Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_ADDR_MED) << 8) | ((uint32_t)Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_ADDR_HI) << 16);
+	the_map_cols = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_MAP_SIZE_X) | (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_MAP_SIZE_X + 1) << 8)) & 0x3FF;
+	the_map_rows = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_MAP_SIZE_Y) | (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_MAP_SIZE_Y + 1) << 8)) & 0x3FF;
+	the_scroll_x = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_SCROLL_X_LO) | (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_SCROLL_X_HI) << 8)) & 0x3FFF;
+	the_scroll_y = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_SCROLL_Y_LO) | (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + TILE_CTRL_OFFSET_SCROLL_Y_HI) << 8)) & 0x3FFF;
+
+	if (the_map_cols == 0 || the_map_rows == 0)
+	{
+		return;
+	}
+
+	for (i = 0; i < NUM_TILESETS; i++)
+	{
+		the_reg = TILESET0_ADDR_LO + (uint16_t)i * TILESET_REG_LEN;
+		the_tileset_addr[i] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg) | ((uint32_t)Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 1) << 8) | ((uint32_t)Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 2) << 16);
+		the_tileset_is_square[i] = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_reg + 3) & TILESET_SHAPE_SQUARE) != 0;
+	}
+
+	for (y = 0; y < GFX_HEIGHT; y++)
+	{
+		map_y = y + the_scroll_y;
+
+		if (map_y >= (uint32_t)the_map_rows * the_tile_size)
+		{
+			continue;
+		}
+
+		for (x = 0; x < GFX_WIDTH; x++)
+		{
+			map_x = x + the_scroll_x;
+
+			if (map_x >= (uint32_t)the_map_cols * the_tile_size)
+			{
+				continue;
+			}
+
+			the_pixel_addr = the_map_addr + ((map_y / the_tile_size) * the_map_cols + (map_x / the_tile_size)) * 2;
+			the_entry = Compositor_VRAM(the_pixel_addr) | (Compositor_VRAM(the_pixel_addr + 1) << 8);
+			the_tile = the_entry & 0xFF;
+			the_tileset = (the_entry >> TILE_ENTRY_TILESET_SHIFT) & TILE_ENTRY_TILESET_MASK;
+
+			if (the_tileset_is_square[the_tileset])
+			{
+				the_pixel_addr = the_tileset_addr[the_tileset] + ((uint32_t)(the_tile / (TILESET_SQUARE_WIDTH / the_tile_size)) * the_tile_size + map_y % the_tile_size) * TILESET_SQUARE_WIDTH + (the_tile % (TILESET_SQUARE_WIDTH / the_tile_size)) * the_tile_size + map_x % the_tile_size;
+			}
+			else
+			{
+				the_pixel_addr = the_tileset_addr[the_tileset] + ((uint32_t)the_tile * the_tile_size + map_y % the_tile_size) * the_tile_size + map_x % the_tile_size;
+			}
+
+			Compositor_PlotIndexed(x, y, (the_entry >> TILE_ENTRY_LUT_SHIFT) & TILE_ENTRY_LUT_MASK, Compositor_VRAM(the_pixel_addr));
+		}
+	}
+}
+
+
+// draw the text layer over the graphics
+// LOGIC: text is laid out on the 640x480 plane. with the doublers on (as this game runs), each glyph pixel is 2x2 there,
+//   so sampling the top left of each 2x2 block is exact. in 80 column mode, every other glyph pixel is dropped.
+static void Compositor_DrawText(uint8_t* the_frame, uint8_t the_master_ctrl_l, uint8_t the_master_ctrl_h)
+{
+	bool		is_overlay;
+	bool		show_back_color;
+	uint8_t		the_scale_x;
+	uint8_t		the_scale_y;
+	uint16_t	the_font;
+	uint8_t		the_num_cols;
+	uint16_t	x;
+	uint16_t	y;
+	uint16_t	tx;
+	uint16_t	ty;
+	uint16_t	the_cell;
+	uint8_t		the_char;
+	uint8_t		the_attr;
+	uint8_t		the_glyph_row;
+	uint16_t	the_lut_entry;
+	uint8_t*	the_pixel;
+
+	is_overlay = (the_master_ctrl_l & GRAPHICS_MODE_TEXT_OVER) != 0;
+	show_back_color = (is_overlay == false) || (the_master_ctrl_h & VICKY_RES_FON_OVLY);
+	the_scale_x = (the_master_ctrl_h & VICKY_RES_X_DOUBLER_FLAG) ? 2 : 1;
+	the_scale_y = (the_master_ctrl_h & VICKY_RES_Y_DOUBLER_FLAG) ? 2 : 1;
+	the_font = (the_master_ctrl_h & VICKY_RES_FON_SET) ? FONT_MEMORY_BANK1 : FONT_MEMORY_BANK0;
+	the_num_cols = TEXT_COL_COUNT_FOR_PLOTTING / the_scale_x;	// 40 across when doubled, and char/attr memory is packed to match
+
+	for (y = 0; y < COMPOSITOR_HEIGHT; y++)
+	{
+		for (x = 0; x < COMPOSITOR_WIDTH; x++)
+		{
+			tx = x * TEXT_PLANE_SCALE;
+			ty = y * TEXT_PLANE_SCALE;
+			the_cell = (ty / (TEXT_FONT_HEIGHT * the_scale_y)) * the_num_cols + tx / (TEXT_FONT_WIDTH * the_scale_x);
+			the_char = Compositor_IO(VICKY_IO_PAGE_CHAR_MEM, 0xC000 + the_cell);
+			the_attr = Compositor_IO(VICKY_IO_PAGE_ATTR_MEM, 0xC000 + the_cell);
+			the_glyph_row = Compositor_IO(VICKY_IO_PAGE_FONT_AND_LUTS, the_font + (uint16_t)the_char * TEXT_FONT_HEIGHT + (ty / the_scale_y) % TEXT_FONT_HEIGHT);
+
+			if (the_glyph_row & (0x80 >> ((tx / the_scale_x) % TEXT_FONT_WIDTH)))
+			{
+				the_lut_entry = TEXT_FORE_LUT + (the_attr >> 4) * TEXT_LUT_ENTRY_LEN;
+			}
+			else if (show_back_color && (is_overlay == false || (the_attr & 0x0F) != 0))
+			{
+				the_lut_entry = TEXT_BACK_LUT + (the_attr & 0x0F) * TEXT_LUT_ENTRY_LEN;
+			}
+			else
+			{
+				continue;
+			}
+
+			the_pixel = &the_frame[((uint32_t)y * COMPOSITOR_WIDTH + x) * COMPOSITOR_BYTES_PER_PIXEL];
+			the_pixel[0] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_lut_entry + 2);
+			the_pixel[1] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_lut_entry + 1);
+			the_pixel[2] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, the_lut_entry + 0);
+		}
+	}
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// composite the current emulated VICKY state into the_frame (COMPOSITOR_FRAME_SIZE bytes, RGB, top row first)
+void Compositor_Render(uint8_t* the_frame)
+{
+	uint8_t		the_master_ctrl_l;
+	uint8_t		the_master_ctrl_h;
+	uint8_t		the_layer_source[NUM_LAYERS];
+	bool		show_graphics;
+	int8_t		i;
+	uint16_t	x;
+	uint16_t	y;
+	uint8_t		the_border_x;
+	uint8_t		the_border_y;
+	uint8_t*	the_pixel;
+
+	// everything mapped into CPU space has to be back in its page before it can be read from there
+	Hal_SyncAll();
+
+	the_master_ctrl_l = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_MASTER_CTRL_REG_L);
+	the_master_ctrl_h = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_MASTER_CTRL_REG_H);
+	the_layer_source[0] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_LAYER_CTRL_1) & LAYER_SOURCE_MASK;
+	the_layer_source[1] = (Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_LAYER_CTRL_1) >> 4) & LAYER_SOURCE_MASK;
+	the_layer_source[2] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_LAYER_CTRL_2) & LAYER_SOURCE_MASK;
+
+	// background
+	for (y = 0; y < GFX_HEIGHT; y++)
+	{
+		for (x = 0; x < GFX_WIDTH; x++)
+		{
+			gfx_frame[y][x][0] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BACKGROUND_COLOR_R);
+			gfx_frame[y][x][1] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BACKGROUND_COLOR_G);
+			gfx_frame[y][x][2] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BACKGROUND_COLOR_B);
+		}
+	}
+
+	// LOGIC: in text mode without overlay, VICKY shows only the text layer
+	show_graphics = (the_master_ctrl_l & GRAPHICS_MODE_GRAPHICS) && ( (the_master_ctrl_l & GRAPHICS_MODE_TEXT) == 0 || (the_master_ctrl_l & GRAPHICS_MODE_TEXT_OVER));
+
+	if (show_graphics)
+	{
+		// back to front: sprite layer 3, layer 2, sprite layer 2, layer 1, sprite layer 1, layer 0, sprite layer 0
+		for (i = NUM_SPRITE_LAYERS - 1; i >= 0; i--)
+		{
+			if (the_master_ctrl_l & GRAPHICS_MODE_EN_SPRITE)
+			{
+				Compositor_DrawSpriteLayer(i);
+			}
+
+			if (i > 0 && (the_master_ctrl_l & GRAPHICS_MODE_EN_TILE) && (the_layer_source[i - 1] & LAYER_SOURCE_TILEMAP) && (the_layer_source[i - 1] & 0x03) < NUM_TILEMAPS)
+			{
+				Compositor_DrawTilemap(the_layer_source[i - 1] & 0x03);
+			}
+		}
+	}
+
+	memcpy(the_frame, gfx_frame, COMPOSITOR_FRAME_SIZE);
+
+	if (the_master_ctrl_l & GRAPHICS_MODE_TEXT)
+	{
+		Compositor_DrawText(the_frame, the_master_ctrl_l, the_master_ctrl_h);
+	}
+
+	// border sits on top of everything
+	if (Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BORDER_CTRL_REG) & 0x01)
+	{
+		the_border_x = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BORDER_X_SIZE);
+		the_border_y = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BORDER_Y_SIZE);
+
+		for (y = 0; y < COMPOSITOR_HEIGHT; y++)
+		{
+			for (x = 0; x < COMPOSITOR_WIDTH; x++)
+			{
+				if (x >= the_border_x && x < COMPOSITOR_WIDTH - the_border_x && y >= the_border_y && y < COMPOSITOR_HEIGHT - the_border_y)
+				{
+					continue;
+				}
+
+				the_pixel = &the_frame[((uint32_t)y * COMPOSITOR_WIDTH + x) * COMPOSITOR_BYTES_PER_PIXEL];
+				the_pixel[0] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BORDER_COLOR_R);
+				the_pixel[1] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BORDER_COLOR_G);
+				the_pixel[2] = Compositor_IO(VICKY_IO_PAGE_REGISTERS, VICKY_BORDER_COLOR_B);
+			}
+		}
+	}
+}
+
+
+// write a frame as a binary PPM (P6). returns false on any error.
+bool Compositor_WritePPM(const char* the_file_path, const uint8_t* the_frame)
+{
+	FILE*		the_file;
+	bool		the_result;
+
+	if ( (the_file = fopen(the_file_path, "wb")) == NULL)
+	{
+		return false;
+	}
+
+	fprintf(the_file, "P6\n%d %d\n255\n", COMPOSITOR_WIDTH, COMPOSITOR_HEIGHT);
+	the_result = (fwrite(the_frame, 1, COMPOSITOR_FRAME_SIZE, the_file) == COMPOSITOR_FRAME_SIZE);
+	fclose(the_file);
+
+	return the_result;
+}
+
+
+// read a binary PPM written by Compositor_WritePPM() into the_frame. returns false if missing or not the right size.
+bool Compositor_ReadPPM(const char* the_file_path, uint8_t* the_frame)
+{
+	FILE*		the_file;
+	int			the_width;
+	int			the_height;
+	int			the_max;
+	bool		the_result;
+
+	if ( (the_file = fopen(the_file_path, "rb")) == NULL)
+	{
+		return false;
+	}
+
+	the_result = (fscanf(the_file, "P6 %d %d %d", &the_width, &the_height, &the_max) == 3 && fgetc(the_file) != EOF);
+	the_result = the_result && the_width == COMPOSITOR_WIDTH && the_height == COMPOSITOR_HEIGHT && the_max == 255;
+	the_result = the_result && (fread(the_frame, 1, COMPOSITOR_FRAME_SIZE, the_file) == COMPOSITOR_FRAME_SIZE);
+	fclose(the_file);
+
+	return the_result;
+}
+
+
+// compare two frames. returns the number of pixels that differ.
+// if the_diff_frame is not NULL, it gets a copy of the_frame, dimmed, with differing pixels in bright red.
+uint32_t Compositor_Diff(const uint8_t* the_frame, const uint8_t* the_golden_frame, uint8_t* the_diff_frame)
+{
+	uint32_t	i;
+	uint32_t	num_different = 0;
+	bool		is_different;
+
+	for (i = 0; i < COMPOSITOR_FRAME_SIZE; i += COMPOSITOR_BYTES_PER_PIXEL)
+	{
+		is_different = (memcmp(&the_frame[i], &the_golden_frame[i], COMPOSITOR_BYTES_PER_PIXEL) != 0);
+		num_different += is_different;
+
+		if (the_diff_frame != NULL)
+		{
+			the_diff_frame[i + 0] = is_different ? 0xFF : the_frame[i + 0] / 4;
+			the_diff_frame[i + 1] = is_different ? 0x00 : the_frame[i + 1] / 4;
+			the_diff_frame[i + 2] = is_different ? 0x00 : the_frame[i + 2] / 4;
+		}
+	}
+
+	return num_different;
+}
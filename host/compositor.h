@@ -0,0 +1,76 @@
+/*
+ * compositor.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef COMPOSITOR_H_
+#define COMPOSITOR_H_
+
+
+/* about this class: Compositor
+ *
+ * Host-only software stand-in for VICKY's video output. Reads the emulated register pages and physical RAM
+ *   (see hal.h) and composites background, tilemaps, sprites, and text into one RGB frame.
+ *   Used by the host runner to write frames and compare them against stored goldens, so changes to the
+ *   render path (sprite shadowing, DMA, dirty-tile upload, etc.) can be checked pixel for pixel.
+ *
+ *** what it models
+ *
+ * layer order, front to back: text (overlay), sprite layer 0, layer 0, sprite layer 1, layer 1, sprite layer 2, layer 2, sprite layer 3, background
+ * layers 0-2 as assigned by VICKY_LAYER_CTRL_1/2; tilemaps 0-2 (8x8 or 16x16, with scroll). bitmaps are not modeled.
+ * 64 sprites, 8/16/24/32 px, with per-sprite CLUT and layer. lower numbered sprites are in front.
+ * 80x60 text (or 40/30 with the doublers), font set 0/1, text fore/back LUTs, overlay and FON_OVLY
+ * border color and size
+ *
+ *** what it does not model
+ *
+ * gamma, the text cursor, bitmaps, mid-frame register changes. colors are the raw CLUT bytes.
+ *
+ *** frame size
+ *
+ * 320x240, the size of VICKY's graphics layers. The text plane is 640x480 underneath, but this game runs it with the
+ *   doublers on (40x30), so every glyph pixel still lands on exactly one frame pixel. 80 column text would be sampled at half resolution.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define COMPOSITOR_WIDTH			320
+#define COMPOSITOR_HEIGHT			240
+#define COMPOSITOR_BYTES_PER_PIXEL	3	// R, G, B
+#define COMPOSITOR_FRAME_SIZE		(COMPOSITOR_WIDTH * COMPOSITOR_HEIGHT * COMPOSITOR_BYTES_PER_PIXEL)
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// composite the current emulated VICKY state into the_frame (COMPOSITOR_FRAME_SIZE bytes, RGB, top row first)
+void Compositor_Render(uint8_t* the_frame);
+
+// write a frame as a binary PPM (P6). returns false on any error.
+bool Compositor_WritePPM(const char* the_file_path, const uint8_t* the_frame);
+
+// read a binary PPM written by Compositor_WritePPM() into the_frame. returns false if missing or not the right size.
+bool Compositor_ReadPPM(const char* the_file_path, uint8_t* the_frame);
+
+// compare two frames. returns the number of pixels that differ.
+// if the_diff_frame is not NULL, it gets a copy of the_frame, dimmed, with differing pixels in bright red.
+uint32_t Compositor_Diff(const uint8_t* the_frame, const uint8_t* the_golden_frame, uint8_t* the_diff_frame);
+
+
+#endif /* COMPOSITOR_H_ */
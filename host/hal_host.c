@@ -0,0 +1,316 @@
+/*
+ * hal_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Host (gcc) backend for hal.h: emulated CPU space, MMU, and VICKY IO pages
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "../hal.h"
+#include "../app.h"
+#include "../general.h"
+#include "../memory.h"
+#include "../object.h"
+#include "../sys.h"
+#include "../telemetry.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// F256 includes
+#include "../f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define HAL_NUM_SLOTS				8
+#define HAL_IO_CTRL_DISABLE			0x04	// bit 2 of MMU_IO_CTRL
+#define HAL_IO_CTRL_PAGE_MASK		0x03
+#define HAL_WINDOW_IS_RAM			0xFF	// hal_io_window value when RAM is showing at $C000-$DFFF
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint8_t		hal_lut[HAL_NUM_SLOTS];		// physical bank mapped into each CPU slot
+static uint8_t		hal_io_window;				// IO page currently showing in slot 6, or HAL_WINDOW_IS_RAM
+static uint16_t		hal_rng_state;				// emulated VICKY RNG
+static uint16_t		hal_rng_seed;				// seed the current RNG sequence was started from
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+uint8_t				hal_cpu_space[HAL_CPU_SPACE_SIZE];
+uint8_t				hal_phys_ram[HAL_PHYS_RAM_SIZE];
+uint8_t				hal_io_page[HAL_NUM_IO_PAGES][HAL_BANK_SIZE];
+
+// on F256 these are zero page variables from memory.asm. zp_layout.h has the list.
+#define HAL_DEFINE_ZP_VAR(the_type, the_name)	the_type the_name;
+ZP_LAYOUT_VARS(HAL_DEFINE_ZP_VAR)
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// return the backing store for whatever is currently mapped into the passed CPU slot
+static uint8_t* Hal_GetSlotBacking(uint8_t the_slot);
+
+// copy the CPU slot back to its backing store
+static void Hal_SaveSlot(uint8_t the_slot);
+
+// copy the backing store into the CPU slot
+static void Hal_LoadSlot(uint8_t the_slot);
+
+// apply a new MMU_IO_CTRL value, swapping the $C000-$DFFF window if the visible page changes
+static void Hal_SetIOCtrl(uint8_t the_new_value);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// return the backing store for whatever is currently mapped into the passed CPU slot
+static uint8_t* Hal_GetSlotBacking(uint8_t the_slot)
+{
+	if (the_slot == HAL_IO_SLOT && hal_io_window != HAL_WINDOW_IS_RAM)
+	{
+		return hal_io_page[hal_io_window];
+	}
+
+	return &hal_phys_ram[(uint32_t)hal_lut[the_slot] * HAL_BANK_SIZE];
+}
+
+
+// copy the CPU slot back to its backing store
+static void Hal_SaveSlot(uint8_t the_slot)
+{
+	memcpy(Hal_GetSlotBacking(the_slot), &hal_cpu_space[(uint16_t)the_slot * HAL_BANK_SIZE], HAL_BANK_SIZE);
+}
+
+
+// copy the backing store into the CPU slot
+static void Hal_LoadSlot(uint8_t the_slot)
+{
+	memcpy(&hal_cpu_space[(uint16_t)the_slot * HAL_BANK_SIZE], Hal_GetSlotBacking(the_slot), HAL_BANK_SIZE);
+}
+
+
+// apply a new MMU_IO_CTRL value, swapping the $C000-$DFFF window if the visible page changes
+static void Hal_SetIOCtrl(uint8_t the_new_value)
+{
+	uint8_t		the_new_window;
+
+	the_new_window = (the_new_value & HAL_IO_CTRL_DISABLE) ? HAL_WINDOW_IS_RAM : (the_new_value & HAL_IO_CTRL_PAGE_MASK);
+
+	hal_cpu_space[MMU_IO_CTRL] = the_new_value;
+
+	if (the_new_window == hal_io_window)
+	{
+		return;
+	}
+
+	Hal_SaveSlot(HAL_IO_SLOT);
+	hal_io_window = the_new_window;
+	Hal_LoadSlot(HAL_IO_SLOT);
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// reset emulated CPU space, physical RAM, IO pages, and MMU LUT to power-on state (LUT 0-7 identity, IO page 0 mapped)
+void Hal_Initialize(void)
+{
+	uint8_t		i;
+
+	memset(hal_cpu_space, 0, sizeof(hal_cpu_space));
+	memset(hal_phys_ram, 0, sizeof(hal_phys_ram));
+	memset(hal_io_page, 0, sizeof(hal_io_page));
+
+	for (i = 0; i < HAL_NUM_SLOTS; i++)
+	{
+		hal_lut[i] = i;
+	}
+
+	// the few registers the startup code checks before it writes anything
+	hal_io_page[VICKY_IO_PAGE_REGISTERS][MACHINE_ID_REGISTER - 0xC000] = MACHINE_F256K;
+
+	hal_io_window = VICKY_IO_PAGE_REGISTERS;
+	hal_cpu_space[MMU_IO_CTRL] = VICKY_IO_PAGE_REGISTERS;
+	Hal_LoadSlot(HAL_IO_SLOT);
+
+	hal_rng_state = 1;
+	hal_rng_seed = 0;
+}
+
+
+// make sure every window currently in CPU space has been written back to its physical bank or IO page
+// call before inspecting hal_phys_ram or hal_io_page directly
+void Hal_SyncAll(void)
+{
+	uint8_t		i;
+
+	for (i = 0; i < HAL_NUM_SLOTS; i++)
+	{
+		Hal_SaveSlot(i);
+	}
+}
+
+
+// load a binary file into physical RAM at the passed 20-bit address. returns the number of bytes loaded, or -1 on error.
+int32_t Hal_LoadFileToPhys(const char* the_file_path, uint32_t the_phys_addr)
+{
+	FILE*		the_file;
+	size_t		bytes_read;
+	uint8_t		i;
+
+	if (the_phys_addr >= HAL_PHYS_RAM_SIZE)
+	{
+		return -1;
+	}
+
+	if ( (the_file = fopen(the_file_path, "rb")) == NULL)
+	{
+		return -1;
+	}
+
+	Hal_SyncAll();
+
+	bytes_read = fread(&hal_phys_ram[the_phys_addr], 1, HAL_PHYS_RAM_SIZE - the_phys_addr, the_file);
+	fclose(the_file);
+
+	// refresh any slot that is currently showing the bank(s) just loaded
+	for (i = 0; i < HAL_NUM_SLOTS; i++)
+	{
+		if (i != HAL_IO_SLOT || hal_io_window == HAL_WINDOW_IS_RAM)
+		{
+			Hal_LoadSlot(i);
+		}
+	}
+
+	return (int32_t)bytes_read;
+}
+
+
+// return the next number from the emulated VICKY random number generator
+// seeded from whatever was last written to the RNG seed registers in IO page 0
+uint16_t Hal_Random16(void)
+{
+	uint8_t*	the_rng_regs;
+	uint16_t	the_seed;
+
+	// LOGIC: writes to the seed registers can't be trapped here, so pick the seed up lazily:
+	//   whenever the seed bytes differ from the ones the current sequence started from, restart from them.
+	the_rng_regs = (hal_io_window == VICKY_IO_PAGE_REGISTERS) ? &hal_cpu_space[RANDOM_NUM_GEN_LOW] : &hal_io_page[VICKY_IO_PAGE_REGISTERS][RANDOM_NUM_GEN_LOW - 0xC000];
+	the_seed = the_rng_regs[0] | ((uint16_t)the_rng_regs[1] << 8);
+
+	if (the_seed != hal_rng_seed)
+	{
+		hal_rng_seed = the_seed;
+		hal_rng_state = the_seed;
+	}
+
+	if (hal_rng_state == 0)
+	{
+		hal_rng_state = 1;
+	}
+
+	// 16-bit xorshift. not VICKY's LFSR, so a host run is only comparable with another host run.
+	hal_rng_state ^= hal_rng_state << 7;
+	hal_rng_state ^= hal_rng_state >> 9;
+	hal_rng_state ^= hal_rng_state << 8;
+
+	return hal_rng_state;
+}
+
+
+// **** sys.c replacements *****
+
+// disable the I/O bank to allow RAM to be mapped into it
+void Sys_DisableIOBank(void)
+{
+	zp_old_io_page = hal_cpu_space[MMU_IO_CTRL];
+	Hal_SetIOCtrl(HAL_IO_CTRL_DISABLE);
+}
+
+
+// change the I/O page
+// current IO setting is saved for later restoration
+void Sys_SwapIOPage(uint8_t the_page_number)
+{
+#ifdef USE_TELEMETRY
+	if (global_telemetry_io_swaps != 0xFF)
+	{
+		++global_telemetry_io_swaps;
+	}
+#endif
+
+	zp_old_io_page = hal_cpu_space[MMU_IO_CTRL];
+	Hal_SetIOCtrl(the_page_number);
+}
+
+
+// restore the previous IO page setting, which was saved by Sys_SwapIOPage()
+void Sys_RestoreIOPage(void)
+{
+	Hal_SetIOCtrl(zp_old_io_page);
+}
+
+
+// **** memory.asm replacements *****
+
+// modify the MMU LUT to bring the bank in zp_bank_num into the passed CPU slot
+// returns the bank that had been mapped previously
+uint8_t Memory_SwapInNewBank(uint8_t the_bank_slot)
+{
+	zp_old_bank_num = hal_lut[the_bank_slot];
+
+	if (the_bank_slot != HAL_IO_SLOT || hal_io_window == HAL_WINDOW_IS_RAM)
+	{
+		Hal_SaveSlot(the_bank_slot);
+		hal_lut[the_bank_slot] = zp_bank_num;
+		Hal_LoadSlot(the_bank_slot);
+	}
+	else
+	{
+		hal_lut[the_bank_slot] = zp_bank_num;
+	}
+
+	return zp_old_bank_num;
+}
+
+
+// bring back the bank that was mapped before the last Memory_SwapInNewBank()
+void Memory_RestorePreviousBank(uint8_t the_bank_slot)
+{
+	zp_bank_num = zp_old_bank_num;
+	Memory_SwapInNewBank(the_bank_slot);
+}
+
+
+// return whatever is currently mapped in the MMU slot in zp_bank_slot
+uint8_t Memory_GetMappedBankNum(void)
+{
+	return hal_lut[zp_bank_slot];
+}
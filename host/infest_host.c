@@ -0,0 +1,605 @@
+/*
+ * infest_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Host (gcc) frame runner: drives the game logic against the host HAL backend
+ *    as fast as it will go, for profiling (perf, gprof) and for comparing runs.
+ *
+ *  usage: infest_host [-f frames] [-s seed] [-d data_dir] [-o frame.ppm] [-g golden_dir] [-G golden_hashes] [-c interval] [-u] [-t serial_out] [-q]
+ *    -o: write the last frame, as VICKY would show it, to a PPM
+ *    -g: every interval frames (default 500), compare the frame against golden_dir/frame_NNNNNN.ppm.
+ *        mismatches write frame_NNNNNN.new.ppm and frame_NNNNNN.diff.ppm next to the golden and make the run exit with 2.
+ *    -G: the same checkpoints, but against a hash of each frame, plus the state hash at the end, from the text file
+ *        golden_hashes. small enough to check in: _build_host.sh runs host/golden_hashes.txt after every build.
+ *        a mismatch makes the run exit with 2. -g goldens from before the change show where the pixels differ.
+ *    -u: (re)write the -g/-G goldens instead of comparing.
+ *    goldens are only meaningful for the same seed, frame count, and input (scripted player, or INPUT_PLAYBACK)
+ *    -t: USE_TELEMETRY builds: write what would go out the UART (telemetry packets) to serial_out, a file or pty
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "../hal.h"
+#include "../app.h"
+#include "../general.h"
+#include "../keyboard.h"
+#include "../kernel.h"
+#include "../memory.h"
+#include "../replay.h"
+#include "../text.h"
+#include "compositor.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+
+// F256 includes
+#include "../f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define HOST_DEFAULT_FRAMES			100000
+#define HOST_DEFAULT_DATA_DIR		"data"
+#define HOST_PATH_LEN				256
+#define HOST_BOT_MIN_HOLD			4		// the scripted player holds each key for between MIN and MIN+MASK frames
+#define HOST_BOT_HOLD_MASK			0x1F
+#define HOST_DEFAULT_GOLDEN_INTERVAL	500
+#define HOST_MAX_GOLDEN_HASHES		64		// -G checkpoints in one run
+
+typedef struct HostAsset
+{
+	const char*		file_name_;
+	uint32_t		phys_addr_;
+} HostAsset;
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+// same files and load addresses the pgZ gets in _build_vbcc.sh
+static const HostAsset	host_assets[] =
+{
+	{"robot.bin",		SPRITE_ROBOT_16F_PHYS_ADDR},
+	{"human1.bin",		SPRITE_HUMAN_1_8F_PHYS_ADDR},
+	{"bullets_s.bin",	SPRITE_BULLET_S_PHYS_ADDR},
+	{"tilemap.bin",		TILEMAP_PHYS_ADDR},
+	{"tiles.bin",		TILESET_PHYS_ADDR},
+	{"strings.bin",		STRINGS_PHYS_ADDR},
+};
+
+static const uint8_t	host_bot_keys[] =
+{
+	MOVE_UP, MOVE_RIGHT, MOVE_DOWN, MOVE_LEFT, MOVE_UP_RIGHT, MOVE_DOWN_RIGHT, MOVE_DOWN_LEFT, MOVE_UP_LEFT,
+	ACTION_FIRE, ACTION_FIRE, ACTION_FIRE, ACTION_FIRE, ACTION_CYCLE_WEAPON, 0, 0, 0,
+};
+
+static uint32_t			host_bot_state = 0x1234567;	// the scripted player has its own PRNG so it doesn't disturb the game's
+static uint8_t			host_bot_key;
+static uint8_t			host_bot_hold;
+
+static uint8_t			host_frame[COMPOSITOR_FRAME_SIZE];
+static uint8_t			host_golden_frame[COMPOSITOR_FRAME_SIZE];
+
+static uint32_t			host_golden_hash_frame[HOST_MAX_GOLDEN_HASHES];	// -G: checkpoint frame numbers and their frame hashes
+static uint32_t			host_golden_hash[HOST_MAX_GOLDEN_HASHES];
+static uint8_t			host_num_golden_hashes;
+static uint32_t			host_golden_state_hash;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern uint16_t			zp_px;
+extern uint16_t			zp_py;
+extern int8_t			zp_hp;
+extern int8_t			zp_lives;
+extern uint16_t			zp_points;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// next number from the scripted player's PRNG
+static uint32_t Host_BotRandom(void);
+
+// FNV-1a over the state that should match between two runs with the same seed and input: ZP vars, sprite registers, tilemap
+static uint32_t Host_StateHash(uint32_t the_hash);
+
+// load every asset the pgZ would have loaded. returns false if any is missing.
+static bool Host_LoadAssets(const char* the_data_dir);
+
+// render the current frame and write it as, or compare it against, the golden for this frame number
+// returns false if it was compared and did not match
+static bool Host_CheckGolden(const char* the_golden_dir, uint32_t the_frame_num, bool update_golden);
+
+// read a -G golden hash file: "frame N hash" lines in frame order, then a "state hash" line. '#' lines are comments.
+// returns false if it can't be read
+static bool Host_ReadGoldenHashes(const char* the_path);
+
+// write the checkpoint and state hashes of this run as a -G golden hash file. returns false if it can't be written.
+static bool Host_WriteGoldenHashes(const char* the_path, uint32_t the_state_hash);
+
+// render the current frame and compare its hash against the -G golden for this checkpoint, or record it
+// returns false if it was compared and did not match
+static bool Host_CheckGoldenHash(uint8_t the_checkpoint, uint32_t the_frame_num, bool update_golden);
+
+// seconds on the monotonic clock
+static double Host_Seconds(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// next number from the scripted player's PRNG
+static uint32_t Host_BotRandom(void)
+{
+	host_bot_state ^= host_bot_state << 13;
+	host_bot_state ^= host_bot_state >> 17;
+	host_bot_state ^= host_bot_state << 5;
+
+	return host_bot_state;
+}
+
+
+// FNV-1a over the state that should match between two runs with the same seed and input: ZP vars, sprite registers, tilemap
+static uint32_t Host_StateHash(uint32_t the_hash)
+{
+	uint8_t		the_state[8];
+	uint16_t	i;
+	uint8_t*	the_sprite_regs;
+
+	the_state[0] = zp_px & 0xFF;
+	the_state[1] = zp_px >> 8;
+	the_state[2] = zp_py & 0xFF;
+	the_state[3] = zp_py >> 8;
+	the_state[4] = zp_hp;
+	the_state[5] = zp_lives;
+	the_state[6] = zp_points & 0xFF;
+	the_state[7] = zp_points >> 8;
+
+	for (i = 0; i < sizeof(the_state); i++)
+	{
+		the_hash = (the_hash ^ the_state[i]) * 16777619u;
+	}
+
+	Hal_SyncAll();
+	the_sprite_regs = &hal_io_page[VICKY_IO_PAGE_REGISTERS][SPRITE0_CTRL - 0xC000];
+
+	for (i = 0; i < SPRITE_REG_LEN * 64; i++)
+	{
+		the_hash = (the_hash ^ the_sprite_regs[i]) * 16777619u;
+	}
+
+	for (i = 0; i < TILEMAP_LEN; i++)
+	{
+		the_hash = (the_hash ^ hal_phys_ram[TILEMAP_PHYS_ADDR + i]) * 16777619u;
+	}
+
+	return the_hash;
+}
+
+
+// load every asset the pgZ would have loaded. returns false if any is missing.
+static bool Host_LoadAssets(const char* the_data_dir)
+{
+	char		the_path[HOST_PATH_LEN];
+	uint8_t		i;
+
+	for (i = 0; i < sizeof(host_assets) / sizeof(HostAsset); i++)
+	{
+		snprintf(the_path, HOST_PATH_LEN, "%s/%s", the_data_dir, host_assets[i].file_name_);
+
+		if (Hal_LoadFileToPhys(the_path, host_assets[i].phys_addr_) < 0)
+		{
+			fprintf(stderr, "could not load '%s'\n", the_path);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+
+// render the current frame and write it as, or compare it against, the golden for this frame number
+// returns false if it was compared and did not match
+static bool Host_CheckGolden(const char* the_golden_dir, uint32_t the_frame_num, bool update_golden)
+{
+	char		the_path[HOST_PATH_LEN];
+	uint32_t	num_different;
+
+	Compositor_Render(host_frame);
+
+	snprintf(the_path, HOST_PATH_LEN, "%s/frame_%06u.ppm", the_golden_dir, the_frame_num);
+
+	if (update_golden)
+	{
+		if (Compositor_WritePPM(the_path, host_frame) == false)
+		{
+			fprintf(stderr, "could not write golden '%s'\n", the_path);
+		}
+
+		return true;
+	}
+
+	if (Compositor_ReadPPM(the_path, host_golden_frame) == false)
+	{
+		fprintf(stderr, "missing or unreadable golden '%s' (run with -u to create)\n", the_path);
+		return false;
+	}
+
+	num_different = Compositor_Diff(host_frame, host_golden_frame, host_golden_frame);
+
+	if (num_different == 0)
+	{
+		return true;
+	}
+
+	fprintf(stderr, "frame %u: %u pixels differ from golden\n", the_frame_num, num_different);
+
+	snprintf(the_path, HOST_PATH_LEN, "%s/frame_%06u.diff.ppm", the_golden_dir, the_frame_num);
+	Compositor_WritePPM(the_path, host_golden_frame);
+	snprintf(the_path, HOST_PATH_LEN, "%s/frame_%06u.new.ppm", the_golden_dir, the_frame_num);
+	Compositor_WritePPM(the_path, host_frame);
+
+	return false;
+}
+
+
+// read a -G golden hash file: "frame N hash" lines in frame order, then a "state hash" line. '#' lines are comments.
+// returns false if it can't be read
+static bool Host_ReadGoldenHashes(const char* the_path)
+{
+	FILE*		the_file;
+	char		the_line[HOST_PATH_LEN];
+	uint32_t	the_frame_num;
+	uint32_t	the_hash;
+
+	if ((the_file = fopen(the_path, "r")) == NULL)
+	{
+		return false;
+	}
+
+	host_num_golden_hashes = 0;
+
+	while (fgets(the_line, sizeof(the_line), the_file) != NULL)
+	{
+		if (sscanf(the_line, "frame %u %x", &the_frame_num, &the_hash) == 2 && host_num_golden_hashes < HOST_MAX_GOLDEN_HASHES)
+		{
+			host_golden_hash_frame[host_num_golden_hashes] = the_frame_num;
+			host_golden_hash[host_num_golden_hashes++] = the_hash;
+		}
+		else if (sscanf(the_line, "state %x", &the_hash) == 1)
+		{
+			host_golden_state_hash = the_hash;
+		}
+	}
+
+	fclose(the_file);
+
+	return true;
+}
+
+
+// write the checkpoint and state hashes of this run as a -G golden hash file. returns false if it can't be written.
+static bool Host_WriteGoldenHashes(const char* the_path, uint32_t the_state_hash)
+{
+	FILE*		the_file;
+	uint8_t		i;
+
+	if ((the_file = fopen(the_path, "w")) == NULL)
+	{
+		return false;
+	}
+
+	fprintf(the_file, "# infest_host -G golden hashes: FNV-1a of the rendered frame at each checkpoint, then the state hash.\n");
+	fprintf(the_file, "# only good for the seed, frame count, and checkpoint interval in _build_host.sh. rewrite with -u there.\n");
+
+	for (i = 0; i < host_num_golden_hashes; i++)
+	{
+		fprintf(the_file, "frame %u %08x\n", host_golden_hash_frame[i], host_golden_hash[i]);
+	}
+
+	fprintf(the_file, "state %08x\n", the_state_hash);
+	fclose(the_file);
+
+	return true;
+}
+
+
+// render the current frame and compare its hash against the -G golden for this checkpoint, or record it
+// returns false if it was compared and did not match
+static bool Host_CheckGoldenHash(uint8_t the_checkpoint, uint32_t the_frame_num, bool update_golden)
+{
+	uint32_t	the_hash = 2166136261u;
+	uint32_t	i;
+
+	if (the_checkpoint >= HOST_MAX_GOLDEN_HASHES)
+	{
+		fprintf(stderr, "frame %u: more than %u -G checkpoints\n", the_frame_num, HOST_MAX_GOLDEN_HASHES);
+		return false;
+	}
+
+	Compositor_Render(host_frame);
+
+	for (i = 0; i < COMPOSITOR_FRAME_SIZE; i++)
+	{
+		the_hash = (the_hash ^ host_frame[i]) * 16777619u;
+	}
+
+	if (update_golden)
+	{
+		host_golden_hash_frame[the_checkpoint] = the_frame_num;
+		host_golden_hash[the_checkpoint] = the_hash;
+		host_num_golden_hashes = the_checkpoint + 1;
+		return true;
+	}
+
+	if (the_checkpoint >= host_num_golden_hashes || host_golden_hash_frame[the_checkpoint] != the_frame_num)
+	{
+		fprintf(stderr, "frame %u: no golden hash for this checkpoint\n", the_frame_num);
+		return false;
+	}
+
+	if (host_golden_hash[the_checkpoint] == the_hash)
+	{
+		return true;
+	}
+
+	fprintf(stderr, "frame %u: frame hash %08x, golden %08x\n", the_frame_num, the_hash, host_golden_hash[the_checkpoint]);
+
+	return false;
+}
+
+
+// seconds on the monotonic clock
+static double Host_Seconds(void)
+{
+	struct timespec		the_time;
+
+	clock_gettime(CLOCK_MONOTONIC, &the_time);
+
+	return the_time.tv_sec + the_time.tv_nsec / 1e9;
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** kernel.c / keyboard.c replacements *****
+
+void kernel_init(void)
+{
+}
+
+
+// the scripted player: picks a key and holds it for a random number of frames
+uint8_t Keyboard_GetKeyIfPressed(void)
+{
+	if (host_bot_hold == 0)
+	{
+		host_bot_key = host_bot_keys[Host_BotRandom() % sizeof(host_bot_keys)];
+		host_bot_hold = HOST_BOT_MIN_HOLD + (Host_BotRandom() & HOST_BOT_HOLD_MASK);
+	}
+
+	--host_bot_hold;
+
+	return host_bot_key;
+}
+
+
+// never wait on the host: "press any key" is pressed immediately
+char Keyboard_GetChar(void)
+{
+	return CH_SPACE;
+}
+
+
+int main(int argc, char* argv[])
+{
+	uint32_t			num_frames = HOST_DEFAULT_FRAMES;
+	uint32_t			frame;
+	uint32_t			num_games = 1;
+	uint32_t			the_hash = 2166136261u;
+	uint16_t			the_seed = 0;
+	const char*			the_data_dir = HOST_DEFAULT_DATA_DIR;
+	bool				be_quiet = false;
+	const char*			the_frame_path = NULL;
+	const char*			the_golden_dir = NULL;
+	const char*			the_golden_hash_path = NULL;
+	uint8_t				the_checkpoint = 0;
+	uint32_t			the_golden_interval = HOST_DEFAULT_GOLDEN_INTERVAL;
+	bool				update_golden = false;
+	uint32_t			num_golden_failures = 0;
+	int					i;
+	double				start_time;
+	double				render_time = 0;
+	double				the_time;
+	double				elapsed;
+	uint32_t			start_text_vram_bytes;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			num_frames = strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			the_seed = strtoul(argv[++i], NULL, 0);
+			host_bot_state = the_seed ? the_seed : host_bot_state;
+		}
+		else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+		{
+			the_data_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			the_frame_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+		{
+			the_golden_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "-G") == 0 && i + 1 < argc)
+		{
+			the_golden_hash_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+		{
+			the_golden_interval = strtoul(argv[++i], NULL, 0);
+			the_golden_interval = the_golden_interval ? the_golden_interval : HOST_DEFAULT_GOLDEN_INTERVAL;
+		}
+		else if (strcmp(argv[i], "-u") == 0)
+		{
+			update_golden = true;
+		}
+		else if (strcmp(argv[i], "-q") == 0)
+		{
+			be_quiet = true;
+		}
+#ifdef USE_TELEMETRY
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			int		the_fd = open(argv[++i], O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+
+			if (the_fd < 0)
+			{
+				perror(argv[i]);
+				return 1;
+			}
+
+			Serial_SetHostOutput(the_fd);
+		}
+#endif
+		else
+		{
+			fprintf(stderr, "usage: %s [-f frames] [-s seed] [-d data_dir] [-o frame.ppm] [-g golden_dir] [-G golden_hashes] [-c interval] [-u] [-t serial_out] [-q]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (the_golden_hash_path != NULL && update_golden == false && Host_ReadGoldenHashes(the_golden_hash_path) == false)
+	{
+		fprintf(stderr, "missing or unreadable golden hashes '%s' (run with -u to create)\n", the_golden_hash_path);
+		return 1;
+	}
+
+	Hal_Initialize();
+
+	// Startup_InitializeRandomNumGen seeds VICKY's RNG from the RTC minutes/seconds. IO page 0 is mapped in at power-on.
+	R8(RTC_MINUTES) = the_seed >> 8;
+	R8(RTC_SECONDS) = the_seed & 0xFF;
+
+	if (Host_LoadAssets(the_data_dir) == false)
+	{
+		return 1;
+	}
+
+	App_InitializeApp();
+	App_InitializeGame();
+
+	start_time = Host_Seconds();
+	start_text_vram_bytes = global_text_vram_bytes;
+
+	for (frame = 0; frame < num_frames; frame++)
+	{
+		if (App_RunFrame() == false)
+		{
+			App_InitializeGame();
+			++num_games;
+		}
+
+		// compositing time is kept out of frames/sec
+		if (the_golden_dir != NULL && (frame + 1) % the_golden_interval == 0)
+		{
+			the_time = Host_Seconds();
+			num_golden_failures += (Host_CheckGolden(the_golden_dir, frame + 1, update_golden) == false);
+			render_time += Host_Seconds() - the_time;
+		}
+
+		if (the_golden_hash_path != NULL && (frame + 1) % the_golden_interval == 0)
+		{
+			the_time = Host_Seconds();
+			num_golden_failures += (Host_CheckGoldenHash(the_checkpoint++, frame + 1, update_golden) == false);
+			render_time += Host_Seconds() - the_time;
+		}
+	}
+
+	elapsed = Host_Seconds() - start_time - render_time;
+
+	// the stream stays open across games, so close it here. a run usually stops mid-game, so the last game has no end marker
+	#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+		Replay_Finish();
+	#endif
+
+	the_hash = Host_StateHash(the_hash);
+
+	if (the_golden_hash_path != NULL)
+	{
+		if (update_golden)
+		{
+			if (Host_WriteGoldenHashes(the_golden_hash_path, the_hash) == false)
+			{
+				fprintf(stderr, "could not write golden hashes '%s'\n", the_golden_hash_path);
+			}
+		}
+		else if (the_checkpoint != host_num_golden_hashes || the_hash != host_golden_state_hash)
+		{
+			fprintf(stderr, "state hash %08x, golden %08x, after %u of %u checkpoints\n", the_hash, host_golden_state_hash, the_checkpoint, host_num_golden_hashes);
+			++num_golden_failures;
+		}
+	}
+
+	if (the_frame_path != NULL)
+	{
+		Compositor_Render(host_frame);
+
+		if (Compositor_WritePPM(the_frame_path, host_frame) == false)
+		{
+			fprintf(stderr, "could not write '%s'\n", the_frame_path);
+		}
+	}
+
+	if (be_quiet == false)
+	{
+		printf("frames:     %u\n", num_frames);
+		printf("games:      %u\n", num_games);
+		printf("seconds:    %.3f\n", elapsed);
+		printf("frames/sec: %.0f\n", elapsed > 0 ? num_frames / elapsed : 0.0);
+		printf("text VRAM:  %.1f bytes/frame\n", num_frames > 0 ? (double)(global_text_vram_bytes - start_text_vram_bytes) / num_frames : 0.0);
+	}
+
+	printf("state hash: %08x\n", the_hash);
+
+	if (num_golden_failures > 0)
+	{
+		printf("golden mismatches: %u\n", num_golden_failures);
+		return 2;
+	}
+
+	return 0;
+}
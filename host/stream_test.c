@@ -0,0 +1,184 @@
+/*
+ * stream_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Host (gcc) check of the asset streamer (asset_stream.h) against the real files in data/,
+ *    through the same FileIO and HAL the game uses. _build_host.sh builds and runs it after every build.
+ *
+ *  usage: stream_test, from the project directory: the streamer reads STREAM_HOST_DIR, relative to it
+ *    checks: a set loads in chunks across frames and matches its file; asking again gives the same handle;
+ *            a missing file fails and gives its banks back; a full pool evicts the least recently used set;
+ *            a released set's banks can be reused.
+ *    prints each check, and exits with 2 if any failed.
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "../hal.h"
+#include "../asset_stream.h"
+#include "../memory.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define STREAM_TEST_MAX_FRAMES		200		// Stream_Service() calls to wait for a load before calling it stuck
+#define STREAM_TEST_FILE_MAX		0x2000
+#define STREAM_TEST_PATH_LEN		256
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint8_t			stream_test_file[STREAM_TEST_FILE_MAX];
+static uint32_t			stream_test_num_failed;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// print one check's result, and count it if it failed
+static void StreamTest_Check(bool passed, const char* the_what);
+
+// run Stream_Service() until the handle is resident or has failed. returns how many frames that took, or -1 if neither
+static int StreamTest_Service(uint8_t the_handle);
+
+// true if the set at the_handle holds exactly the file STREAM_HOST_DIR/the_file_name
+static bool StreamTest_MatchesFile(uint8_t the_handle, const char* the_file_name);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// print one check's result, and count it if it failed
+static void StreamTest_Check(bool passed, const char* the_what)
+{
+	printf("%s: %s\n", passed ? "ok  " : "FAIL", the_what);
+
+	stream_test_num_failed += (passed == false);
+}
+
+
+// run Stream_Service() until the handle is resident or has failed. returns how many frames that took, or -1 if neither
+static int StreamTest_Service(uint8_t the_handle)
+{
+	int		the_frame;
+
+	for (the_frame = 1; the_frame <= STREAM_TEST_MAX_FRAMES; the_frame++)
+	{
+		Stream_Service();
+
+		if (Stream_IsResident(the_handle) || Stream_HasFailed(the_handle))
+		{
+			return the_frame;
+		}
+	}
+
+	return -1;
+}
+
+
+// true if the set at the_handle holds exactly the file STREAM_HOST_DIR/the_file_name
+static bool StreamTest_MatchesFile(uint8_t the_handle, const char* the_file_name)
+{
+	char		the_path[STREAM_TEST_PATH_LEN];
+	FILE*		the_file;
+	size_t		the_len;
+
+	snprintf(the_path, STREAM_TEST_PATH_LEN, "%s%s", STREAM_HOST_DIR, the_file_name);
+
+	if ((the_file = fopen(the_path, "rb")) == NULL)
+	{
+		fprintf(stderr, "could not read '%s'\n", the_path);
+		return false;
+	}
+
+	the_len = fread(stream_test_file, 1, STREAM_TEST_FILE_MAX, the_file);
+	fclose(the_file);
+
+	return the_len > 0 && memcmp(&hal_phys_ram[(uint32_t)Stream_GetBank(the_handle) * 0x2000], stream_test_file, the_len) == 0;
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+int main(void)
+{
+	uint8_t			the_robot;
+	uint8_t			the_missing;
+	uint8_t			the_tiles;
+	uint8_t			the_human;
+	int				the_frames;
+
+	Hal_Initialize();
+
+	// a load, and a missing file queued behind it
+	the_robot = Stream_Request("1:robot.bin", 1);
+	the_missing = Stream_Request("1:not_there.bin", 1);
+	StreamTest_Check(the_robot != STREAM_INVALID_HANDLE && the_missing != STREAM_INVALID_HANDLE, "requests accepted");
+	StreamTest_Check(Stream_IsResident(the_robot) == false, "nothing is resident before Stream_Service()");
+
+	the_frames = StreamTest_Service(the_robot);
+	StreamTest_Check(the_frames > 1 && Stream_IsResident(the_robot), "robot.bin loads, over more than one frame");
+	StreamTest_Check(StreamTest_MatchesFile(the_robot, "robot.bin"), "robot.bin's bank matches the file");
+	StreamTest_Check(Stream_GetBank(the_robot) == EM_STREAM_FIRST_PHYS_BANK_NUM, "robot.bin got the first stream bank");
+	StreamTest_Check(Stream_Request("1:robot.bin", 1) == the_robot, "asking again gives the same handle");
+
+	StreamTest_Service(the_missing);
+	StreamTest_Check(Stream_HasFailed(the_missing) && Stream_IsResident(the_missing) == false, "a missing file fails");
+	Stream_Release(the_missing);
+
+	// fill the pool: the missing file's bank came back, so this fits beside robot.bin without evicting it
+	the_tiles = Stream_Request("1:tiles.bin", EM_STREAM_NUM_BANKS - 1);
+	StreamTest_Check(the_tiles != STREAM_INVALID_HANDLE && Stream_IsResident(the_robot), "a failed set's banks are given back");
+	StreamTest_Service(the_tiles);
+	StreamTest_Check(Stream_IsResident(the_tiles) && StreamTest_MatchesFile(the_tiles, "tiles.bin"), "tiles.bin loads into the rest of the pool");
+
+	// pool is full. robot.bin was used more recently than tiles.bin, so tiles.bin is the one to go
+	Stream_Touch(the_robot);
+	the_human = Stream_Request("1:human1.bin", 1);
+	StreamTest_Check(the_human != STREAM_INVALID_HANDLE, "a request into a full pool is accepted");
+	StreamTest_Check(Stream_IsResident(the_robot) && Stream_IsResident(the_tiles) == false, "the least recently used set is the one evicted");
+	StreamTest_Service(the_human);
+	StreamTest_Check(Stream_IsResident(the_human) && StreamTest_MatchesFile(the_human, "human1.bin"), "human1.bin loads into the evicted banks");
+	StreamTest_Check(StreamTest_MatchesFile(the_robot, "robot.bin"), "robot.bin is untouched");
+
+	// released banks are reused
+	Stream_Release(the_human);
+	Stream_Release(the_robot);
+	the_tiles = Stream_Request("1:tiles.bin", EM_STREAM_NUM_BANKS);
+	StreamTest_Check(the_tiles != STREAM_INVALID_HANDLE && Stream_GetBank(the_tiles) == EM_STREAM_FIRST_PHYS_BANK_NUM, "released banks can be reused");
+	StreamTest_Service(the_tiles);
+	StreamTest_Check(Stream_IsResident(the_tiles) && StreamTest_MatchesFile(the_tiles, "tiles.bin"), "tiles.bin loads into the whole pool");
+
+	if (stream_test_num_failed > 0)
+	{
+		printf("stream checks failed: %u\n", stream_test_num_failed);
+		return 2;
+	}
+
+	printf("stream checks passed\n");
+
+	return 0;
+}
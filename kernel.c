@@ -175,25 +175,26 @@ bool Kernal_AnyKeyEvent()
     }
 }
 
-// static const char *
-// path_without_drive(const char *path, char *drive)
-// {
-//     *drive = 0;
-//     
-//     if (strlen(path) < 2) {
-//         return path;
-//     }
-//     
-//     if (path[1] != ':') {
-//         return path;
-//     }
-//     
-//     if ((*path >= '0') && (*path <= '7')) {
-//         *drive = *path - '0';
-//     }
-//         
-//     return (path + 2);
-// }
+static const char *
+path_without_drive(const char *path, char *drive)
+{
+    *drive = 0;
+    
+    if (strlen(path) < 2) {
+        return path;
+    }
+    
+    if (path[1] != ':') {
+        return path;
+    }
+    
+    if ((*path >= '0') && (*path <= '7')) {
+        *drive = *path - '0';
+    }
+        
+    return (path + 2);
+}
+
 // 
 // int
 // open(const char *fname, int mode, ...)
@@ -376,6 +377,100 @@ write(int fd, const void *buf, uint16_t nbytes)
 // }
 
 
+
+////////////////////////////////////////
+// non-blocking file calls
+//
+// each of these only issues the kernel request and returns. the outcome arrives later as a file.* event,
+// which Keyboard_ProcessEvents() hands to FileIO_HandleFileEvent() (file_io.h).
+
+int
+Kernel_OpenAsync(const char *fname, uint8_t mode)
+{
+    int ret;
+    char drive;
+    
+    fname = path_without_drive(fname, &drive);
+    
+    args.common.buf = (uint8_t*) fname;
+    args.common.buflen = strlen(fname);
+    args.file.open.drive = drive;
+    args.file.open.mode = mode;
+    ret = CALL(File.Open);
+    if (error) {
+        return -1;
+    }
+    
+    return ret;	// stream id. file.OPENED or file.NOT_FOUND/file.ERROR follows.
+}
+
+bool
+Kernel_ReadAsync(uint8_t stream, uint8_t nbytes)
+{
+    args.file.read.stream = stream;
+    args.file.read.buflen = nbytes;
+    CALL(File.Read);
+    
+    return !error;	// file.DATA, file.EOFx, or file.ERROR follows.
+}
+
+uint8_t
+Kernel_ReadData(void *buf)
+{
+    // only valid while handling a file.DATA event: copies what the kernel delivered into buf
+    args.common.buf = buf;
+    args.common.buflen = event.file.data.delivered;
+    asm("jsr %w", VECTOR(ReadData));
+    
+    return event.file.data.delivered;
+}
+
+bool
+Kernel_WriteAsync(uint8_t stream, const void *buf, uint8_t nbytes)
+{
+    args.file.write.stream = stream;
+    args.common.buf = (void*) buf;
+    args.common.buflen = nbytes;
+    CALL(File.Write);
+    
+    return !error;	// file.WROTE (with the count the kernel took) or file.ERROR follows.
+}
+
+bool
+Kernel_CloseAsync(uint8_t stream)
+{
+    args.file.close.stream = stream;
+    CALL(File.Close);
+    
+    return !error;	// file.CLOSED or file.ERROR follows.
+}
+
+
+////////////////////////////////////////
+// frame timer
+//
+// the kernel counts frames off VICKY's start-of-frame interrupt. a TIMER_FRAMES timer set for the next count
+// comes back as a timer.EXPIRED event right after that interrupt, which is as close to it as a program can get.
+
+uint8_t
+Kernel_GetFrameCount(void)
+{
+    args.timer.units = TIMER_FRAMES | TIMER_QUERY;
+    
+    return CALL(Clock.SetTimer);
+}
+
+bool
+Kernel_SetFrameTimer(uint8_t frame, uint8_t cookie)
+{
+    args.timer.absolute = frame;
+    args.timer.units = TIMER_FRAMES;
+    args.timer.cookie = cookie;
+    CALL(Clock.SetTimer);
+    
+    return !error;	// timer.EXPIRED with this cookie follows, once the kernel's frame count reaches frame.
+}
+
    
 ////////////////////////////////////////
 // dirent
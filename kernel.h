@@ -19,4 +19,28 @@ bool Kernal_AnyKeyEvent();
 
 void out(char c);
 
+// non-blocking file calls: these issue the request and return right away; the result comes back as a file.* event
+// open a file for reading or writing (mode: READ or WRITE from api.h). name may start with a drive ("1:name").
+// returns the stream id, or -1 if the kernel refused
+int Kernel_OpenAsync(const char *fname, uint8_t mode);
+
+// request up to nbytes (max 255) from an open stream. returns false if the kernel refused
+bool Kernel_ReadAsync(uint8_t stream, uint8_t nbytes);
+
+// while handling a file.DATA event, copy the delivered bytes into buf. returns the number of bytes copied
+uint8_t Kernel_ReadData(void *buf);
+
+// hand up to nbytes (max 255) to an open stream to write. returns false if the kernel refused.
+// file.WROTE says how many it took: buf must stay as it is until then
+bool Kernel_WriteAsync(uint8_t stream, const void *buf, uint8_t nbytes);
+
+// close a stream. returns false if the kernel refused
+bool Kernel_CloseAsync(uint8_t stream);
+
+// frame timer: the kernel's frame count, which goes up once per VICKY start of frame
+uint8_t Kernel_GetFrameCount(void);
+
+// ask for a timer.EXPIRED event tagged with cookie when the frame count reaches frame. returns false if the kernel refused
+bool Kernel_SetFrameTimer(uint8_t frame, uint8_t cookie);
+
 #endif /* KERNEL_H_ */
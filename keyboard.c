@@ -18,11 +18,13 @@
 
 // project includes
 #include "keyboard.h"
+#include "file_io.h"
 #include "kernel.h"
 #include "f256.h"
 // #include "comm_buffer.h"	// just need for debugging
 #include "general.h"
 #include "memory.h"
+#include "present.h"
 
 // C includes
 #include <stdint.h>
@@ -40,6 +42,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_KEYBOARD
+
 #define MINUTE_TIMER_COOKIE		127		// hard-coded. just don't want it to start with 0, as that's what the keyboard cookie will start with
 
 #define KEYBOARD_QUEUE_SIZE		8
@@ -156,6 +160,13 @@ uint8_t Keyboard_GetNextEvent(void)
 	{
 		return 255;
 	}
+	else if (event.type >= EVENT(file.NOT_FOUND) && event.type <= EVENT(file.SEEK))
+	{
+		// file events are answers to FileIO requests (the asset streamer's among them); hand them over and keep pumping
+		FileIO_HandleFileEvent();
+		
+		return 2;
+	}
 	else if (event.type != EVENT(key.PRESSED) && event.type != EVENT(key.RELEASED) && event.type != EVENT(JOYSTICK))
 	{
 		return 0;
@@ -247,8 +258,8 @@ uint8_t Keyboard_ProcessKeyEvent(void)
 		// jmp     StopRepeat WHICH IS "inc     repeat.cookie -> rts"
 		keyboard_repeater.cookie++;
 
-		// prevent collision with the permanent minute hand cookie		
-		if (keyboard_repeater.cookie == MINUTE_TIMER_COOKIE)
+		// prevent collision with the permanent minute hand and frame timer cookies (adjacent, so at most 2 steps)
+		while (keyboard_repeater.cookie == MINUTE_TIMER_COOKIE || keyboard_repeater.cookie == PRESENT_FRAME_COOKIE)
 		{
 			keyboard_repeater.cookie++;
 		}
@@ -266,8 +277,8 @@ void Keyboard_StartTimerForKey(uint8_t the_key)
 	keyboard_repeater.key = the_key;
 	keyboard_repeater.cookie++;			// set a new ID
 		
-	// prevent collision with the permanent minute hand cookie
-	if (keyboard_repeater.cookie == MINUTE_TIMER_COOKIE)
+	// prevent collision with the permanent minute hand and frame timer cookies (adjacent, so at most 2 steps)
+	while (keyboard_repeater.cookie == MINUTE_TIMER_COOKIE || keyboard_repeater.cookie == PRESENT_FRAME_COOKIE)
 	{
 		keyboard_repeater.cookie++;
 	}
@@ -369,7 +380,11 @@ void Keyboard_ProcessEvents(void)
 		
 		if (event.type == EVENT(timer.EXPIRED))
 		{
-			if ((repeated_char = Keyboard_HandleRepeatTimerEvent()) != 0)
+			if (event.timer.cookie == PRESENT_FRAME_COOKIE)
+			{
+				Present_HandleFrameEvent();
+			}
+			else if ((repeated_char = Keyboard_HandleRepeatTimerEvent()) != 0)
 			{
 				Keyboard_AddToQueue(repeated_char);
 			}		
@@ -17,13 +17,18 @@
 // project includes
 #include "level.h"
 #include "app.h"
+#include "anim.h"
+#include "asset_stream.h"
 #include "comm_buffer.h"
+#include "flow_field.h"
 #include "general.h"
 #include "kernel.h"
 #include "keyboard.h"
 #include "memory.h"
 #include "object.h"
 #include "player.h"
+#include "playfield.h"
+#include "present.h"
 #include "sys.h"
 #include "text.h"
 #include "strings.h"
@@ -44,12 +49,19 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_LEVEL
+
+// the large bullet graphic isn't in the pgZ: it's streamed in from disk the first time the player picks a heavy weapon
+#define LEVEL_BULLET_L_FILE		"0:bullets_l.bin"
+#define LEVEL_BULLET_L_BANKS	1
+
 
 
 /*****************************************************************************/
 /*                           File-scope Variables                            */
 /*****************************************************************************/
 
+static uint8_t				level_bullet_l_set = STREAM_INVALID_HANDLE;	// Stream handle for LEVEL_BULLET_L_FILE, once asked for
 
 
 /*****************************************************************************/
@@ -63,8 +75,9 @@ Sprite						global_clips[LEVEL_MAX_CLIPS];
 Sprite						global_poo[LEVEL_MAX_POO];
 
 extern Player*				global_player;
+extern uint16_t				global_camera_x;
+extern uint16_t				global_camera_y;
 
-extern char*				global_string[NUM_STRINGS];
 extern char*				global_string_buff1;
 // extern char*				global_string_buff2;
 
@@ -98,6 +111,18 @@ extern uint16_t				zp_ticktock;
 #pragma zpsym ("zp_lives");
 #pragma zpsym ("zp_ticktock");
 
+// per-frame scratch for the sprite loops. in zero page so the loops can use (zp),y instead of the C stack
+extern uint8_t				zp_sprite_idx;
+extern uint8_t				zp_other_idx;
+extern Sprite*				zp_sprite;
+extern Sprite*				zp_other;
+extern Rectangle			zp_player_box;
+#pragma zpsym ("zp_sprite_idx");
+#pragma zpsym ("zp_other_idx");
+#pragma zpsym ("zp_sprite");
+#pragma zpsym ("zp_other");
+#pragma zpsym ("zp_player_box");
+
 //#pragma zpsym ("global_player");
 
 
@@ -124,6 +149,16 @@ void Level_MakeTileBloody(uint16_t x, uint16_t y);
 // Reset the tilemap to initial conditions: the no-gore tiles
 void Level_ResetTileMap(void);
 
+// add a VICKY register image of a sprite to the frame being built, moving it from world to screen coordinates on the way
+// sprites off screen are turned off
+void Level_SnapshotSprite(Sprite* the_sprite);
+
+// point each live human at the player, along the flow field. humans it has no direction for keep going.
+void Level_SteerHumans(void);
+
+// point a missile about to be fired at the bullet graphic for the current weapon
+void Level_SetMissileGraphic(Sprite* the_missile);
+
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
@@ -135,30 +170,34 @@ void Level_PlaceHumans(void)
 	uint8_t		i;
 	uint16_t	new_pixel;
 	
-	// TODO: check not being placed on top of another human, or on top of obstacle, chip, etc.
+	// TODO: check not being placed on top of another human, or on top of chip, etc.
 	
 	for (i=0; i < LEVEL_MAX_HUMANS; i++)
 	{
 		// pick a legal place within the playfield, which has 32 pix boundary on all sides for sprites.
-		// make sure that the picked place is an even pixel number, not 1,3, 13 etc., because we are using even numbering for ticktock animations
-		
-		new_pixel = App_GetRandom(LEVEL_MAX_X - LEVEL_MIN_X) + LEVEL_MIN_X;
+		// make sure that the picked place is an even pixel number, not 1,3, 13 etc., so humans moving HUMAN_SPEED pixels at a time stay on even pixels
+		// a human started inside a wall could never move out of it, so keep picking until the spot is clear
 		
-		if (new_pixel % 2 != 0)
+		do
 		{
-			--new_pixel;
-		}
-		
-		global_humans[i].x1_ = new_pixel;
+			new_pixel = App_GetRandom(LEVEL_MAX_X - LEVEL_MIN_X) + LEVEL_MIN_X;
+			
+			if (new_pixel % 2 != 0)
+			{
+				--new_pixel;
+			}
+			
+			global_humans[i].x1_ = new_pixel;
 
-		new_pixel = App_GetRandom(LEVEL_MAX_Y - LEVEL_MIN_Y) + LEVEL_MIN_Y;
-		
-		if (new_pixel % 2 != 0)
-		{
-			--new_pixel;
-		}
-		
-		global_humans[i].y1_ = new_pixel;
+			new_pixel = App_GetRandom(LEVEL_MAX_Y - LEVEL_MIN_Y) + LEVEL_MIN_Y;
+			
+			if (new_pixel % 2 != 0)
+			{
+				--new_pixel;
+			}
+			
+			global_humans[i].y1_ = new_pixel;
+		} while (Playfield_BoxIsSolid(global_humans[i].x1_, global_humans[i].y1_, global_humans[i].x1_ + HUMAN_SPRITE_WIDTH, global_humans[i].y1_ + HUMAN_SPRITE_HEIGHT));
 		
 		// set a random starting direction
 		Object_SetDirection(&global_humans[i], App_GetRandom(8) - 1, HUMAN_SPEED, HUMAN_L_SHIFT_PER_SHAPE);
@@ -217,11 +256,14 @@ void Level_PlacePlayer(void)
 {
 	Coordinate 	new_location;
 	
-	// TODO: check not being placed on top of human, or on top of obstacle, chip, etc.
+	// TODO: check not being placed on top of human, or on top of chip, etc.
 	
-	// pick a legal place within the playfield, which has 32 pix boundary on all sides for sprites.
-	new_location.x = App_GetRandom(LEVEL_MAX_X - LEVEL_MIN_X) + LEVEL_MIN_X;
-	new_location.y = App_GetRandom(LEVEL_MAX_Y - LEVEL_MIN_Y) + LEVEL_MIN_Y;
+	// pick a legal place within the playfield, which has 32 pix boundary on all sides for sprites, and not in a wall
+	do
+	{
+		new_location.x = App_GetRandom(LEVEL_MAX_X - LEVEL_MIN_X) + LEVEL_MIN_X;
+		new_location.y = App_GetRandom(LEVEL_MAX_Y - LEVEL_MIN_Y) + LEVEL_MIN_Y;
+	} while (Playfield_BoxIsSolid(new_location.x, new_location.y, new_location.x + PLAYER_SPRITE_WIDTH, new_location.y + PLAYER_SPRITE_HEIGHT));
 	
 	// set object's location
 	Player_MoveToLocation(&new_location);
@@ -234,84 +276,134 @@ void Level_PlacePlayer(void)
 // needs to be in MAIN because it temporarily maps EM data into the overlay slot
 void Level_MakeTileBloody(uint16_t x, uint16_t y)
 {
-	uint16_t	tile_map_grid_addr;
+	uint8_t		the_col;
+	uint8_t		the_row;
 	uint8_t		prev_value;
-	
+
 	// LOGIC:
-	//   the tile map is at TILEMAP_PHYS_ADDR
-	//   the tile map is 20x15, with each grid being 16x16 px
-	//   x and y are 0-319 and 0-239 (except they are +32,+32 because of sprite offset)
-	//   x/16 and y/16 should get us to the right area
-	//   x/16 + y/16*20 = the tile EXCEPT that tilemap uses 2 bytes for each, so need to double that. 
-	//   to make a grid bloody, we just add 1 to it, as tiles are arranged clean-dirty-clean-dirty-etc.
-	//   if tile already has a non-even number in it, don't change it. 
-	
+	//   x and y are world pixels (+32,+32 because of sprite offset); each tile is 16x16 px
+	//   to make a tile bloody, we just add 1 to it, as tiles are arranged clean-dirty-clean-dirty-etc.
+	//   if tile already has a non-even number in it, don't change it.
+	//   Playfield updates the world map, and the screen too if that tile is in view
+
 	// account for 32 px offset sprites use
 	x -= 32;
 	y -= 32;
-	
-	// reduce to linear offset, multiplying by 2 to account for tilemap values being 2-byte
-	tile_map_grid_addr = (x/16 + (y/16 * 20)) * 2;
-	
-	//DEBUG_OUT(("%s %d: tile_map_grid_addr=%x, x=%u, y=%u, col=%u, row=%u", __func__, __LINE__, tile_map_grid_addr, x, y,  x/16, y/16));
-	
-	tile_map_grid_addr += TILEMAP_ADDR_IN_CPU_SPACE;
-	
-	//DEBUG_OUT(("%s %d: tile_map_grid_addr=%x after adding TILEMAP_ADDR_IN_CPU_SPACE", __func__, __LINE__, tile_map_grid_addr));
-	
-	// map in the EM bank holding the tilemap
-	App_LoadOverlay(TILEMAP_VALUE);
-	
-	prev_value = R8(tile_map_grid_addr);
+
+	the_col = x / PLAYFIELD_TILE_SIZE;
+	the_row = y / PLAYFIELD_TILE_SIZE;
+
+	//DEBUG_OUT(("%s %d: x=%u, y=%u, col=%u, row=%u", __func__, __LINE__, x, y, the_col, the_row));
+
+	prev_value = Playfield_GetTile(the_col, the_row);
 
 	//DEBUG_OUT(("%s %d: prev-value=%u", __func__, __LINE__, prev_value));
 
 	if (prev_value % 2 == 0)
 	{
-		++prev_value;
-		R8(tile_map_grid_addr) = prev_value;
-	}	
+		Playfield_SetTile(the_col, the_row, prev_value + 1);
+	}
 }
 
 
 // Reset the tilemap to initial conditions: the no-gore tiles
 void Level_ResetTileMap(void)
 {
-	uint16_t	tile_map_grid_addr;
-	uint16_t	i;
-	uint8_t		prev_value;
-	
 	// LOGIC:
-	//   the tile map is at TILEMAP_PHYS_ADDR
-	//   the tile map is 20x15, with each grid being 16x16 px
-	//   to make a grid bloody, we added 1 to it, as tiles are arranged clean-dirty-clean-dirty-etc.
-	//   if tile already doesn't have a non-even number in it, don't change it. 
+	//   the TILEMAP asset is never bloodied itself; the world map is rebuilt from it each game.
+	//   it goes on screen once the player has been placed and the camera knows where to look.
+
+	Playfield_BuildWorldMap();
+}
+
+
+// add a VICKY register image of a sprite to the frame being built, moving it from world to screen coordinates on the way
+// sprites off screen are turned off
+void Level_SnapshotSprite(Sprite* the_sprite)
+{
+	uint8_t*	the_reg = present_sprite_tail->regs_;
+	uint16_t	the_x;
+	uint16_t	the_y;
+
+	// LOGIC:
+	//   unsigned subtract: a sprite left of/above the camera wraps to a huge value, so one compare per axis culls both sides.
+	//   anything at LEVEL_SPRITE_CULL_X/Y or more can't show any pixels.
+	the_x = the_sprite->x1_ - global_camera_x;
+	the_y = the_sprite->y1_ - global_camera_y;
+
+	memcpy(the_reg, the_sprite, 4);	// state, addr lo/med/hi
+
+	if (the_x >= LEVEL_SPRITE_CULL_X || the_y >= LEVEL_SPRITE_CULL_Y)
+	{
+		the_reg[0] = the_sprite->state_ & ~SPRITE_STATE_ON;
+	}
+
+	the_reg[4] = the_x & 0xFF;
+	the_reg[5] = the_x >> 8;
+	the_reg[6] = the_y & 0xFF;
+	the_reg[7] = the_y >> 8;
+
+	present_sprite_tail->reg_addr_ = the_sprite->sprite_reg_addr_;
+	++present_sprite_tail;
+}
+
+
+
+
+
+// point each live human at the player, along the flow field. humans it has no direction for keep going.
+void Level_SteerHumans(void)
+{
+	uint8_t		the_direction;
 	
-	tile_map_grid_addr = TILEMAP_ADDR_IN_CPU_SPACE;
+	// LOGIC:
+	//   FlowField_Update() already paid for the search this frame. all a human costs here is a handful of table reads,
+	//   and a direction change (new speed and shape) only when it turns. runs before either version of the update
+	//   loops, so the C and asm loops see the same directions.
 	
-	//DEBUG_OUT(("%s %d: tile_map_grid_addr=%x after adding TILEMAP_ADDR_IN_CPU_SPACE", __func__, __LINE__, tile_map_grid_addr));
+	App_LoadOverlay(PLAYFIELD_BANK);	// the flow field's tables are in there
 	
-	// map in the EM bank holding the tilemap
-	App_LoadOverlay(TILEMAP_VALUE);
+	zp_sprite = global_humans;
 	
-	for (i = 0; i < TILEMAP_LEN; i++)
+	for (zp_sprite_idx = 0; zp_sprite_idx < LEVEL_MAX_HUMANS; zp_sprite_idx++, zp_sprite++)
 	{
-		prev_value = R8(tile_map_grid_addr);
-	
-		//DEBUG_OUT(("%s %d: prev-value=%u", __func__, __LINE__, prev_value));
-	
-		if (prev_value % 2 != 0)
+		if (zp_sprite->is_active_ == 1)
 		{
-			--prev_value;
-			R8(tile_map_grid_addr) = prev_value;
+			the_direction = FlowField_GetDirection(zp_sprite->x1_, zp_sprite->y1_, zp_sprite->direction_);
+			
+			if (the_direction != FLOW_FIELD_NO_DIRECTION && the_direction != zp_sprite->direction_)
+			{
+				Object_SetDirection(zp_sprite, the_direction, HUMAN_SPEED, HUMAN_L_SHIFT_PER_SHAPE);
+			}
 		}
-		
-		++tile_map_grid_addr;
 	}
-	
 }
 
 
+// point a missile about to be fired at the bullet graphic for the current weapon
+void Level_SetMissileGraphic(Sprite* the_missile)
+{
+	uint8_t		the_bank;
+
+	// LOGIC:
+	//   heavy weapons fire the large bullet, once Level_LoadMissileGraphic() has streamed it in. until it's resident
+	//   (or if it couldn't be loaded), they fire the small bullet like the rest. VICKY reads sprite graphics from
+	//   anywhere in RAM, so once it's in, the missile just points at the stream bank.
+	if (Player_GetWeaponID() >= PLAYER_WEAPON_HEAVY_MG && level_bullet_l_set != STREAM_INVALID_HANDLE)
+	{
+		if (Stream_IsResident(level_bullet_l_set))
+		{
+			Stream_Touch(level_bullet_l_set);
+			the_bank = Stream_GetBank(level_bullet_l_set);
+			the_missile->addr_hi_ = the_bank >> 3;							// bank * 0x2000, bits 16-23
+			the_missile->addr_base_lomed_ = (uint16_t)(the_bank & 0x07) << 13;	// bank * 0x2000, bits 0-15
+			return;
+		}
+	}
+
+	the_missile->addr_hi_ = SPRITE_BULLET_S_HI_ADDR;
+	the_missile->addr_base_lomed_ = SPRITE_BULLET_S_LOMED_ADDR;
+}
 
 
 
@@ -333,8 +425,10 @@ void Level_Initialize(void)
 	// reset tilemap in case it got bloodied by previous game
 	Level_ResetTileMap();
 	
-	// place player
+	// place player, and put the camera (and the part of the world it sees) on them
 	Level_PlacePlayer();
+	Playfield_SnapToPlayer();
+	FlowField_Reset();
 	
 	// place chips, clips, and poo
 	
@@ -377,25 +471,29 @@ void Level_Initialize(void)
 // checks current velocity and resets if human has hit edge of screen
 void Level_UpdateSprites(void)
 {
-	uint8_t			i;
-	uint8_t			j;
-	uint8_t			temp_frame_saver;
-	Rectangle		player_box;
+	// LOGIC:
+	//   the loop indices, the sprite being worked on, and the player's box live in zero page (zp_layout.txt).
+	//   walking a zero page Sprite* instead of indexing global_humans[i] turns every field access into one (zp),y,
+	//   instead of a multiply-by-sizeof + add through the C stack.
 	
-	player_box.x1 = zp_px;
-	player_box.y1 = zp_py;
-	player_box.x2 = zp_px + PLAYER_SPRITE_WIDTH;
-	player_box.y2 = zp_py + PLAYER_SPRITE_HEIGHT;
+	zp_player_box.x1 = zp_px;
+	zp_player_box.y1 = zp_py;
+	zp_player_box.x2 = zp_px + PLAYER_SPRITE_WIDTH;
+	zp_player_box.y2 = zp_py + PLAYER_SPRITE_HEIGHT;
 	
-	for (i=0; i < LEVEL_MAX_HUMANS; i++)
+	Level_SteerHumans();
+	
+	zp_sprite = global_humans;
+	
+	for (zp_sprite_idx = 0; zp_sprite_idx < LEVEL_MAX_HUMANS; zp_sprite_idx++, zp_sprite++)
 	{
-		if (global_humans[i].is_active_ == 1)
+		if (zp_sprite->is_active_ == 1)
 		{
 
-			//DEBUG_OUT(("%s %d: human %u is active", __func__, __LINE__, i));
+			//DEBUG_OUT(("%s %d: human %u is active", __func__, __LINE__, zp_sprite_idx));
 
 			// check if this human got run over by player
-			if (Object_CollisionCheck(&global_humans[i], &player_box) == true)
+			if (Object_CollisionCheck(zp_sprite, &zp_player_box) == true)
 			{
 				// splat!
 				Player_TakeDamage(PLAYER_DAMAGE_FROM_SLIMING);
@@ -405,58 +503,56 @@ void Level_UpdateSprites(void)
 				zp_points += POINTS_PER_HUMAN;
 				
 				// mark object as dead
-				global_humans[i].is_active_ = 0;
-				global_humans[i].x_speed_ = 0;
-				global_humans[i].y_speed_ = 0;
-				global_humans[j].render_needed_ = 1;
+				zp_sprite->is_active_ = 0;
+				zp_sprite->x_speed_ = 0;
+				zp_sprite->y_speed_ = 0;
+				zp_sprite->render_needed_ = 1;
 				
 				// hide the sprite, and mark the tile it was on as bloody
-				Level_MakeTileBloody(global_humans[i].x1_, global_humans[i].y1_);
+				Level_MakeTileBloody(zp_sprite->x1_, zp_sprite->y1_);
 			}
 			else
 			{
 				// this human is still alive.
 				
 				// attempt to move human in direction it was going. 
-				Object_Move(&global_humans[i]);
+				Object_Move(zp_sprite);
 				
 				// check if move above caused human to be blocked by screen bounds, objects, etc.
-				if (Object_MoveIsValid(&global_humans[i]) == false)
+				if (Object_MoveIsValid(zp_sprite) == false)
 				{
 					// blocked for this turn. pick a random new direction and get sprite speed and graphics updated
-					//global_humans[i].x_speed_ = 4 - (App_GetRandom(3) * 2);		// end up with -2, 0, or +2 for this vector
-					//global_humans[i].y_speed_ = 4 - (App_GetRandom(3) * 2);		// end up with -2, 0, or +2 for this vector
-					Object_SetDirection(&global_humans[i], App_GetRandom(8) - 1, HUMAN_SPEED, HUMAN_L_SHIFT_PER_SHAPE);					
+					//zp_sprite->x_speed_ = 4 - (App_GetRandom(3) * 2);		// end up with -2, 0, or +2 for this vector
+					//zp_sprite->y_speed_ = 4 - (App_GetRandom(3) * 2);		// end up with -2, 0, or +2 for this vector
+					Object_SetDirection(zp_sprite, App_GetRandom(8) - 1, HUMAN_SPEED, HUMAN_L_SHIFT_PER_SHAPE);					
 				}
 				
-				// check if it needs an anim change.
-				//if ( (zp_ticktock % HUMAN_SPRITE_TICKTOCK_DIVISOR) == 0)
-				if ( ((global_humans[i].x1_ + global_humans[i].y1_) % 8) == 0)
-				{
-					// toggle anim cell to the other
-					temp_frame_saver = global_humans[i].addr_med_;
-					global_humans[i].addr_med_ = global_humans[i].addr_med_alt_;
-					global_humans[i].addr_med_alt_ = temp_frame_saver;
-				}
+				// flip to the other anim cell if its countdown ran out
+				ANIM_TICK_SPRITE(zp_sprite, HUMAN_FRAMES_PER_ANIM_CELL);
 			}
 
-			global_humans[i].render_needed_ = 1;
+			zp_sprite->render_needed_ = 1;
 		}
 	}
 
-	for (i=0; i < LEVEL_MAX_MISSILES; i++)
+	zp_sprite = global_missiles;
+	
+	for (zp_sprite_idx = 0; zp_sprite_idx < LEVEL_MAX_MISSILES; zp_sprite_idx++, zp_sprite++)
 	{
-		if (global_missiles[i].is_active_ == 1)
+		if (zp_sprite->is_active_ == 1)
 		{
 
-			DEBUG_OUT(("%s %d: missile %u is active @ %u,%u", __func__, __LINE__, i, global_missiles[i].x1_, global_missiles[i].y1_));
+			DEBUG_OUT(("%s %d: missile %u is active @ %u,%u", __func__, __LINE__, zp_sprite_idx, zp_sprite->x1_, zp_sprite->y1_));
 
-			// check if this missile hit any humans
-			for (j=0; j < LEVEL_MAX_HUMANS; j++)
+			// check if this missile hits any humans between here and where it's about to move to. a missile moves
+			// about as far as a human is wide, so testing only where it lands would let it jump past them.
+			zp_other = global_humans;
+			
+			for (zp_other_idx = 0; zp_other_idx < LEVEL_MAX_HUMANS; zp_other_idx++, zp_other++)
 			{
-				if (global_humans[j].is_active_ == true)
+				if (zp_other->is_active_ == true)
 				{
-					if (Object_CollisionCheck(&global_missiles[i], (Rectangle*)&global_humans[j].x1_) == true)
+					if (Object_SweptCollisionCheck(zp_sprite, (Rectangle*)&zp_other->x1_) == true)
 					{
 						// player successfully shot a human
 						zp_points += POINTS_PER_HUMAN;
@@ -464,96 +560,90 @@ void Level_UpdateSprites(void)
 						//Buffer_NewMessage("Bite my shiny ass, fleshbag!");
 	
 						// mark object as dead
-						global_humans[j].is_active_ = 0;
-						global_humans[j].x_speed_ = 0;
-						global_humans[j].y_speed_ = 0;
-						global_humans[j].render_needed_ = 1;
+						zp_other->is_active_ = 0;
+						zp_other->x_speed_ = 0;
+						zp_other->y_speed_ = 0;
+						zp_other->render_needed_ = 1;
 						// hide the sprite, and mark the tile it was on as bloody
-						Level_MakeTileBloody(global_humans[j].x1_, global_humans[j].y1_);
+						Level_MakeTileBloody(zp_other->x1_, zp_other->y1_);
 						
 						// inactivate this missile so it can be used again
-						global_missiles[i].is_active_ = 0;
-						global_missiles[i].x_speed_ = 0;
-						global_missiles[i].y_speed_ = 0;
+						zp_sprite->is_active_ = 0;
+						zp_sprite->x_speed_ = 0;
+						zp_sprite->y_speed_ = 0;
 					}
 				}
 			}
 			
-			if (global_missiles[i].is_active_ == 1)
+			if (zp_sprite->is_active_ == 1)
 			{
 				// this missile is still tracking
 				
 				// attempt to move missile in direction it was going. 
-				Object_Move(&global_missiles[i]);
+				Object_Move(zp_sprite);
 				
 				// check if move above caused missile to be blocked by screen bounds, objects, etc.
-				if (Object_MoveIsValid(&global_missiles[i]) == false)
+				if (Object_MoveIsValid(zp_sprite) == false)
 				{
 					// blocked. make inactive and remove from scene
-					global_missiles[i].is_active_ = 0;
+					zp_sprite->is_active_ = 0;
 				}
 			}
 
-			global_missiles[i].render_needed_ = 1;
+			zp_sprite->render_needed_ = 1;
 		}
 	}
 }
 
-// render all active non-player sprites that need render update
-// this is the only function that actually touches the sprite registers
+// render all active non-player sprites that need render update, as register images in the Present frame being built
+// VICKY gets them at the next Present flush
 void Level_RenderSprites(void)
 {
-	uint8_t		i;
-
-	for (i=0; i < LEVEL_MAX_HUMANS; i++)
+	zp_sprite = global_humans;
+	
+	for (zp_sprite_idx = 0; zp_sprite_idx < LEVEL_MAX_HUMANS; zp_sprite_idx++, zp_sprite++)
 	{
-		if (global_humans[i].render_needed_ == 1)
+		if (zp_sprite->render_needed_ == 1)
 		{
 			// do we need to turn it off on or?
-			if (global_humans[i].is_active_ == 1)
+			if (zp_sprite->is_active_ == 1)
 			{
-				global_humans[i].state_ = 0x41;	// $40=16x16 sprite; 1 = on
+				zp_sprite->state_ = SPRITE_STATE_16X16 | SPRITE_STATE_ON;
 			}
 			else
 			{
-				global_humans[i].state_ = 0x40;	// $40=16x16 sprite; 0 = off
+				zp_sprite->state_ = SPRITE_STATE_16X16;
 			}
 
-			//DEBUG_OUT(("%s %d: about to copy human %u data to vicky: reg=%p, to copy=%p", __func__, __LINE__, i, global_humans[i].sprite_reg_addr_, &global_humans[i]));
+			//DEBUG_OUT(("%s %d: about to copy human %u data to vicky: reg=%p, to copy=%p", __func__, __LINE__, zp_sprite_idx, zp_sprite->sprite_reg_addr_, zp_sprite));
 			
-			Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-			memcpy(global_humans[i].sprite_reg_addr_, &global_humans[i], SPRITE_REG_LEN);
-			Sys_DisableIOBank();
+			Level_SnapshotSprite(zp_sprite);
 
-			//DEBUG_OUT(("%s %d: copied human %u data to vicky: reg=%p, to copy=%p", __func__, __LINE__, i, global_humans[i].sprite_reg_addr_, &global_humans[i]));
-			
-			global_humans[i].render_needed_ = 0;
+			zp_sprite->render_needed_ = 0;
 		}		
 	}
 
-	for (i=0; i < LEVEL_MAX_MISSILES; i++)
+	zp_sprite = global_missiles;
+	
+	for (zp_sprite_idx = 0; zp_sprite_idx < LEVEL_MAX_MISSILES; zp_sprite_idx++, zp_sprite++)
 	{
-		if (global_missiles[i].render_needed_ == 1)
+		if (zp_sprite->render_needed_ == 1)
 		{
 			// do we need to turn it off on or?
-			if (global_missiles[i].is_active_ == 1)
+			if (zp_sprite->is_active_ == 1)
 			{
-				global_missiles[i].state_ = 0x61;	// $60=8x8 sprite; 1 = on
+				zp_sprite->state_ = SPRITE_STATE_8X8 | SPRITE_STATE_ON;
 			}
 			else
 			{
-				global_missiles[i].state_ = 0x60;	// $60=8x8 sprite; 0 = off
+				zp_sprite->state_ = SPRITE_STATE_8X8;
 			}
 
-			//DEBUG_OUT(("%s %d: about to copy missile %u data to vicky: reg=%p, to copy=%p", __func__, __LINE__, i, global_missiles[i].sprite_reg_addr_, &global_missiles[i]));
+			//DEBUG_OUT(("%s %d: about to copy missile %u data to vicky: reg=%p, to copy=%p", __func__, __LINE__, zp_sprite_idx, zp_sprite->sprite_reg_addr_, zp_sprite));
 			
-			Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-			memcpy(global_missiles[i].sprite_reg_addr_, &global_missiles[i], SPRITE_REG_LEN);
-			Sys_DisableIOBank();
+			Level_SnapshotSprite(zp_sprite);
 
-			//DEBUG_OUT(("%s %d: copied missile %u data to vicky: reg=%p, to copy=%p", __func__, __LINE__, i, global_missiles[i].sprite_reg_addr_, &global_missiles[i]));
-			
-			global_missiles[i].render_needed_ = 0;
+			zp_sprite->render_needed_ = 0;
 		}		
 	}
 }
@@ -586,6 +676,7 @@ bool Level_PlayerAttemptShoot(void)
 				global_missiles[i].x2_ = zp_px + MISSILE_SPRITE_WIDTH;
 				global_missiles[i].y2_ = zp_py + MISSILE_SPRITE_HEIGHT;
 				
+				Level_SetMissileGraphic(&global_missiles[i]);
 				Object_SetDirection(&global_missiles[i], zp_player_dir, MISSILE_SPEED, MISSILE_L_SHIFT_PER_SHAPE);					
 	
 				global_missiles[i].is_active_ = 1;
@@ -603,11 +694,11 @@ bool Level_PlayerAttemptShoot(void)
 		// clip is empty. any other clips for this weapon?
 		if (Player_Reload() == true)
 		{
-			Buffer_NewMessage("Changing clips");
+			Buffer_NewMessage(General_GetString(ID_STR_MSG_CHANGING_CLIPS));
 		}
 		else
 		{
-			Buffer_NewMessage("<click>");
+			Buffer_NewMessage(General_GetString(ID_STR_MSG_CLICK));
 		}
 	}
 	
@@ -615,6 +706,20 @@ bool Level_PlayerAttemptShoot(void)
 }
 
 
+// the player has switched to the_weapon_id: start streaming in its bullet graphic, if it has its own and it isn't in yet
+void Level_LoadMissileGraphic(uint8_t the_weapon_id)
+{
+	// LOGIC:
+	//   the large bullet is only needed if the player ever picks a heavy weapon, so it isn't asked for until then.
+	//   picking the weapon is some time ahead of having ammo for it and firing, which is plenty for a 512 byte file.
+	//   a failed load keeps its handle, so it isn't tried again every time the weapons go round.
+	if (the_weapon_id >= PLAYER_WEAPON_HEAVY_MG && level_bullet_l_set == STREAM_INVALID_HANDLE)
+	{
+		level_bullet_l_set = Stream_Request(LEVEL_BULLET_L_FILE, LEVEL_BULLET_L_BANKS);
+	}
+}
+
+
 // **** OTHER FUNCTIONS *****
 
 
@@ -35,6 +35,7 @@
 // #include "object.h"
 // #include "monster.h"
 #include "general.h"
+#include "playfield.h"
 
 // C includes
 #include <stdbool.h>
@@ -49,8 +50,12 @@
 
 #define LEVEL_MIN_X		32			// sprites partially off screen at values closer to edge than this
 #define LEVEL_MIN_Y		32			// sprites partially off screen at values closer to edge than this
-#define LEVEL_MAX_X		(320+16)	// sprites partially off screen at values closer to edge than this
-#define LEVEL_MAX_Y		(240+16)	// sprites partially off screen at values closer to edge than this
+#define LEVEL_MAX_X		(PLAYFIELD_WORLD_WIDTH+16)	// world coords: sprites partially off the world's edge at values closer to it than this
+#define LEVEL_MAX_Y		(PLAYFIELD_WORLD_HEIGHT+16)	// world coords: sprites partially off the world's edge at values closer to it than this
+
+// screen coords: a sprite at or past these can't show any pixels (screen + the sprite offset)
+#define LEVEL_SPRITE_CULL_X		(PLAYFIELD_SCREEN_WIDTH + PLAYFIELD_SPRITE_OFFSET)
+#define LEVEL_SPRITE_CULL_Y		(PLAYFIELD_SCREEN_HEIGHT + PLAYFIELD_SPRITE_OFFSET)
 
 // 64 max sprites. player uses 1. 
 #define LEVEL_MAX_MISSILES				33 // max number of missiles that can appear in the game at once. need to balance player and monster firing accordingly.
@@ -167,8 +172,8 @@ void Level_Initialize(void);
 // checks current velocity and resets if human has hit edge of screen
 void Level_UpdateSprites(void);
 
-// render all active non-player sprites that need render update
-// this is the only function that actually touches the sprite registers
+// render all active non-player sprites that need render update, as register images in the Present frame being built
+// VICKY gets them at the next Present flush
 void Level_RenderSprites(void);
 
 
@@ -181,6 +186,9 @@ void Level_RenderSprites(void);
 // player wants to shoot: see if a missile is available, if player's gun is full, if refire time is up, etc. 
 bool Level_PlayerAttemptShoot(void);
 
+// the player has switched to the_weapon_id: start streaming in its bullet graphic, if it has its own and it isn't in yet
+void Level_LoadMissileGraphic(uint8_t the_weapon_id);
+
 
 // // iterates through the complete level monster array looking for the ACTIVE monster that matches the coordinate and char passed
 // Object* Level_FindActiveMonsterByLoc(Coordinate* the_location);
@@ -23,26 +23,6 @@
 ;	.export _Memory_FillWithDMA
 ;	.export _Memory_DebugOut
 
-; ZP_LK exports:
-	.exportzp	_zp_bank_slot
-	.exportzp	_zp_bank_num
-	.exportzp	_zp_old_bank_num
-	.exportzp	_zp_old_io_page
-	.exportzp	_zp_px
-	.exportzp	_zp_py
-	.exportzp	_zp_joy
-	.exportzp	_zp_num_bullets
-	.exportzp	_zp_num_clips
-	.exportzp	_zp_num_warps
-	.exportzp	_zp_speed
-	.exportzp	_zp_points
-	.exportzp	_zp_hp
-	.exportzp	_zp_bullet_dmg
-	.exportzp	_zp_player_dir
-	.exportzp	_zp_lives
-	.exportzp	_zp_player_dir_prev
-	.exportzp	_zp_ticktock
-	
 
 ; F256 DMA addresses and bit values
 
@@ -62,28 +42,8 @@ DMA_COUNT = $DF0C		; Number of bytes to fill or copy
 
 
 
-.segment "ZEROPAGE_LK" : zeropage
-
-; -- ZErOPAGE_LK starts at $10, size = $2c;
-
-_zp_bank_slot:			.res 1	; $10
-_zp_bank_num:			.res 1
-_zp_old_bank_num:		.res 1
-_zp_old_io_page:		.res 1	; 
-_zp_px:					.res 2
-_zp_py:					.res 2
-_zp_joy:				.res 1
-_zp_num_bullets:		.res 1
-_zp_num_clips:			.res 1
-_zp_num_warps:			.res 1
-_zp_speed:				.res 1
-_zp_points:				.res 2	
-_zp_hp:					.res 1
-_zp_bullet_dmg:			.res 1
-_zp_player_dir:			.res 1
-_zp_lives:				.res 1
-_zp_player_dir_prev:	.res 1
-_zp_ticktock:			.res 2
+; ZP_LK variables: layout comes from zp_layout.txt, via tools/zp_layout.py
+	.include "zp_layout.inc"
 	
 ; ---------------------------------------------------------------
 ; uint8_t __fastcall__ Memory_SwapInNewBank(uint8_t the_bank_slot)
@@ -180,8 +140,8 @@ _zp_ticktock:			.res 2
 ; uint8_t __fastcall__ Memory_GetMappedBankNum(void)
 ; ---------------------------------------------------------------
 ;// call to a routine in memory.asm that returns whatever is currently mapped in the specified MMU slot
-;// set zp_bank_num before calling.
-;// returns the slot that had been mapped previously
+;// set zp_bank_slot before calling.
+;// returns the bank number mapped in that slot
 
 .segment	"CODE"
 
@@ -191,7 +151,7 @@ _zp_ticktock:			.res 2
 
 	SEI						; disable IRQs just in case one hits in the middle if MMU mapping
 	
-	TAX						; get the lut slot (0-7) we want to remap
+	LDX _zp_bank_slot		; get the lut slot (0-7) we want to read (void function: A has nothing in it)
 
 							
 .ifdef _SIMULATOR_			; emulator seems to start with LUT0, but kernel on machine with lut3. not sure why emulator is different
@@ -201,9 +161,17 @@ _zp_ticktock:			.res 2
 .endif
 	STA $0000				; make the change
 
-	LDA $0008,x				; get the current value of the bank we're about to remap
+	LDY $0008,x				; get the current value of the bank in that slot
+
+.ifdef _SIMULATOR_			; emulator seems to start with LUT0, but kernel on machine with lut3. not sure why emulator is different
+	LDA #$00				; Select LUT#0 as active, turn off editing
+.else
+	LDA #$33				; Select LUT#3 as active, turn off editing
+.endif
+	STA $0000
 	
 	; do the return. cc65 requires functions return a 16 bit value!
+	TYA
 	LDX #00
 
 	CLI						; safe to reenable IRQs now
@@ -25,6 +25,7 @@
 /*****************************************************************************/
 
 #include "app.h"
+#include "zp_layout.h"
 
 
 /*****************************************************************************/
@@ -34,24 +35,7 @@
 #define PARAM_FOR_ATTR_MEM	true	// param for functions updating VICKY screen memory: make it affect color/attribute memory
 #define PARAM_FOR_CHAR_MEM	false	// param for functions updating VICKY screen memory: make it affect character memory
 
-#define ZP_BANK_SLOT		0x10	// zero-page address holding the LUT slot to be modified (0-7) (eg, if 0, will be $08,if 1, $09, etc.)
-#define ZP_BANK_NUM			0x11	// zero-page address holding the new LUT bank# to be set in the ZP_BANK_SLOT
-#define ZP_OLD_BANK_NUM		0x12	// zero-page address holding the original LUT bank # before being changed
-#define ZP_OLD_IO_PAGE		0x13	// zero-page address holding the original IO page # before being changed
-#define ZP_PX				0x14	// zero-page address holding the 2-byte x coord for player
-#define ZP_PY				0x16	// zero-page address holding the 2-byte y coord for player
-#define ZP_JOY				0x18	// zero-page address holding the current state of the joysticks (both mapped to same thing; single-player game)
-#define ZP_NUM_BULLETS		0x19	// zero-page address holding the 1-byte count of bullets left in current clip for the current weapon
-#define ZP_NUM_CLIPS		0x20	// zero-page address holding the 1-byte count of clips for the current weapon
-#define ZP_NUM_WARPS		0x1b	// zero-page address holding the 1-byte count of warp modules owned by player
-#define ZP_SPEED			0x1c	// zero-page address holding the 1-byte num. pixels that player moves per round
-#define ZP_POINTS			0x1d	// zero-page address holding the 2-byte point count 
-#define ZP_HP				0x1e	// zero-page address holding the 1-byte count of HP remaining
-#define ZP_BULLET_DMG		0x1f	// zero-page address holding the 1-byte count of damage to be caused by each bullet of current player weapon
-#define ZP_PLAYER_DIR		0x20	// zero-page address holding the 1-byte direction player is facing. 0=north, 1=east, 2=south, 3=west. for showing which icon to use.
-#define ZP_LIVES			0x21	// zero-page address holding the 1-byte count of remaining lives before end of game. if 0, and player's HP runs out, game is over.
-#define ZP_PLAYER_DIR_PREV	0x22	// zero-page address holding the 1-byte direction player was facing last time checked
-#define ZP_TICKTOCK			0x23	// zero-page address holding the 1-byte tick-tock frame counter used to flip sprite animations from cell0 to cell1
+// ZP_* addresses of the zero page variables in memory.asm: zp_layout.h, generated from zp_layout.txt
 
 
 // starting point for all storage to extended memory. if larger than 8K, increment as necessary
@@ -61,6 +45,10 @@
 #define EM_STORAGE_START_SLOT				0x05		// the 0-7 local CPU slot to map it into - overlay slot
 #define EM_STORAGE_START_PHYS_BANK_NUM		0x14		// the system physical bank number/slot where EM storage starts for us.
 
+// banks that asset_stream.c loads files into on demand: right after the EM storage bank, and ending before the strings bank (0x20)
+#define EM_STREAM_FIRST_PHYS_BANK_NUM		(EM_STORAGE_START_PHYS_BANK_NUM + 1)	// 0x15 = phys 0x2A000
+#define EM_STREAM_NUM_BANKS					11			// 0x15-0x1F: 88K. keep pgz_manifest.txt ASSET_STREAM in sync
+
 
 /*****************************************************************************/
 /*                               Enumerations                                */
@@ -92,8 +80,8 @@ uint8_t __fastcall__ Memory_SwapInNewBank(uint8_t the_bank_slot);
 void __fastcall__ Memory_RestorePreviousBank(uint8_t the_bank_slot);
 
 // call to a routine in memory.asm that returns whatever is currently mapped in the specified MMU slot
-// set zp_bank_num before calling.
-// returns the slot that had been mapped previously
+// set zp_bank_slot before calling.
+// returns the bank number mapped in that slot
 uint8_t __fastcall__ Memory_GetMappedBankNum(void);
 
 // call to a routine in memory.asm that writes an illegal opcode followed by address of debug buffer
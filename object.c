@@ -16,7 +16,6 @@
 
 // project includes
 #include "object.h"
-#include "api.h"
 #include "app.h"
 #include "general.h"
 #include "kernel.h"
@@ -45,21 +44,28 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_OBJECT
+
 
 
 /*****************************************************************************/
 /*                           File-scope Variables                            */
 /*****************************************************************************/
 
+static int16_t				object_sweep_first;		// Object_SweptCollisionCheck(): the steps of the move that hit so far
+static int16_t				object_sweep_last;
 
 
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+// x2_/y2_ are this far from x1_/y1_, by OBJECT_TYPE_*.
+const uint8_t				object_hitbox_width[OBJECT_NUM_TYPES] = {16, 16, 16, MISSILE_SPRITE_WIDTH, HUMAN_SPRITE_WIDTH};
+const uint8_t				object_hitbox_height[OBJECT_NUM_TYPES] = {16, 16, 16, MISSILE_SPRITE_HEIGHT, HUMAN_SPRITE_HEIGHT};
+
 extern Player*				global_player;
 
-extern char*				global_string[NUM_STRINGS];
 extern char*				global_string_buff1;
 // extern char*				global_string_buff2;
 
@@ -98,11 +104,27 @@ extern int8_t				zp_lives;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// Object_SweptCollisionCheck(): narrow the steps that can hit to those from the_first to the_last
+static void Object_NarrowSweep(int16_t the_first, int16_t the_last);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// Object_SweptCollisionCheck(): narrow the steps that can hit to those from the_first to the_last
+static void Object_NarrowSweep(int16_t the_first, int16_t the_last)
+{
+	if (the_first > object_sweep_first)
+	{
+		object_sweep_first = the_first;
+	}
+	
+	if (the_last < object_sweep_last)
+	{
+		object_sweep_last = the_last;
+	}
+}
 
 
 
@@ -226,6 +248,64 @@ bool Object_CollisionCheck(Sprite* the_object, Rectangle* r2)
 }
 
 
+// check if the object's rectangle touches the passed rectangle anywhere along its next move (x_speed_, y_speed_),
+// including where it is now. one test, exact however fast it's going.
+bool Object_SweptCollisionCheck(Sprite* the_object, Rectangle* r2)
+{
+	int16_t		the_near;
+	int16_t		the_far;
+	
+	// LOGIC:
+	//   objects only move in the 8 directions, so an axis that moves at all moves as far as the other one does.
+	//   count the move in pixels along it (steps). on a moving axis, the object overlaps r2 from the step its leading
+	//   edge reaches r2's near side until the step its trailing edge passes r2's far side: each just a subtraction.
+	//   it's a hit if those ranges and 0..the length of the move have a step in common. no dividing, and no stepping
+	//   a pixel at a time. an axis that doesn't move is the plain overlap test.
+	
+	object_sweep_first = 0;
+	object_sweep_last = the_object->x_speed_ != 0 ? the_object->x_speed_ : the_object->y_speed_;
+	
+	if (object_sweep_last < 0)
+	{
+		object_sweep_last = -object_sweep_last;
+	}
+	
+	the_near = (int16_t)(r2->x1 - the_object->x2_);
+	the_far = (int16_t)(r2->x2 - the_object->x1_);
+	
+	if (the_object->x_speed_ > 0)
+	{
+		Object_NarrowSweep(the_near, the_far);
+	}
+	else if (the_object->x_speed_ < 0)
+	{
+		Object_NarrowSweep(-the_far, -the_near);
+	}
+	else if (the_near > 0 || the_far < 0)
+	{
+		return false;
+	}
+	
+	the_near = (int16_t)(r2->y1 - the_object->y2_);
+	the_far = (int16_t)(r2->y2 - the_object->y1_);
+	
+	if (the_object->y_speed_ > 0)
+	{
+		Object_NarrowSweep(the_near, the_far);
+	}
+	else if (the_object->y_speed_ < 0)
+	{
+		Object_NarrowSweep(-the_far, -the_near);
+	}
+	else if (the_near > 0 || the_far < 0)
+	{
+		return false;
+	}
+	
+	return object_sweep_first <= object_sweep_last;
+}
+
+
 
 // **** OTHER FUNCTIONS *****
 
@@ -235,8 +315,8 @@ void Object_Move(Sprite* the_object)
 {
 	the_object->x1_ += the_object->x_speed_;
 	the_object->y1_ += the_object->y_speed_;
-	the_object->x2_ = the_object->x1_ + HUMAN_SPRITE_WIDTH;
-	the_object->y2_ = the_object->y1_ + HUMAN_SPRITE_HEIGHT;
+	the_object->x2_ = the_object->x1_ + object_hitbox_width[the_object->type_id_];
+	the_object->y2_ = the_object->y1_ + object_hitbox_height[the_object->type_id_];
 }
 
 
@@ -267,6 +347,16 @@ bool Object_MoveIsValid(Sprite* the_object)
 		valid = false;
 	}
 	
+	// in bounds, but moved into a wall: back out of it
+	if (valid && Playfield_BoxIsSolid(the_object->x1_, the_object->y1_, the_object->x2_, the_object->y2_))
+	{
+		the_object->x1_ -= the_object->x_speed_;
+		the_object->y1_ -= the_object->y_speed_;
+		the_object->x2_ = the_object->x1_ + object_hitbox_width[the_object->type_id_];
+		the_object->y2_ = the_object->y1_ + object_hitbox_height[the_object->type_id_];
+		valid = false;
+	}
+	
 	return valid;
 }
 
@@ -43,6 +43,12 @@
 #define OBJECT_TYPE_POO						2
 #define OBJECT_TYPE_MISSILE					3
 #define OBJECT_TYPE_HUMAN					4
+#define OBJECT_NUM_TYPES					5		// size of object_hitbox_width/height
+
+// Sprite.state_: what goes in VICKY's sprite control register
+#define SPRITE_STATE_ON						0x01
+#define SPRITE_STATE_16X16					0x40
+#define SPRITE_STATE_8X8					0x60
 
 #define HUMAN_SPEED							2		// pixels per turn per vector a human can move. eg, 2 pixels in x or 2 pixels in y dir
 #define MISSILE_SPEED						16		// pixels per turn per vector a bullet/missile can move. 16=width of a player or human
@@ -82,6 +88,7 @@ typedef struct Sprite {
 	uint8_t		direction_;			// the direction the sprite is headed, 0-7. match to PLAYER_DIR_NORTH... PLAYER_DIR_NORTHWEST
 	uint8_t		addr_med_alt_;		// this is the alternate anim frame (if current is left leg, this is right leg, e.g.)
 	uint16_t	addr_base_lomed_;	// the LO+MED part of the base address of the sprite graphics
+	uint8_t		anim_countdown_;	// frames left before flipping to the alternate anim frame. see ANIM_TICK_SPRITE()
 } Sprite;
 
 
@@ -112,10 +119,15 @@ void Object_SetDirection(Sprite* the_object, uint8_t the_direction, uint8_t base
 // check if the rectangle describing the object's sprite is in collision with the passed rectangle
 bool Object_CollisionCheck(Sprite* the_object, Rectangle* r2);
 
+// check if the object's rectangle touches the passed rectangle anywhere along its next move (x_speed_, y_speed_),
+// including where it is now. one test, exact however fast it's going.
+bool Object_SweptCollisionCheck(Sprite* the_object, Rectangle* r2);
+
 
 // **** OTHER FUNCTIONS *****
 
 // change the x/y location based on the already programmed velocity. no bounds checking. no actual sprite updating.
+// x2_/y2_ follow, by the hitbox size for the object's type_id_.
 void Object_Move(Sprite* the_object);
 
 // check x and y to make sure they are inside playfield and not blocked by obstacle. return false if the object is blocked.
@@ -26,7 +26,10 @@
 #include "memory.h"
 #include "object.h"
 #include "player.h"
+#include "playfield.h"
+#include "replay.h"
 #include "sys.h"
+#include "telemetry.h"
 #include "text.h"
 #include "strings.h"
 
@@ -36,6 +39,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#if defined(PGZ_ASSETS_LZ4) && !defined(HOST_BUILD)
+	#include <lz4.h>
+#endif
+
 // F256 includes
 #include "f256.h"
 
@@ -46,6 +53,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_OVERLAY_STARTUP
+
 #define UI_BYTE_SIZE_OF_LOGO				(36*45)		// firebird logo size.
 #define UI_BYTE_SIZE_OF_MACHINE_LOGO		(63*7)		// 441b = size of "F256JR" & "F256K" chars + colors (each)
 #define UI_BYTE_SIZE_OF_MACHINE_LOGO_LEFT	287
@@ -79,6 +88,39 @@
 #define INFO_FMANAGER_DISPLAY_ROW		(INFO_KERNEL_DISPLAY_ROW + 1)
 #define INFO_SUPERBASIC_DISPLAY_ROW		(INFO_FMANAGER_DISPLAY_ROW + 1)
 
+#define LZ4_EXPAND_SLOT					0x06	// CPU slot assets are decompressed through (overlay itself is in slot 5). I/O has to be off while it's used.
+#define LZ4_EXPAND_CPU_ADDR				0xC000
+
+#define TILE_CTRL_REG_LEN				(TILE_CTRL_OFFSET_SCROLL_Y_HI + 1)	// tilemap control register block, through the scroll
+#define STARTUP_NUM_UPLOADS				(sizeof(startup_uploads) / sizeof(StartupUpload))
+
+STORAGE_CHECK_FITS(STORAGE_PLAYER, sizeof(Player));
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+#ifdef PGZ_ASSETS_LZ4
+	// one compressed asset. built by tools/pgz_pack.py --lz4, see PGZ_LZ4_ASSET_TABLE in pgz_layout.h
+	typedef struct LZ4Asset
+	{
+		uint16_t	src_addr_;		// compressed data, in CPU space while this overlay is mapped in
+		uint8_t		dst_bank_;		// physical bank it expands into
+		uint16_t	dst_offset_;	// offset within that bank
+		uint16_t	raw_len_;		// uncompressed size
+	} LZ4Asset;
+#endif
+
+// one block copy into VICKY at startup. see startup_uploads.
+typedef struct StartupUpload
+{
+	uint8_t		io_page_;		// VICKY_IO_PAGE_xxx the destination is in
+	uint16_t	dst_addr_;		// in CPU space, while that IO page is mapped in
+	uint8_t*	src_;
+	uint16_t	len_;
+} StartupUpload;
+
 
 
 
@@ -127,6 +169,13 @@ uint8_t infest_clut[] =
 0x4f,0x47,0x37,0x00, 0x38,0x32,0x26,0x00, 0x00,0x00,0x00,0x00, 0xff,0xff,0xff,0x00, };
 
 
+#ifdef PGZ_ASSETS_LZ4
+	static LZ4Asset lz4_assets[PGZ_LZ4_ASSET_COUNT] = 
+	{
+		PGZ_LZ4_ASSET_TABLE
+	};
+#endif
+
 // F256JR/K colors, used for both fore- and background colors in Text mode
 // in C256 & F256, these are 8 bit values; in A2560s, they are 32 bit values, and endianness matters
 static uint8_t standard_text_color_lut[64] = 
@@ -149,6 +198,76 @@ static uint8_t standard_text_color_lut[64] =
 	0xFF, 0xFF, 0xFF, 0x00
 };
 
+// images of the VICKY registers that are only written once: they go up with the LUTs and font, as block copies
+static uint8_t layer_ctrl_regs[2] = 
+{
+	0x40,		// VICKY_LAYER_CTRL_1: 0, 1, 2 assign bitmap layers 0-2. 4-6 assign tilemap layers 0-2. tilemap 0 on layer 1.
+	0x15,		// VICKY_LAYER_CTRL_2: honestly no idea why doing this other than it's in example in ref manual
+};
+
+static uint8_t tileset0_addr_regs[3] = 
+{
+	TILESET_LO_ADDR, TILESET_MED_ADDR, TILESET_HI_ADDR,		// our tileset graphics start at 02 6000 in EM
+};
+
+static uint8_t tile0_ctrl_regs[TILE_CTRL_REG_LEN] = 
+{
+	0x01,										// enable; 16x16 tiles
+	PLAYFIELD_RING_LO_ADDR, PLAYFIELD_RING_MED_ADDR, PLAYFIELD_RING_HI_ADDR,	// the ring at the start of the playfield bank. Playfield fills it in per game
+	PLAYFIELD_RING_MAP_COLS, 0x00,				// the doubled ring, not the world: see playfield.h
+	PLAYFIELD_RING_MAP_ROWS, 0x00,
+	0x00, 0x00, 0x00, 0x00,						// scroll x, y start at 0; Playfield moves it with the camera
+};
+
+static uint8_t sprite0_addr_regs[3] = 
+{
+	SPRITE_ROBOT_16F_LO_ADDR, SPRITE_ROBOT_16F_MED_ADDR, SPRITE_ROBOT_16F_HI_ADDR,	// we are placing robot sprites starting at 02 4000 in EM
+};
+
+// everything Startup_UploadToVICKY() copies in. grouped by IO page, so each page is only swapped in once.
+static StartupUpload startup_uploads[] = 
+{
+	{VICKY_IO_PAGE_REGISTERS,		TEXT_FORE_LUT,			standard_text_color_lut,	sizeof(standard_text_color_lut)},
+	{VICKY_IO_PAGE_REGISTERS,		TEXT_BACK_LUT,			standard_text_color_lut,	sizeof(standard_text_color_lut)},
+	{VICKY_IO_PAGE_REGISTERS,		VICKY_LAYER_CTRL_1,		layer_ctrl_regs,			sizeof(layer_ctrl_regs)},
+	{VICKY_IO_PAGE_REGISTERS,		TILESET0_ADDR_LO,		tileset0_addr_regs,			sizeof(tileset0_addr_regs)},
+	{VICKY_IO_PAGE_REGISTERS,		TILE0_CTRL,				tile0_ctrl_regs,			sizeof(tile0_ctrl_regs)},
+	{VICKY_IO_PAGE_REGISTERS,		SPRITE0_ADDR_LO,		sprite0_addr_regs,			sizeof(sprite0_addr_regs)},
+	{VICKY_IO_PAGE_FONT_AND_LUTS,	FONT_MEMORY_BANK1,		custom_font_data,			sizeof(custom_font_data)},
+	{VICKY_IO_PAGE_FONT_AND_LUTS,	VICKY_CLUT0,			infest_clut,				sizeof(infest_clut)},
+};
+
+// every human and missile starts out as a copy of one of these. Startup_InitializeSprites() fills in the rest.
+static Sprite human_template = 
+{
+	0x40,										// state_: $40=16x16 sprite; 0 = off
+	SPRITE_HUMAN_1_8F_LO_ADDR, SPRITE_HUMAN_1_8F_MED_ADDR, SPRITE_HUMAN_1_8F_HI_ADDR,
+	0, 0,										// x1_, y1_
+	HUMAN_SPRITE_WIDTH, HUMAN_SPRITE_HEIGHT,	// x2_, y2_
+	NULL,										// sprite_reg_addr_: per sprite
+	OBJECT_TYPE_HUMAN,							// type_id_
+	0, 0, 0, 0,									// render_needed_, is_active_, x_speed_, y_speed_
+	PLAYER_DIR_NORTH,
+	SPRITE_HUMAN_1_8F_MED_ADDR + 0x01,			// addr_med_alt_: alt frames are 256b away from base frame
+	SPRITE_HUMAN_1_8F_LOMED_ADDR,
+	0,											// anim_countdown_: per sprite
+};
+
+static Sprite missile_template = 
+{
+	0x60,										// state_: $60=8x8 sprite; 0 = off
+	SPRITE_BULLET_S_LO_ADDR, SPRITE_BULLET_S_MED_ADDR, SPRITE_BULLET_S_HI_ADDR,
+	0, 0,
+	MISSILE_SPRITE_WIDTH, MISSILE_SPRITE_HEIGHT,
+	NULL,
+	OBJECT_TYPE_MISSILE,
+	0, 0, 0, 0,
+	PLAYER_DIR_NORTH,
+	SPRITE_BULLET_S_MED_ADDR + 0x01,
+	SPRITE_BULLET_S_LOMED_ADDR,
+	0,											// anim_countdown_: missiles have no alt cell, and never tick
+};
+
 
 
 
@@ -162,7 +281,6 @@ System*			global_system = &system_storage;
 extern Player*				global_player;
 
 
-extern char*				global_string[NUM_STRINGS];
 extern char*				global_string_buff1;
 // extern char*				global_string_buff2;
 
@@ -210,6 +328,9 @@ extern int8_t				zp_lives;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// enable the random number generator and start it from the_seed
+static void Startup_SeedRandomNumGen(uint16_t the_seed);
+
 // enable or disable the gamma correction 
 void Sys_SetGammaMode(bool enable_it);
 
@@ -234,14 +355,23 @@ void Startup_ShowFoenixLogo(void);
 // display information about f/manager, the machine, and the MicroKernel
 void Startup_ShowAboutInfo(void);
 
-// load in game font
-void LoadCustomFont(void);
-
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// enable the random number generator and start it from the_seed
+static void Startup_SeedRandomNumGen(uint16_t the_seed)
+{
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	R8(RANDOM_NUM_GEN_ENABLE) = 3; // enable and set seed mode
+	R8(RANDOM_NUM_GEN_LOW) = the_seed & 0xFF;
+	R8(RANDOM_NUM_GEN_HI) = the_seed >> 8;
+	R8(RANDOM_NUM_GEN_ENABLE) = 1; // keep enabled, return to generate mode
+	Sys_DisableIOBank();
+}
+
+
 // enable or disable the gamma correction 
 void Sys_SetGammaMode(bool enable_it)
 {
@@ -296,6 +426,10 @@ bool Sys_InitSystem(void)
 		}
 	#endif
 	
+	#ifdef USE_TELEMETRY
+		Telemetry_Initialize();
+	#endif
+	
 	//DEBUG_OUT(("%s %d: Initializing System...", __func__, __LINE__));
 	
 	// check what kind of hardware the system is running on
@@ -316,14 +450,11 @@ bool Sys_InitSystem(void)
 
 	// clear 0x0200, 0201, 0202, and 0203 to make next start after reset more accurate
 	// (if started from flash, then from disk, then reset, the "- fm" would still be in memory otherwise)
-	memset((char*)0x0200, 0, 4);
+	memset(HAL_CPU_PTR(0x0200), 0, 4);
 
 	// set to 320x240 mode
 	Sys_SetFatPixels(true);
 	
-	// load font
-	LoadCustomFont();
-	
 	// Enable mouse pointer -- no idea if this works, f68 emulator doesn't support mouse yet. 
 	//R32(VICKYB_MOUSE_CTRL_A2560K) = 1;
 	
@@ -387,13 +518,7 @@ bool Sys_AutoConfigure(void)
 			return false;
 		}
 
-		Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-	
-		// set standard color LUTs for text mode
-		memcpy((uint8_t*)(TEXT_FORE_LUT), &standard_text_color_lut, 64);
-		memcpy((uint8_t*)(TEXT_BACK_LUT), &standard_text_color_lut, 64);
-	
-		Sys_RestoreIOPage();
+		// the standard text color LUTs go in with the rest of VICKY's startup data: see Startup_UploadToVICKY()
 	
 // 		DEBUG_OUT(("%s %d: This screen has %i x %i text (%i x %i visible)", __func__, __LINE__, 
 // 			global_system->text_mem_cols_, 
@@ -533,17 +658,6 @@ void Sys_SetModeText(bool as_overlay)
 }
 
 
-// load in game font
-void LoadCustomFont(void)
-{	
-	Sys_SwapIOPage(VICKY_IO_PAGE_FONT_AND_LUTS);
-
-	memcpy((uint8_t*)FONT_MEMORY_BANK1, custom_font_data, (8*256));
-		
-	Sys_RestoreIOPage();
-}
-
-
 //! Detect the current screen mode/resolution, and set # of columns, rows, H pixels, V pixels, accordingly
 bool Sys_DetectScreenSize(void)
 {
@@ -671,101 +785,100 @@ void Startup_InitializeRandomNumGen(void)
 	//   I will use the real time clock to seed the number generator
 	
 	uint8_t		old_rtc_control;
-	
+	uint16_t	the_seed;
+
 	// need to have vicky registers available
 	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-	
+
 	// get mins and seconds from RTC
 	old_rtc_control = R8(RTC_CONTROL);
 	R8(RTC_CONTROL) = old_rtc_control | 0x08; // stop it from updating external registers
-	
-	// seed the RNG with time
-	R8(RANDOM_NUM_GEN_ENABLE) = 3; // enable and set seed mode
-	R8(RANDOM_NUM_GEN_LOW) = R8(RTC_SECONDS);
-	R8(RANDOM_NUM_GEN_HI) = R8(RTC_MINUTES);
-	R8(RANDOM_NUM_GEN_ENABLE) = 1; // keep enabled, return to generate mode
-	
+
+	the_seed = ((uint16_t)R8(RTC_MINUTES) << 8) | R8(RTC_SECONDS);
+
 	// restore timer control to what it had been
 	R8(RTC_CONTROL) = old_rtc_control;
 
 	Sys_DisableIOBank();
+
+	// seed the RNG with time
+	Startup_SeedRandomNumGen(the_seed);
 }
 
 
-// load sprite LUT and teach VICKY where the graphics  are
-void Startup_SetUpSprites(void)
+#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+// give this game its own seed, exchanged with the replay stream, and reseed the RNG with it
+void Startup_SyncReplaySeed(void)
 {
-	// LOGIC: 
-	//   we can set graphics mode, and lot in LUT from overlay
-	//   but VICKY needs access to the sprite data but it doesn't have to be in CPU space
-	//   we are loading it into EM with the pgZ and pointing VICKY directly at that. 
-	
-	uint8_t		the_value;
+	uint16_t	the_seed;
 
-	//DEBUG_OUT(("%s %d: setting graphics mode", __func__, __LINE__));
-	
-	// enable graphics and sprite engine and overlay text mode; leave tiles off
-	Sys_SetGraphicMode(PARAM_SPRITES_ON, PARAM_BITMAP_ON, PARAM_TILES_ON, PARAM_TEXT_OVERLAY_ON, PARAM_TEXT_OFF);
-		
-	// need to have I/O page for LUTs
-	Sys_SwapIOPage(VICKY_IO_PAGE_FONT_AND_LUTS);
-
-	//DEBUG_OUT(("%s %d: loading color LUT", __func__, __LINE__));
+	// LOGIC: 
+	//   a recorded game has to be replayed against the same random sequence it was recorded with.
+	//   every game gets a seed of its own in the stream, so games after the first don't depend on
+	//   how many random numbers the games before them happened to use.
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	the_seed = HAL_RANDOM16();
+	Sys_DisableIOBank();
 
-	// load the sprite LUT
-	memcpy((uint8_t*)VICKY_CLUT0, &infest_clut, 616);
+	Startup_SeedRandomNumGen(Replay_SyncSeed(the_seed));
+}
+#endif
 
-	//DEBUG_OUT(("%s %d: teaching vicky about sprite; sprite_graphic=%p addrLO to %x, MED to %x", __func__, __LINE__, sprite_graphic, (uint16_t)sprite_graphic & 0xFF, (uint16_t)(sprite_graphic) >> 8));
 
-	// tell VICKY where the sprite data is
-	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-	R8(SPRITE0_ADDR_LO) = SPRITE_ROBOT_16F_LO_ADDR;
-	R8(SPRITE0_ADDR_MED) = SPRITE_ROBOT_16F_MED_ADDR;
-	R8(SPRITE0_ADDR_HI) = SPRITE_ROBOT_16F_HI_ADDR;	// we are placing robot sprites starting at 02 4000 in EM
+// expand the LZ4-compressed assets carried in this overlay's bank into their physical addresses
+// does nothing unless the pgZ was packed with --lz4 (pgz_layout.h then defines PGZ_ASSETS_LZ4)
+void Startup_ExpandAssets(void)
+{
+#if defined(PGZ_ASSETS_LZ4) && !defined(HOST_BUILD)
+	// LOGIC: 
+	//   pgz_pack.py put the compressed data at the top of this overlay's bank, so it's in CPU space while this runs.
+	//   each asset fits in one 8K bank (pgz_pack.py checks), so map that bank into slot 6 and decompress straight into it.
+	//   PROFILE_STARTUP times the expansion, as one of the boot stages (see App_InitializeApp()).
+	//   slot 6 is the I/O window: with the I/O page mapped (as every Sys_ call before this leaves it), writes to
+	//   $C000-$DFFF go to VICKY, not to the bank. so I/O is turned off for the whole loop, and put back after.
+	
+	uint8_t		i;
 	
 	Sys_DisableIOBank();
+	
+	for (i = 0; i < PGZ_LZ4_ASSET_COUNT; i++)
+	{
+		zp_bank_num = lz4_assets[i].dst_bank_;
+		Memory_SwapInNewBank(LZ4_EXPAND_SLOT);
+		decompress_lz4(HAL_CPU_PTR(lz4_assets[i].src_addr_), HAL_CPU_PTR(LZ4_EXPAND_CPU_ADDR + lz4_assets[i].dst_offset_), lz4_assets[i].raw_len_);
+		Memory_RestorePreviousBank(LZ4_EXPAND_SLOT);
+	}
+	
+	Sys_RestoreIOPage();
+#endif
 }
 
 
-// Point the VICKY to our tile graphics and the tilemap
-void Startup_SetUpTileMap(void)
+// set the graphics mode, then copy the text LUTs, font, sprite LUT, and one-time tile and sprite registers into VICKY
+void Startup_UploadToVICKY(void)
 {
 	// LOGIC: 
-	//   tile+graphics mode is required, and must be called by another routine, this one doesn't do it.
-	//   
+	//   VICKY needs access to the sprite and tile data but it doesn't have to be in CPU space: the pgZ loaded it
+	//   into EM, and the register blocks point VICKY directly at that. what does get copied is startup_uploads.
+	//   the mode change rewrites the layer control registers, so it goes first; the table's copy then sets them for tiles.
+	//   DMA can't do these: it copies within system RAM, and every destination is in one of VICKY's IO pages.
 	
-	uint8_t		the_value;
-
-	//DEBUG_OUT(("%s %d: setting graphics mode", __func__, __LINE__));
+	StartupUpload*	the_upload;
+	uint8_t			the_io_page = 0xFF;
 	
-	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
-
-	//DEBUG_OUT(("%s %d: setting tilemap 0 to graphic layer 1...", __func__, __LINE__));
-
-	// Assign tilemap 0 to graphic layer 1
-	R8(VICKY_LAYER_CTRL_1) = 0x40;		// 0, 1, 2 assign bitmap layers 0-2. 4-6 assign tilemap layers 0-2
-	R8(VICKY_LAYER_CTRL_2) = 0x15;		// honestly no idea why doing this other than it's in example in ref manual
-
-	//DEBUG_OUT(("%s %d: teaching vicky about tile set 0 data", __func__, __LINE__));
-
-	// tell VICKY where the tileset 0 data is
-	R8(TILESET0_ADDR_LO) = TILESET_LO_ADDR;
-	R8(TILESET0_ADDR_MED) = TILESET_MED_ADDR;
-	R8(TILESET0_ADDR_HI) = TILESET_HI_ADDR;		// our tileset graphics start at 02 6000 in EM
-	
-	// tell VICKY about tilemap: size, shape, and where mapped in EM
-	R8(TILE0_CTRL) = 0x01;	// enable; 16x16 tiles
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_MAP_SIZE_X) = 0x14;	// 20 cols of 16 pixels = 320 pixels = matches screen
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_MAP_SIZE_Y) = 0x0f;	// 15 rows of 16 pixels = 240 pixels = matches screen
-	// where the tilemap data is stored. our tile MAP starts at 02 5DA8 in EM
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_ADDR_LO) = TILEMAP_LO_ADDR;
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_ADDR_MED) = TILEMAP_MED_ADDR;
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_ADDR_HI) = TILEMAP_HI_ADDR;
-	// no vertical or horizontal scrolling wanted
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_X_LO) = 0;
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_X_HI) = 0;
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_Y_LO) = 0;
-	R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_Y_HI) = 0;
+	// enable graphics, sprite and tile engines, and overlay text mode
+	Sys_SetGraphicMode(PARAM_SPRITES_ON, PARAM_BITMAP_ON, PARAM_TILES_ON, PARAM_TEXT_OVERLAY_ON, PARAM_TEXT_OFF);
+	
+	for (the_upload = startup_uploads; the_upload != startup_uploads + STARTUP_NUM_UPLOADS; the_upload++)
+	{
+		if (the_upload->io_page_ != the_io_page)
+		{
+			the_io_page = the_upload->io_page_;
+			Sys_SwapIOPage(the_io_page);
+		}
+		
+		memcpy(HAL_CPU_PTR(the_upload->dst_addr_), the_upload->src_, the_upload->len_);
+	}
 	
 	Sys_DisableIOBank();
 }
@@ -774,8 +887,8 @@ void Startup_SetUpTileMap(void)
 // set some player properties at start of game
 void Startup_InitializePlayer(void)
 {
-	// add the player object. 26 bytes.
-	global_player = (Player*)STORAGE_PLAYER;
+	// add the player object. it has a STORAGE_ pool of its own (app.h).
+	global_player = (Player*)HAL_CPU_PTR(STORAGE_PLAYER);
 	memset(global_player, 0, sizeof(Player));
 
 	zp_px = 0; // will get set randomly anyway. 
@@ -820,54 +933,22 @@ void Startup_InitializePlayer(void)
 void Startup_InitializeSprites(void)
 {
 	uint8_t		i;
-	uint8_t*	the_sprite_reg = (uint8_t*)(SPRITE0_CTRL + SPRITE_REG_LEN); // start with first sprite after the player's sprite
+	uint8_t*	the_sprite_reg = HAL_CPU_PTR(SPRITE0_CTRL + SPRITE_REG_LEN); // start with first sprite after the player's sprite
+	Sprite*		the_sprite = global_humans;
 	
-	for (i=0; i < LEVEL_MAX_HUMANS; i++)
+	for (i=0; i < LEVEL_MAX_HUMANS; i++, the_sprite++)
 	{
-		global_humans[i].state_ = 0x40;	// $40=16x16 sprite; 0 = off
-		global_humans[i].addr_lo_ = SPRITE_HUMAN_1_8F_LO_ADDR;
-		global_humans[i].addr_med_ = SPRITE_HUMAN_1_8F_MED_ADDR;
-		global_humans[i].addr_med_alt_ = SPRITE_HUMAN_1_8F_MED_ADDR + 0x01;	// alt frames are 256b away from base frame
-		global_humans[i].addr_hi_ = SPRITE_HUMAN_1_8F_HI_ADDR;
-		global_humans[i].addr_base_lomed_ = SPRITE_HUMAN_1_8F_LOMED_ADDR;
-		global_humans[i].x1_ = 0;
-		global_humans[i].y1_ = 0;
-		global_humans[i].x2_ = HUMAN_SPRITE_WIDTH;
-		global_humans[i].y2_ = HUMAN_SPRITE_HEIGHT;
-		global_humans[i].sprite_reg_addr_ = the_sprite_reg;
-		global_humans[i].type_id_ = OBJECT_TYPE_MISSILE;
-		global_humans[i].render_needed_ = 0;
-		global_humans[i].is_active_ = 0;
-		global_humans[i].x_speed_ = 0;
-		global_humans[i].y_speed_ = 0;
-		global_humans[i].direction_ = PLAYER_DIR_NORTH;
-		
-		//DEBUG_OUT(("%s %d: human sprite %u configured; reg addr=%p; the_sprite_reg=%p", __func__, __LINE__, i, global_humans[i].sprite_reg_addr_, the_sprite_reg));
+		memcpy(the_sprite, &human_template, sizeof(Sprite));
+		the_sprite->sprite_reg_addr_ = the_sprite_reg;
+		the_sprite->anim_countdown_ = (i % HUMAN_FRAMES_PER_ANIM_CELL) + 1;	// staggered, so they don't all step in unison
 		
 		the_sprite_reg += SPRITE_REG_LEN;
 	}
 
-	for (i=0; i < LEVEL_MAX_MISSILES; i++)
+	for (i=0, the_sprite = global_missiles; i < LEVEL_MAX_MISSILES; i++, the_sprite++)
 	{
-		global_missiles[i].state_ = 0x60;	// $60=8x8 sprite; 0 = off
-		global_missiles[i].addr_lo_ = SPRITE_BULLET_S_LO_ADDR;
-		global_missiles[i].addr_med_ = SPRITE_BULLET_S_MED_ADDR;
-		global_missiles[i].addr_med_alt_ = SPRITE_BULLET_S_MED_ADDR + 0x01;	// alt frames are 256b away from base frame
-		global_missiles[i].addr_hi_ = SPRITE_BULLET_S_HI_ADDR;
-		global_missiles[i].addr_base_lomed_ = SPRITE_BULLET_S_LOMED_ADDR;
-		global_missiles[i].x1_ = 0;
-		global_missiles[i].y1_ = 0;
-		global_missiles[i].x2_ = MISSILE_SPRITE_WIDTH;
-		global_missiles[i].y2_ = MISSILE_SPRITE_HEIGHT;
-		global_missiles[i].sprite_reg_addr_ = the_sprite_reg;
-		global_missiles[i].type_id_ = OBJECT_TYPE_MISSILE;
-		global_missiles[i].render_needed_ = 0;
-		global_missiles[i].is_active_ = 0;
-		global_missiles[i].x_speed_ = 0;
-		global_missiles[i].y_speed_ = 0;
-		global_missiles[i].direction_ = PLAYER_DIR_NORTH;
-		
-		//DEBUG_OUT(("%s %d: missile sprite %u configured; reg addr=%p; the_sprite_reg=%p", __func__, __LINE__, i, global_missiles[i].sprite_reg_addr_, the_sprite_reg));
+		memcpy(the_sprite, &missile_template, sizeof(Sprite));
+		the_sprite->sprite_reg_addr_ = the_sprite_reg;
 				
 		the_sprite_reg += SPRITE_REG_LEN;
 	}
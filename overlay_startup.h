@@ -52,6 +52,11 @@ void Startup_ShowLogo(void);
 // enable the random number generator, and seed it
 void Startup_InitializeRandomNumGen(void);
 
+#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+	// give this game its own seed, exchanged with the replay stream, and reseed the RNG with it
+	void Startup_SyncReplaySeed(void);
+#endif
+
 //! Initialize the system (primary entry point for all system initialization activity)
 //! Starts up the memory manager, creates the global system object, runs autoconfigure to check the system hardware, loads system and application fonts, allocates a bitmap for the screen.
 bool Sys_InitSystem(void);
@@ -80,8 +85,12 @@ bool Sys_DetectScreenSize(void);
 //! @return	returns false on any error/invalid input.
 void Sys_SetBorderSize(uint8_t border_width, uint8_t border_height);
 
-// load sprite LUT and teach VICKY where the graphics  are
-void Startup_SetUpSprites(void);
+// expand the LZ4-compressed assets carried in this overlay's bank into their physical addresses
+// does nothing unless the pgZ was packed with --lz4 (pgz_layout.h then defines PGZ_ASSETS_LZ4)
+void Startup_ExpandAssets(void);
+
+// set the graphics mode, then copy the text LUTs, font, sprite LUT, and one-time tile and sprite registers into VICKY
+void Startup_UploadToVICKY(void);
 
 // set some player properties at start of game
 void Startup_InitializePlayer(void);
@@ -89,9 +98,6 @@ void Startup_InitializePlayer(void);
 // set up all non-player sprites
 void Startup_InitializeSprites(void);
 
-// Point the VICKY to our tile graphics and the tilemap
-void Startup_SetUpTileMap(void);
-
 // initialize the comms buffer and msg/status area (without drawing anything)
 void Startup_InitializeCommsBuffer(void);
 
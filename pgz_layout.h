@@ -0,0 +1,56 @@
+/*
+ * pgz_layout.h
+ *
+ *  GENERATED by tools/pgz_pack.py from pgz_manifest.txt. Do not edit: change the manifest instead.
+ *
+ *  Where each asset is loaded in physical memory, so code and the pgZ can't drift apart.
+ *    _PHYS_ADDR is the 20-bit address; _LOMED/_LO/_MED/_HI are the pieces VICKY registers want.
+ *    _LEN is the size of the asset file at the time this was generated.
+ */
+
+#ifndef PGZ_LAYOUT_H_
+#define PGZ_LAYOUT_H_
+
+#define SPRITE_ROBOT_16F_PHYS_ADDR			0x24000	// robot.bin
+#define SPRITE_ROBOT_16F_LOMED_ADDR			0x4000
+#define SPRITE_ROBOT_16F_LO_ADDR			0x00
+#define SPRITE_ROBOT_16F_MED_ADDR			0x40
+#define SPRITE_ROBOT_16F_HI_ADDR			0x02
+#define SPRITE_ROBOT_16F_LEN				4096
+
+#define SPRITE_HUMAN_1_8F_PHYS_ADDR			0x25000	// human1.bin
+#define SPRITE_HUMAN_1_8F_LOMED_ADDR		0x5000
+#define SPRITE_HUMAN_1_8F_LO_ADDR			0x00
+#define SPRITE_HUMAN_1_8F_MED_ADDR			0x50
+#define SPRITE_HUMAN_1_8F_HI_ADDR			0x02
+#define SPRITE_HUMAN_1_8F_LEN				2048
+
+#define SPRITE_BULLET_S_PHYS_ADDR			0x25800	// bullets_s.bin
+#define SPRITE_BULLET_S_LOMED_ADDR			0x5800
+#define SPRITE_BULLET_S_LO_ADDR				0x00
+#define SPRITE_BULLET_S_MED_ADDR			0x58
+#define SPRITE_BULLET_S_HI_ADDR				0x02
+#define SPRITE_BULLET_S_LEN					512
+
+#define TILEMAP_PHYS_ADDR					0x25DA8	// tilemap.bin
+#define TILEMAP_LOMED_ADDR					0x5DA8
+#define TILEMAP_LO_ADDR						0xA8
+#define TILEMAP_MED_ADDR					0x5D
+#define TILEMAP_HI_ADDR						0x02
+#define TILEMAP_LEN							600
+
+#define TILESET_PHYS_ADDR					0x26000	// tiles.bin
+#define TILESET_LOMED_ADDR					0x6000
+#define TILESET_LO_ADDR						0x00
+#define TILESET_MED_ADDR					0x60
+#define TILESET_HI_ADDR						0x02
+#define TILESET_LEN							5376
+
+#define STRINGS_PHYS_ADDR					0x40000	// strings.bin
+#define STRINGS_LOMED_ADDR					0x0000
+#define STRINGS_LO_ADDR						0x00
+#define STRINGS_MED_ADDR					0x00
+#define STRINGS_HI_ADDR						0x04
+#define STRINGS_LEN							562
+
+#endif /* PGZ_LAYOUT_H_ */
@@ -43,6 +43,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_PLAYER
+
 
 
 /*****************************************************************************/
@@ -74,7 +76,6 @@ Chip		global_computer_chip[MAX_CHIPS] =
 
 Player*				global_player;
 
-extern char*				global_string[NUM_STRINGS];
 extern char*				global_string_buff1;
 // extern char*				global_string_buff2;
 
@@ -222,7 +223,7 @@ void Player_LoseLife(void)
 	else
 	{
 		--zp_lives;
-		*(uint8_t*)ZP_HP = 0;
+		zp_hp = 0;
 		Player_IncreaseHP();
 		
 		// TODO: play gong or something when life used up?
@@ -280,6 +281,9 @@ void Player_SetWeapon(int8_t weapon_id)
 	zp_num_bullets = global_player->bullets_in_clip_[weapon_id];	
 	zp_bullet_dmg = global_weapon[weapon_id].damage_;
 	
+	// get its bullet graphic on the way, if it has its own
+	Level_LoadMissileGraphic(weapon_id);
+	
 	return;
 }
 
@@ -470,6 +474,34 @@ void Player_ValidateLocation(void)
 }
 
 
+// undo as much of the move from the_prev_x/y to px/py as it takes to keep the player out of solid tiles
+// the_prev_x/y must be clear of them. call after Player_ValidateLocation().
+void Player_StopAtWalls(uint16_t the_prev_x, uint16_t the_prev_y)
+{
+	// LOGIC:
+	//   a diagonal move into a wall keeps whichever half of the move is still clear, so the player slides along it
+	//   instead of sticking. only if both halves hit does the player stay put.
+	if (Playfield_BoxIsSolid(zp_px, zp_py, zp_px + PLAYER_SPRITE_WIDTH, zp_py + PLAYER_SPRITE_HEIGHT) == false)
+	{
+		return;
+	}
+	
+	if (Playfield_BoxIsSolid(zp_px, the_prev_y, zp_px + PLAYER_SPRITE_WIDTH, the_prev_y + PLAYER_SPRITE_HEIGHT) == false)
+	{
+		zp_py = the_prev_y;
+	}
+	else if (Playfield_BoxIsSolid(the_prev_x, zp_py, the_prev_x + PLAYER_SPRITE_WIDTH, zp_py + PLAYER_SPRITE_HEIGHT) == false)
+	{
+		zp_px = the_prev_x;
+	}
+	else
+	{
+		zp_px = the_prev_x;
+		zp_py = the_prev_y;
+	}
+}
+
+
 // // return the rank the player has for the passed badge type
 // // returns -1 if player has not earned any badges of this type
 // int8_t Player_GetBadgeRank(uint8_t the_badge_type)
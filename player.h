@@ -244,6 +244,10 @@ void Player_MoveToLocation(Coordinate* new_location);
 // check px and py to make sure they are inside playfield; adjusts if necessary
 void Player_ValidateLocation(void);
 
+// undo as much of the move from the_prev_x/y to px/py as it takes to keep the player out of solid tiles
+// the_prev_x/y must be clear of them. call after Player_ValidateLocation().
+void Player_StopAtWalls(uint16_t the_prev_x, uint16_t the_prev_y);
+
 
 
 #endif /* PLAYER_H_ */
@@ -0,0 +1,545 @@
+/*
+ * playfield.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  The scrolling world map, the camera, and VICKY's ring tilemap
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "playfield.h"
+#include "app.h"
+#include "general.h"
+#include "present.h"
+#include "sys.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+// camera x that centers a 16 px wide player at world x px (which includes the sprite offset)
+#define PLAYFIELD_CENTER_OFFSET_X	(PLAYFIELD_SPRITE_OFFSET + PLAYFIELD_SCREEN_WIDTH / 2 - 8)
+#define PLAYFIELD_CENTER_OFFSET_Y	(PLAYFIELD_SPRITE_OFFSET + PLAYFIELD_SCREEN_HEIGHT / 2 - 8)
+
+// byte distance between the 4 copies of a ring cell in VICKY's map
+#define PLAYFIELD_RING_ACROSS		(PLAYFIELD_RING_COLS * 2)
+#define PLAYFIELD_RING_DOWN			(PLAYFIELD_RING_ROWS * PLAYFIELD_RING_MAP_COLS * 2)
+
+// the solid tile bits: read for every moving sprite, every frame, so they're at a fixed address out of BSS.
+#define PLAYFIELD_SOLID				((uint8_t*)HAL_CPU_PTR(STORAGE_PLAYFIELD_SOLID))
+
+STORAGE_CHECK_FITS(STORAGE_PLAYFIELD_SOLID, PLAYFIELD_SOLID_LEN);
+
+// the TILEMAP asset's bottom wall. the void row under it is part of the wall between a room and the one below.
+#define PLAYFIELD_ROOM_BOTTOM_WALL_ROW	(PLAYFIELD_SCREEN_ROWS - 2)
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint8_t		ring_first_col;		// world col/row of the ring's top left: the tile under the camera's top left
+static uint8_t		ring_first_row;
+static uint8_t		ring_col_phase;		// ring_first_col % PLAYFIELD_RING_COLS, kept up to date instead of dividing
+static uint8_t		ring_row_phase;		// ring_first_row % PLAYFIELD_RING_ROWS
+
+static const uint8_t	playfield_solid_bit[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};	// col % 8 to its bit
+
+// PLAYFIELD_TILE_ATTR_* for each clean tile in tiles.bin, by tile number / 2. a bloody tile shares the clean one's.
+static const uint8_t	playfield_tile_attr[PLAYFIELD_CLEAN_TILES] =
+{
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x00 wall, top left corner
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x02 wall, top
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x04 wall, top right corner
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x06 wall, left
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x08 wall, right
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x0A wall, bottom left corner
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x0C wall, bottom
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x0E wall, bottom right corner
+	0,								// 0x10 floor
+	PLAYFIELD_TILE_ATTR_SOLID,		// 0x12 void, under the bottom wall
+	0,								// 0x14 floor, with a grate
+};
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+uint16_t			global_camera_x;	// world pixel at the screen's left edge
+uint16_t			global_camera_y;	// world pixel at the screen's top edge
+
+extern uint16_t				zp_px;
+extern uint16_t				zp_py;
+#pragma zpsym ("zp_px");
+#pragma zpsym ("zp_py");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// camera position that centers the player, clamped to the world
+void Playfield_GetTargetCamera(uint16_t* the_x, uint16_t* the_y);
+
+// write one tile to all 4 copies of its ring cell. playfield bank must be mapped.
+void Playfield_WriteRingCell(uint8_t the_ring_col, uint8_t the_ring_row, uint8_t the_tile);
+
+// copy world column the_col into ring column the_ring_col, for the rows the ring currently holds
+void Playfield_WriteRingColumn(uint8_t the_col, uint8_t the_ring_col);
+
+// copy world row the_row into ring row the_ring_row, for the columns the ring currently holds
+void Playfield_WriteRingRow(uint8_t the_row, uint8_t the_ring_row);
+
+// point VICKY's scroll registers at the camera's spot in the ring, at the next Present flush
+void Playfield_SetScrollRegisters(void);
+
+// true if col/row (within a room) is in a doorway cut through that room's walls. room_col/room_row say which room.
+bool Playfield_IsDoorway(uint8_t the_col, uint8_t the_row, uint8_t the_room_col, uint8_t the_room_row);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// camera position that centers the player, clamped to the world
+void Playfield_GetTargetCamera(uint16_t* the_x, uint16_t* the_y)
+{
+	*the_x = (zp_px <= PLAYFIELD_CENTER_OFFSET_X) ? 0 : zp_px - PLAYFIELD_CENTER_OFFSET_X;
+	*the_y = (zp_py <= PLAYFIELD_CENTER_OFFSET_Y) ? 0 : zp_py - PLAYFIELD_CENTER_OFFSET_Y;
+
+	if (*the_x > PLAYFIELD_CAMERA_MAX_X)
+	{
+		*the_x = PLAYFIELD_CAMERA_MAX_X;
+	}
+
+	if (*the_y > PLAYFIELD_CAMERA_MAX_Y)
+	{
+		*the_y = PLAYFIELD_CAMERA_MAX_Y;
+	}
+}
+
+
+// write one tile to all 4 copies of its ring cell. playfield bank must be mapped.
+void Playfield_WriteRingCell(uint8_t the_ring_col, uint8_t the_ring_row, uint8_t the_tile)
+{
+	uint8_t*	the_cell;
+
+	the_cell = HAL_CPU_PTR(PLAYFIELD_RING_CPU_ADDR + ((uint16_t)the_ring_row * PLAYFIELD_RING_MAP_COLS + the_ring_col) * 2);
+
+	the_cell[0] = the_tile;
+	the_cell[PLAYFIELD_RING_ACROSS] = the_tile;
+	the_cell[PLAYFIELD_RING_DOWN] = the_tile;
+	the_cell[PLAYFIELD_RING_DOWN + PLAYFIELD_RING_ACROSS] = the_tile;
+}
+
+
+// copy world column the_col into ring column the_ring_col, for the rows the ring currently holds
+void Playfield_WriteRingColumn(uint8_t the_col, uint8_t the_ring_col)
+{
+	uint8_t		i;
+	uint8_t		the_row = ring_first_row;
+	uint8_t		the_ring_row = ring_row_phase;
+	uint8_t*	the_world_tile;
+
+	// LOGIC:
+	//   the ring reaches up to 2 columns / 1 row past the world's right/bottom edge when the camera is all the way over.
+	//   those cells are never on screen, but get tile 0 rather than whatever is past the end of the world map.
+	the_world_tile = HAL_CPU_PTR(PLAYFIELD_WORLD_CPU_ADDR + (uint16_t)the_row * PLAYFIELD_WORLD_COLS + the_col);
+
+	for (i = 0; i < PLAYFIELD_RING_ROWS; i++)
+	{
+		Playfield_WriteRingCell(the_ring_col, the_ring_row, (the_col < PLAYFIELD_WORLD_COLS && the_row < PLAYFIELD_WORLD_ROWS) ? *the_world_tile : 0);
+
+		the_world_tile += PLAYFIELD_WORLD_COLS;
+		++the_row;
+
+		if (++the_ring_row == PLAYFIELD_RING_ROWS)
+		{
+			the_ring_row = 0;
+		}
+	}
+}
+
+
+// copy world row the_row into ring row the_ring_row, for the columns the ring currently holds
+void Playfield_WriteRingRow(uint8_t the_row, uint8_t the_ring_row)
+{
+	uint8_t		i;
+	uint8_t		the_col = ring_first_col;
+	uint8_t		the_ring_col = ring_col_phase;
+	uint8_t*	the_world_tile;
+
+	the_world_tile = HAL_CPU_PTR(PLAYFIELD_WORLD_CPU_ADDR + (uint16_t)the_row * PLAYFIELD_WORLD_COLS + the_col);
+
+	for (i = 0; i < PLAYFIELD_RING_COLS; i++)
+	{
+		Playfield_WriteRingCell(the_ring_col, the_ring_row, (the_col < PLAYFIELD_WORLD_COLS && the_row < PLAYFIELD_WORLD_ROWS) ? *the_world_tile : 0);
+
+		++the_world_tile;
+		++the_col;
+
+		if (++the_ring_col == PLAYFIELD_RING_COLS)
+		{
+			the_ring_col = 0;
+		}
+	}
+}
+
+
+// point VICKY's scroll registers at the camera's spot in the ring, at the next Present flush
+void Playfield_SetScrollRegisters(void)
+{
+	uint16_t	the_scroll_x;
+	uint16_t	the_scroll_y;
+
+	the_scroll_x = (uint16_t)ring_col_phase * PLAYFIELD_TILE_SIZE + (global_camera_x & (PLAYFIELD_TILE_SIZE - 1));
+	the_scroll_y = (uint16_t)ring_row_phase * PLAYFIELD_TILE_SIZE + (global_camera_y & (PLAYFIELD_TILE_SIZE - 1));
+
+	Present_SetScroll(the_scroll_x, the_scroll_y);
+}
+
+
+// true if col/row (within a room) is in a doorway cut through that room's walls. room_col/room_row say which room.
+bool Playfield_IsDoorway(uint8_t the_col, uint8_t the_row, uint8_t the_room_col, uint8_t the_room_row)
+{
+	// LOGIC:
+	//   there's a doorway through every wall two rooms share, and none through the world's outside walls.
+	//   it goes through the wall tiles on both sides: a room's right wall and the left wall of the room to its right,
+	//   or a room's bottom wall and the void under it, and the top wall of the room below.
+	if (the_row >= PLAYFIELD_DOOR_FIRST_ROW && the_row < PLAYFIELD_DOOR_FIRST_ROW + PLAYFIELD_DOOR_ROWS)
+	{
+		if (the_col == 0)
+		{
+			return the_room_col != 0;
+		}
+
+		if (the_col == PLAYFIELD_SCREEN_COLS - 1)
+		{
+			return the_room_col != PLAYFIELD_SCREENS_ACROSS - 1;
+		}
+	}
+
+	if (the_col >= PLAYFIELD_DOOR_FIRST_COL && the_col < PLAYFIELD_DOOR_FIRST_COL + PLAYFIELD_DOOR_COLS)
+	{
+		if (the_row == 0)
+		{
+			return the_room_row != 0;
+		}
+
+		if (the_row >= PLAYFIELD_ROOM_BOTTOM_WALL_ROW)
+		{
+			return the_room_row != PLAYFIELD_SCREENS_DOWN - 1;
+		}
+	}
+
+	return false;
+}
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// build a clean (no blood) world map: the TILEMAP asset in every room, with the doorways between them cut. and the solid tile bits.
+// leaves the playfield bank mapped into the overlay slot
+void Playfield_BuildWorldMap(void)
+{
+	uint8_t		the_seed_row[PLAYFIELD_SCREEN_COLS];
+	uint8_t		the_row;
+	uint8_t		the_col;
+	uint8_t		the_room_row;
+	uint8_t		the_room_col;
+	uint8_t		the_tile;
+	uint8_t*	the_seed;
+	uint8_t*	the_world_tile;
+
+	// LOGIC:
+	//   the TILEMAP asset and the playfield are in different banks, and there's one overlay slot to see them through,
+	//   so go a screen row at a time: pick up the clean tile numbers (even = clean, odd = bloody) from the asset,
+	//   then lay that row down in every room across and down the world, with floor wherever a doorway goes.
+	//   the solid bits come from the same pass over the asset, from each tile's attributes: they only need one room's worth.
+	memset(PLAYFIELD_SOLID, 0, PLAYFIELD_SOLID_LEN);
+
+	for (the_row = 0; the_row < PLAYFIELD_SCREEN_ROWS; the_row++)
+	{
+		App_LoadOverlay(TILEMAP_VALUE);
+		the_seed = HAL_CPU_PTR(TILEMAP_ADDR_IN_CPU_SPACE + (uint16_t)the_row * PLAYFIELD_SCREEN_COLS * 2);
+
+		for (the_col = 0; the_col < PLAYFIELD_SCREEN_COLS; the_col++)
+		{
+			the_tile = the_seed[the_col * 2] & 0xFE;
+			the_seed_row[the_col] = the_tile;
+
+			if (playfield_tile_attr[the_tile >> 1] & PLAYFIELD_TILE_ATTR_SOLID)
+			{
+				PLAYFIELD_SOLID[the_row * PLAYFIELD_SOLID_ROW_BYTES + (the_col >> 3)] |= playfield_solid_bit[the_col & 7];
+			}
+		}
+
+		App_LoadOverlay(PLAYFIELD_BANK);
+
+		for (the_room_row = 0; the_room_row < PLAYFIELD_SCREENS_DOWN; the_room_row++)
+		{
+			the_world_tile = HAL_CPU_PTR(PLAYFIELD_WORLD_CPU_ADDR + (uint16_t)(the_room_row * PLAYFIELD_SCREEN_ROWS + the_row) * PLAYFIELD_WORLD_COLS);
+
+			for (the_room_col = 0; the_room_col < PLAYFIELD_SCREENS_ACROSS; the_room_col++)
+			{
+				for (the_col = 0; the_col < PLAYFIELD_SCREEN_COLS; the_col++)
+				{
+					if (Playfield_IsDoorway(the_col, the_row, the_room_col, the_room_row) == true)
+					{
+						*the_world_tile++ = PLAYFIELD_TILE_FLOOR;
+					}
+					else
+					{
+						*the_world_tile++ = the_seed_row[the_col];
+					}
+				}
+			}
+		}
+	}
+}
+
+
+// put the camera on the player and draw the whole ring. for the start of a game, or after a warp
+void Playfield_SnapToPlayer(void)
+{
+	Playfield_GetTargetCamera(&global_camera_x, &global_camera_y);
+
+	ring_first_col = global_camera_x / PLAYFIELD_TILE_SIZE;
+	ring_first_row = global_camera_y / PLAYFIELD_TILE_SIZE;
+	ring_col_phase = ring_first_col % PLAYFIELD_RING_COLS;
+	ring_row_phase = ring_first_row % PLAYFIELD_RING_ROWS;
+
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	// clear first: high bytes (tileset/LUT) stay 0 from here on, the row writes only ever touch the low bytes
+	memset(HAL_CPU_PTR(PLAYFIELD_RING_CPU_ADDR), 0, PLAYFIELD_RING_MAP_LEN);
+
+	Playfield_ShowRing();
+	Playfield_SetScrollRegisters();
+}
+
+
+// move the camera toward the player and bring the ring up to date with it. call once per frame, after the player moves.
+void Playfield_FollowPlayer(void)
+{
+	uint16_t	the_x;
+	uint16_t	the_y;
+	uint8_t		the_col;
+	uint8_t		the_row;
+
+	Playfield_GetTargetCamera(&the_x, &the_y);
+
+	if (the_x == global_camera_x && the_y == global_camera_y)
+	{
+		return;
+	}
+
+	global_camera_x = the_x;
+	global_camera_y = the_y;
+	the_col = the_x / PLAYFIELD_TILE_SIZE;
+	the_row = the_y / PLAYFIELD_TILE_SIZE;
+
+	// LOGIC:
+	//   the column/row leaving the ring on one side has the same ring index as the one entering on the other,
+	//   so stepping one tile = rewrite that one ring column/row, and move the phase. the player moves 2 px a frame,
+	//   so this is almost always 0 or 1 step.
+	//   the rewrites are queued, not done: VICKY is showing the ring right now, and the scroll that goes with them
+	//   doesn't change until the Present flush. the flush writes them for the ring as it is at the end of this function.
+	while (ring_first_col < the_col)
+	{
+		Present_QueueRingColumn(ring_first_col + PLAYFIELD_RING_COLS, ring_col_phase);
+		++ring_first_col;
+
+		if (++ring_col_phase == PLAYFIELD_RING_COLS)
+		{
+			ring_col_phase = 0;
+		}
+	}
+
+	while (ring_first_col > the_col)
+	{
+		--ring_first_col;
+		ring_col_phase = (ring_col_phase == 0) ? PLAYFIELD_RING_COLS - 1 : ring_col_phase - 1;
+		Present_QueueRingColumn(ring_first_col, ring_col_phase);
+	}
+
+	while (ring_first_row < the_row)
+	{
+		Present_QueueRingRow(ring_first_row + PLAYFIELD_RING_ROWS, ring_row_phase);
+		++ring_first_row;
+
+		if (++ring_row_phase == PLAYFIELD_RING_ROWS)
+		{
+			ring_row_phase = 0;
+		}
+	}
+
+	while (ring_first_row > the_row)
+	{
+		--ring_first_row;
+		ring_row_phase = (ring_row_phase == 0) ? PLAYFIELD_RING_ROWS - 1 : ring_row_phase - 1;
+		Present_QueueRingRow(ring_first_row, ring_row_phase);
+	}
+
+	Playfield_SetScrollRegisters();
+}
+
+
+// tile number at world tile col/row
+uint8_t Playfield_GetTile(uint8_t the_col, uint8_t the_row)
+{
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	return R8(PLAYFIELD_WORLD_CPU_ADDR + (uint16_t)the_row * PLAYFIELD_WORLD_COLS + the_col);
+}
+
+
+// change the tile at world tile col/row. it reaches the screen at the next Present flush, if it is in the ring.
+void Playfield_SetTile(uint8_t the_col, uint8_t the_row, uint8_t the_tile)
+{
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	R8(PLAYFIELD_WORLD_CPU_ADDR + (uint16_t)the_row * PLAYFIELD_WORLD_COLS + the_col) = the_tile;
+
+	Present_QueueTile(the_col, the_row);
+}
+
+
+// true if the tile at world tile col/row is solid
+bool Playfield_IsSolid(uint8_t the_col, uint8_t the_row)
+{
+	uint8_t		the_room_col;
+	uint8_t		the_room_row;
+
+	// LOGIC:
+	//   every room is the asset, so bring col/row back into the first room, counting which room it was.
+	//   at most a couple of subtracts: cheaper than a divide on the 6502.
+	//   doorways are only ever cut through solid tiles, so only a solid bit needs the doorway check.
+	the_room_col = 0;
+	the_room_row = 0;
+
+	while (the_col >= PLAYFIELD_SCREEN_COLS)
+	{
+		the_col -= PLAYFIELD_SCREEN_COLS;
+		the_room_col++;
+	}
+
+	while (the_row >= PLAYFIELD_SCREEN_ROWS)
+	{
+		the_row -= PLAYFIELD_SCREEN_ROWS;
+		the_room_row++;
+	}
+
+	if ((PLAYFIELD_SOLID[the_row * PLAYFIELD_SOLID_ROW_BYTES + (the_col >> 3)] & playfield_solid_bit[the_col & 7]) == 0)
+	{
+		return false;
+	}
+
+	return Playfield_IsDoorway(the_col, the_row, the_room_col, the_room_row) == false;
+}
+
+
+// true if any tile under the box is solid. x1/y1/x2/y2 are world pixels like Sprite's: x2/y2 are 1 past the box.
+// the box must be inside LEVEL_MIN_X..LEVEL_MAX_Y, and no more than 1 tile across/down.
+bool Playfield_BoxIsSolid(uint16_t the_x1, uint16_t the_y1, uint16_t the_x2, uint16_t the_y2)
+{
+	uint8_t		the_first_col;
+	uint8_t		the_last_col;
+	uint8_t		the_first_row;
+	uint8_t		the_last_row;
+
+	// LOGIC:
+	//   a box no bigger than a tile can only overlap the tiles under its 4 corners
+	the_first_col = (the_x1 - PLAYFIELD_SPRITE_OFFSET) / PLAYFIELD_TILE_SIZE;
+	the_last_col = (the_x2 - PLAYFIELD_SPRITE_OFFSET - 1) / PLAYFIELD_TILE_SIZE;
+	the_first_row = (the_y1 - PLAYFIELD_SPRITE_OFFSET) / PLAYFIELD_TILE_SIZE;
+	the_last_row = (the_y2 - PLAYFIELD_SPRITE_OFFSET - 1) / PLAYFIELD_TILE_SIZE;
+
+	return Playfield_IsSolid(the_first_col, the_first_row) || Playfield_IsSolid(the_last_col, the_first_row) ||
+		Playfield_IsSolid(the_first_col, the_last_row) || Playfield_IsSolid(the_last_col, the_last_row);
+}
+
+
+// copy the world tile at col/row into its ring cell, if the ring holds it. leaves the playfield bank mapped.
+void Playfield_ShowTile(uint8_t the_col, uint8_t the_row)
+{
+	uint8_t		the_ring_col;
+	uint8_t		the_ring_row;
+
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	// unsigned: anything left of/above the ring wraps around to a big number, so one compare covers both sides
+	the_ring_col = the_col - ring_first_col;
+	the_ring_row = the_row - ring_first_row;
+
+	if (the_ring_col >= PLAYFIELD_RING_COLS || the_ring_row >= PLAYFIELD_RING_ROWS)
+	{
+		return;
+	}
+
+	the_ring_col += ring_col_phase;
+	the_ring_row += ring_row_phase;
+
+	if (the_ring_col >= PLAYFIELD_RING_COLS)
+	{
+		the_ring_col -= PLAYFIELD_RING_COLS;
+	}
+
+	if (the_ring_row >= PLAYFIELD_RING_ROWS)
+	{
+		the_ring_row -= PLAYFIELD_RING_ROWS;
+	}
+
+	Playfield_WriteRingCell(the_ring_col, the_ring_row, R8(PLAYFIELD_WORLD_CPU_ADDR + (uint16_t)the_row * PLAYFIELD_WORLD_COLS + the_col));
+}
+
+
+// copy world column the_col into ring column the_ring_col, for the rows the ring holds. leaves the playfield bank mapped.
+void Playfield_ShowColumn(uint8_t the_col, uint8_t the_ring_col)
+{
+	App_LoadOverlay(PLAYFIELD_BANK);
+	Playfield_WriteRingColumn(the_col, the_ring_col);
+}
+
+
+// copy world row the_row into ring row the_ring_row, for the columns the ring holds. leaves the playfield bank mapped.
+void Playfield_ShowRow(uint8_t the_row, uint8_t the_ring_row)
+{
+	App_LoadOverlay(PLAYFIELD_BANK);
+	Playfield_WriteRingRow(the_row, the_ring_row);
+}
+
+
+// copy every world tile the ring holds into it. leaves the playfield bank mapped.
+void Playfield_ShowRing(void)
+{
+	uint8_t		i;
+
+	App_LoadOverlay(PLAYFIELD_BANK);
+
+	for (i = 0; i < PLAYFIELD_RING_ROWS; i++)
+	{
+		Playfield_WriteRingRow(ring_first_row + i, (ring_row_phase + i) % PLAYFIELD_RING_ROWS);
+	}
+}
@@ -0,0 +1,185 @@
+/*
+ * playfield.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef PLAYFIELD_H_
+#define PLAYFIELD_H_
+
+
+/* about this class: Playfield
+ *
+ * The scrolling world the game takes place in: a map several screens across, a camera that follows the player,
+ *   and the VICKY tilemap that shows the part of the world under the camera.
+ *
+ *** things this class needs to be able to do
+ * build the world map for a new game: a grid of rooms, each the one-screen TILEMAP asset, with doorways between them
+ * move the camera with the player, and keep VICKY's tilemap in step by writing only the newly exposed column/row
+ * read and change single world tiles (blood), updating the screen if the tile is in view
+ * say whether a box in the world overlaps a solid (wall/obstacle) tile, without mapping anything in
+ *
+ *** how the VICKY tilemap works as a ring
+ *
+ * VICKY doesn't wrap a tilemap when it scrolls off the end, so the ring is stored twice in each direction:
+ *   world tile (col, row) goes to ring cell (col % RING_COLS, row % RING_ROWS), and to the same cell + RING_COLS
+ *   across and/or + RING_ROWS down. VICKY's map is 2x the ring in each direction, and the scroll registers only
+ *   ever point into the first half, so whatever 21x16 tile window is on screen is always laid out contiguously.
+ *   when the camera crosses a tile boundary, the one column (or row) that just came into view replaces the one
+ *   that just left: RING_ROWS x 4 (or RING_COLS x 4) byte writes, never a full map rewrite.
+ *
+ *** coordinates
+ *
+ * sprite/object x,y (zp_px, Sprite.x1_, etc.) are world pixels, still with VICKY's 32 px sprite offset built in.
+ *   screen (sprite register) position = world position - global_camera_x/y. see Level_RenderSprites().
+ *
+ *** solid tiles
+ *
+ * whether a tile is solid depends only on which tile it is: playfield.c has a PLAYFIELD_TILE_ATTR_* entry for each
+ *   clean tile in tiles.bin (walls, and the void under the bottom wall, are solid). blood doesn't change it.
+ * every room is the TILEMAP asset, so the same 20x15 pattern of solid tiles holds for each of them:
+ *   Playfield_BuildWorldMap() packs it into 300 bits (PLAYFIELD_SOLID_LEN bytes) in MAIN RAM, and a lookup is
+ *   a mod, a shift, and a mask. the only exception is the doorways between rooms, which are floor. they're at fixed
+ *   spots in each room's walls (PLAYFIELD_DOOR_*), so that's a couple of compares, and only for tiles the bits say
+ *   are solid.
+ *
+ *** memory
+ *
+ * one 8K bank (PLAYFIELD_PHYS_ADDR, reserved in pgz_manifest.txt): the ring tilemap VICKY reads, then the world map,
+ *   1 byte per tile (all tiles are in tileset 0, LUT 0, so the tilemap's high bytes stay 0). what's left over
+ *   (PLAYFIELD_SPARE_CPU_ADDR) holds flow_field.c's search tables.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define PLAYFIELD_TILE_SIZE				16
+#define PLAYFIELD_SCREEN_WIDTH			320
+#define PLAYFIELD_SCREEN_HEIGHT			240
+#define PLAYFIELD_SCREEN_COLS			(PLAYFIELD_SCREEN_WIDTH / PLAYFIELD_TILE_SIZE)		// 20, also the width of the TILEMAP asset
+#define PLAYFIELD_SCREEN_ROWS			(PLAYFIELD_SCREEN_HEIGHT / PLAYFIELD_TILE_SIZE)		// 15
+#define PLAYFIELD_SPRITE_OFFSET			32		// VICKY sprite coords put 0,0 at 32 px above/left of the screen
+
+// world size, in rooms of one screen each. 1x1 gives the original single-screen arena.
+#define PLAYFIELD_SCREENS_ACROSS		3
+#define PLAYFIELD_SCREENS_DOWN			3
+#define PLAYFIELD_WORLD_COLS			(PLAYFIELD_SCREEN_COLS * PLAYFIELD_SCREENS_ACROSS)
+#define PLAYFIELD_WORLD_ROWS			(PLAYFIELD_SCREEN_ROWS * PLAYFIELD_SCREENS_DOWN)
+#define PLAYFIELD_WORLD_WIDTH			(PLAYFIELD_WORLD_COLS * PLAYFIELD_TILE_SIZE)
+#define PLAYFIELD_WORLD_HEIGHT			(PLAYFIELD_WORLD_ROWS * PLAYFIELD_TILE_SIZE)
+#define PLAYFIELD_CAMERA_MAX_X			(PLAYFIELD_WORLD_WIDTH - PLAYFIELD_SCREEN_WIDTH)
+#define PLAYFIELD_CAMERA_MAX_Y			(PLAYFIELD_WORLD_HEIGHT - PLAYFIELD_SCREEN_HEIGHT)
+
+// ring: enough columns/rows for a screen plus the partial tile a fine scroll exposes
+#define PLAYFIELD_RING_COLS				(PLAYFIELD_SCREEN_COLS + 2)		// 22
+#define PLAYFIELD_RING_ROWS				(PLAYFIELD_SCREEN_ROWS + 1)		// 16
+#define PLAYFIELD_RING_MAP_COLS			(PLAYFIELD_RING_COLS * 2)		// what VICKY is told the map size is
+#define PLAYFIELD_RING_MAP_ROWS			(PLAYFIELD_RING_ROWS * 2)
+#define PLAYFIELD_RING_MAP_LEN			(PLAYFIELD_RING_MAP_COLS * PLAYFIELD_RING_MAP_ROWS * 2)	// 2 bytes per VICKY tilemap entry
+
+#define PLAYFIELD_PHYS_ADDR				0x14000		// bank 0x0A. keep pgz_manifest.txt PLAYFIELD in sync
+#define PLAYFIELD_BANK					((uint8_t)(PLAYFIELD_PHYS_ADDR / 0x2000))
+#define PLAYFIELD_RING_PHYS_ADDR		PLAYFIELD_PHYS_ADDR
+#define PLAYFIELD_RING_LO_ADDR			(PLAYFIELD_RING_PHYS_ADDR & 0xFF)
+#define PLAYFIELD_RING_MED_ADDR			((PLAYFIELD_RING_PHYS_ADDR >> 8) & 0xFF)
+#define PLAYFIELD_RING_HI_ADDR			((PLAYFIELD_RING_PHYS_ADDR >> 16) & 0xFF)
+#define PLAYFIELD_CPU_SLOT				0x05		// mapped into the overlay slot while being changed, like TILEMAP_SLOT
+#define PLAYFIELD_RING_CPU_ADDR			0xA000
+#define PLAYFIELD_WORLD_CPU_ADDR		(PLAYFIELD_RING_CPU_ADDR + PLAYFIELD_RING_MAP_LEN)
+#define PLAYFIELD_SPARE_CPU_ADDR		(PLAYFIELD_WORLD_CPU_ADDR + PLAYFIELD_WORLD_COLS * PLAYFIELD_WORLD_ROWS)	// flow_field.c's tables
+#define PLAYFIELD_SPARE_LEN				(PLAYFIELD_RING_CPU_ADDR + 0x2000 - PLAYFIELD_SPARE_CPU_ADDR)
+
+// tiles.bin: clean and bloody tiles alternate (even = clean), then one last clean floor tile
+#define PLAYFIELD_CLEAN_TILES			11
+#define PLAYFIELD_TILE_FLOOR			0x10		// the plain floor. doorways are cut with it.
+#define PLAYFIELD_TILE_ATTR_SOLID		0x01		// walls: sprites can't move onto it, missiles stop at it
+
+// doorways: through the middle of every wall two rooms share, cut through the wall tiles on both sides
+#define PLAYFIELD_DOOR_FIRST_ROW		6			// left/right walls: rows 6-8 of the room
+#define PLAYFIELD_DOOR_ROWS				3
+#define PLAYFIELD_DOOR_FIRST_COL		8			// top/bottom walls: cols 8-11 of the room
+#define PLAYFIELD_DOOR_COLS				4
+
+// solid tiles: 1 bit per tile of one room, first col in the high bit of each row's first byte
+#define PLAYFIELD_SOLID_ROW_BYTES		((PLAYFIELD_SCREEN_COLS + 7) / 8)				// 3
+#define PLAYFIELD_SOLID_LEN				(PLAYFIELD_SOLID_ROW_BYTES * PLAYFIELD_SCREEN_ROWS)	// 45
+
+#if (PLAYFIELD_RING_MAP_LEN + PLAYFIELD_WORLD_COLS * PLAYFIELD_WORLD_ROWS) > 0x2000
+	#error "playfield: ring tilemap + world map must fit in one 8K bank. shrink PLAYFIELD_SCREENS_ACROSS/DOWN"
+#endif
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// build a clean (no blood) world map: the TILEMAP asset in every room, with the doorways between them cut. and the solid tile bits.
+// leaves the playfield bank mapped into the overlay slot
+void Playfield_BuildWorldMap(void);
+
+// put the camera on the player and draw the whole ring. for the start of a game, or after a warp
+void Playfield_SnapToPlayer(void);
+
+// move the camera toward the player, and queue the ring columns/rows that brings into view for the next Present flush.
+// call once per frame, after the player moves.
+void Playfield_FollowPlayer(void);
+
+// tile number at world tile col/row
+uint8_t Playfield_GetTile(uint8_t the_col, uint8_t the_row);
+
+// change the tile at world tile col/row. it reaches the screen at the next Present flush, if it is in the ring.
+void Playfield_SetTile(uint8_t the_col, uint8_t the_row, uint8_t the_tile);
+
+// true if the tile at world tile col/row is solid
+bool Playfield_IsSolid(uint8_t the_col, uint8_t the_row);
+
+// true if any tile under the box is solid. x1/y1/x2/y2 are world pixels like Sprite's: x2/y2 are 1 past the box.
+// the box must be inside LEVEL_MIN_X..LEVEL_MAX_Y, and no more than 1 tile across/down.
+bool Playfield_BoxIsSolid(uint16_t the_x1, uint16_t the_y1, uint16_t the_x2, uint16_t the_y2);
+
+// copy the world tile at col/row into its ring cell, if the ring holds it. leaves the playfield bank mapped.
+// Present calls this for the tiles Playfield_SetTile() queued
+void Playfield_ShowTile(uint8_t the_col, uint8_t the_row);
+
+// copy world column the_col into ring column the_ring_col, for the rows the ring holds. leaves the playfield bank mapped.
+// Present calls this for the columns Playfield_FollowPlayer() queued
+void Playfield_ShowColumn(uint8_t the_col, uint8_t the_ring_col);
+
+// copy world row the_row into ring row the_ring_row, for the columns the ring holds. leaves the playfield bank mapped.
+// Present calls this for the rows Playfield_FollowPlayer() queued
+void Playfield_ShowRow(uint8_t the_row, uint8_t the_ring_row);
+
+// copy every world tile the ring holds into it. leaves the playfield bank mapped.
+void Playfield_ShowRing(void);
+
+
+#endif /* PLAYFIELD_H_ */
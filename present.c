@@ -0,0 +1,467 @@
+/*
+ * present.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "present.h"
+#include "app.h"
+#include "comm_buffer.h"
+#include "general.h"
+#include "keyboard.h"
+#include "level.h"
+#include "memory.h"
+#include "playfield.h"
+#include "sys.h"
+#include "telemetry.h"
+#include "text.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+#ifndef HOST_BUILD
+	#include "api.h"
+	#include "kernel.h"
+#endif
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define LOG_FILE_ID		LOG_FILE_PRESENT
+
+#define PRESENT_HUD_ROW				STAT_FIRST_ROW
+#define PRESENT_HUD_CLEAN			0xFF	// hud_first_dirty_ when there is nothing to draw
+#define PRESENT_RING_IS_ROW			0x80	// set in a ring_index_ entry: it's a ring row, not a column
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+// everything one frame's simulation left for the screen
+typedef struct PresentFrame {
+	bool			player_dirty_;
+	uint16_t		player_lomed_;
+	uint16_t		player_x_;
+	uint16_t		player_y_;
+	bool			scroll_dirty_;
+	uint16_t		scroll_x_;
+	uint16_t		scroll_y_;
+	uint8_t			ring_count_;
+	uint8_t			ring_line_[PRESENT_MAX_RING_LINES];		// world col or row that came into the ring
+	uint8_t			ring_index_[PRESENT_MAX_RING_LINES];	// the ring col or row it goes in. PRESENT_RING_IS_ROW set for rows.
+	bool			ring_redraw_;							// more lines than the queue holds: redraw the whole ring instead
+	uint8_t			tile_count_;
+	uint8_t			tile_col_[PRESENT_MAX_TILES];
+	uint8_t			tile_row_[PRESENT_MAX_TILES];
+	PresentSprite	sprite_[PRESENT_MAX_SPRITES];		// register images, in the order they were rendered. ends at present_sprite_tail.
+	PresentSprite*	sprite_end_;						// where present_sprite_tail got to, once the frame is done
+	char			hud_[SCREEN_NUM_COLS];				// what the HUD row should show after this frame's flush
+	uint8_t			hud_first_dirty_;
+	uint8_t			hud_last_dirty_;
+} PresentFrame;
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static PresentFrame		present_frame;
+
+static uint8_t			present_frames_late;				// flushes that found the frame timer already waiting
+
+#ifndef HOST_BUILD
+	static volatile bool	present_frame_started;			// the frame timer went off since the last flush
+#endif
+
+#ifdef PROFILE_PRESENT
+	static uint32_t			profile_ticks;					// timer 0 ticks spent in flushes since the last report
+	static uint32_t			profile_worst_ticks;			// longest single flush since the last report
+	static uint8_t			profile_frames;
+	static uint32_t			profile_text_vram_bytes;		// global_text_vram_bytes at the last report
+#endif
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+PresentSprite*				present_sprite_tail = present_frame.sprite_;		// next free register image in the frame
+
+extern uint8_t				zp_bank_slot;
+extern uint8_t				zp_bank_num;
+extern uint8_t				zp_old_bank_num;
+extern uint8_t				zp_old_io_page;
+
+#pragma zpsym ("zp_bank_slot");
+#pragma zpsym ("zp_bank_num");
+#pragma zpsym ("zp_old_bank_num");
+#pragma zpsym ("zp_old_io_page");
+
+#ifndef HOST_BUILD
+	extern struct event_t	event;
+	#pragma zpsym ("event");
+#endif
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// put everything the frame queued on screen, and empty it. leaves the MMU, the IO page, and the zp save slots for both as it found them.
+static void Present_Flush(void);
+
+// add a ring column or row (the_index has PRESENT_RING_IS_ROW set) to the frame
+static void Present_QueueRingLine(uint8_t the_line, uint8_t the_index);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+
+// put everything the frame queued on screen, and empty it. leaves the MMU, the IO page, and the zp save slots for both as it found them.
+static void Present_Flush(void)
+{
+	uint8_t			saved_io_page;
+	uint8_t			saved_old_io_page;
+	uint8_t			saved_overlay_bank;
+	uint8_t			saved_bank_slot;
+	uint8_t			saved_bank_num;
+	uint8_t			saved_old_bank_num;
+	uint8_t			i;
+	PresentSprite*	the_sprite;
+
+	// LOGIC:
+	//   whatever was going on when the flush started has to come back exactly: the IO page in $01, and the zp slots
+	//   Sys_SwapIOPage() and Memory_SwapInNewBank() stash the previous setting in, in case a Restore is still to come.
+	//   registers first (sprites, scroll), since those are what tear if they land after the beam starts down the screen.
+	//   cost is bounded by the frame: PRESENT_MAX_SPRITES + 1 sprites, 4 scroll bytes, PRESENT_MAX_RING_LINES ring
+	//   columns/rows (or the whole ring, after a jump), PRESENT_MAX_TILES tiles, 1 HUD row.
+	//   nothing here reads a Sprite or the player: only what the frame captured by the end of App_RunFrame().
+	saved_io_page = R8(MMU_IO_CTRL);
+	saved_old_io_page = zp_old_io_page;
+
+#ifdef PROFILE_PRESENT
+	Sys_Timer0Start();
+#endif
+
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+
+	if (present_frame.player_dirty_)
+	{
+		R8(SPRITE0_ADDR_LO) = present_frame.player_lomed_ & 0xFF;
+		R8(SPRITE0_ADDR_MED) = present_frame.player_lomed_ >> 8;
+		R16(SPRITE0_X_LO) = present_frame.player_x_;
+		R16(SPRITE0_Y_LO) = present_frame.player_y_;
+		present_frame.player_dirty_ = false;
+	}
+
+	if (present_frame.scroll_dirty_)
+	{
+		R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_X_LO) = present_frame.scroll_x_ & 0xFF;
+		R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_X_HI) = present_frame.scroll_x_ >> 8;
+		R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_Y_LO) = present_frame.scroll_y_ & 0xFF;
+		R8(TILE0_CTRL + TILE_CTRL_OFFSET_SCROLL_Y_HI) = present_frame.scroll_y_ >> 8;
+		present_frame.scroll_dirty_ = false;
+	}
+
+	// humans and missiles: the register images Level_RenderSprites() made
+	for (the_sprite = present_frame.sprite_; the_sprite != present_frame.sprite_end_; the_sprite++)
+	{
+		memcpy(the_sprite->reg_addr_, the_sprite->regs_, SPRITE_REG_LEN);
+	}
+
+	present_frame.sprite_end_ = present_frame.sprite_;
+
+	if (present_frame.ring_count_ > 0 || present_frame.ring_redraw_ || present_frame.tile_count_ > 0)
+	{
+		saved_bank_slot = zp_bank_slot;
+		saved_bank_num = zp_bank_num;
+		saved_old_bank_num = zp_old_bank_num;
+		zp_bank_slot = OVERLAY_CPU_BANK;
+		saved_overlay_bank = Memory_GetMappedBankNum();
+
+		// LOGIC:
+		//   ring lines go in with the scroll above, so the newly exposed column/row and the scroll that shows it land together.
+		//   they're written for where the ring is now, which is where the frame that queued them left it: nothing moves the
+		//   camera between the end of a frame and its flush. so a column and a row exposed in the same frame both come out whole.
+		if (present_frame.ring_redraw_)
+		{
+			Playfield_ShowRing();
+		}
+		else
+		{
+			for (i = 0; i < present_frame.ring_count_; i++)
+			{
+				if (present_frame.ring_index_[i] & PRESENT_RING_IS_ROW)
+				{
+					Playfield_ShowRow(present_frame.ring_line_[i], present_frame.ring_index_[i] & ~PRESENT_RING_IS_ROW);
+				}
+				else
+				{
+					Playfield_ShowColumn(present_frame.ring_line_[i], present_frame.ring_index_[i]);
+				}
+			}
+		}
+
+		present_frame.ring_count_ = 0;
+		present_frame.ring_redraw_ = false;
+
+		for (i = 0; i < present_frame.tile_count_; i++)
+		{
+			Playfield_ShowTile(present_frame.tile_col_[i], present_frame.tile_row_[i]);
+		}
+
+		present_frame.tile_count_ = 0;
+
+		App_LoadOverlay(saved_overlay_bank);
+		zp_bank_slot = saved_bank_slot;
+		zp_bank_num = saved_bank_num;
+		zp_old_bank_num = saved_old_bank_num;
+	}
+
+	if (present_frame.hud_first_dirty_ != PRESENT_HUD_CLEAN)
+	{
+#ifdef USE_TEXT_SHADOW
+		Text_DrawCharsAtXY(present_frame.hud_first_dirty_, PRESENT_HUD_ROW, (uint8_t*)&present_frame.hud_[present_frame.hud_first_dirty_], present_frame.hud_last_dirty_ - present_frame.hud_first_dirty_ + 1);
+#else
+		Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
+		memcpy(Text_GetMemLocForXY(present_frame.hud_first_dirty_, PRESENT_HUD_ROW), &present_frame.hud_[present_frame.hud_first_dirty_], present_frame.hud_last_dirty_ - present_frame.hud_first_dirty_ + 1);
+		TEXT_COUNT_VRAM(present_frame.hud_last_dirty_ - present_frame.hud_first_dirty_ + 1);
+#endif
+		present_frame.hud_first_dirty_ = PRESENT_HUD_CLEAN;
+	}
+
+	// the HUD and whatever else was drawn as text this frame: only the cells that changed
+	TEXT_FLUSH();
+
+#ifdef PROFILE_PRESENT
+	{
+		uint32_t	the_ticks = Sys_Timer0Stop();
+
+		profile_ticks += the_ticks;
+
+		if (the_ticks > profile_worst_ticks)
+		{
+			profile_worst_ticks = the_ticks;
+		}
+	}
+
+	if (++profile_frames == PROFILE_FRAMES_PER_REPORT)
+	{
+		LOG_INFO(("%s %d: flush: %lu cycles/frame, worst %lu, late %u of %u", __func__, __LINE__, profile_ticks / (PROFILE_FRAMES_PER_REPORT * TIMER0_TICKS_PER_CPU_CYCLE), profile_worst_ticks / TIMER0_TICKS_PER_CPU_CYCLE, present_frames_late, PROFILE_FRAMES_PER_REPORT));
+		LOG_INFO(("%s %d: text VRAM: %lu bytes/frame", __func__, __LINE__, (global_text_vram_bytes - profile_text_vram_bytes) / PROFILE_FRAMES_PER_REPORT));
+		profile_text_vram_bytes = global_text_vram_bytes;
+		profile_ticks = 0;
+		profile_worst_ticks = 0;
+		profile_frames = 0;
+		present_frames_late = 0;
+	}
+#endif
+
+	// put the IO page back, then the save slot, so a pending Sys_RestoreIOPage() still goes where it would have
+	zp_old_io_page = saved_io_page;
+	Sys_RestoreIOPage();
+	zp_old_io_page = saved_old_io_page;
+}
+
+
+// add a ring column or row (the_index has PRESENT_RING_IS_ROW set) to the frame
+static void Present_QueueRingLine(uint8_t the_line, uint8_t the_index)
+{
+	// a jump of more than a few tiles (nothing but a warp does that) isn't worth tracking line by line
+	if (present_frame.ring_count_ == PRESENT_MAX_RING_LINES)
+	{
+		present_frame.ring_redraw_ = true;
+		return;
+	}
+
+	present_frame.ring_line_[present_frame.ring_count_] = the_line;
+	present_frame.ring_index_[present_frame.ring_count_] = the_index;
+	++present_frame.ring_count_;
+}
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// clear the frame, and start the frame timer. call once the game is set up, before the first frame.
+void Present_Init(void)
+{
+	present_frame.player_dirty_ = false;
+	present_frame.scroll_dirty_ = false;
+	present_frame.ring_count_ = 0;
+	present_frame.ring_redraw_ = false;
+	present_frame.tile_count_ = 0;
+	present_frame.sprite_end_ = present_frame.sprite_;
+	present_frame.hud_first_dirty_ = PRESENT_HUD_CLEAN;
+	present_sprite_tail = present_frame.sprite_;
+
+	present_frames_late = 0;
+
+#ifndef HOST_BUILD
+	present_frame_started = false;
+
+	if (Kernel_SetFrameTimer(Kernel_GetFrameCount() + 1, PRESENT_FRAME_COOKIE) == false)
+	{
+		LOG_ERR(("%s %d: kernel refused the frame timer", __func__, __LINE__));
+	}
+#endif
+
+	TELEMETRY_START_FRAME();
+}
+
+
+// Keyboard_ProcessEvents() passes timer events with PRESENT_FRAME_COOKIE here: notes the new frame, sets the next timer
+void Present_HandleFrameEvent(void)
+{
+#ifndef HOST_BUILD
+	present_frame_started = true;
+	Kernel_SetFrameTimer(event.timer.value + 1, PRESENT_FRAME_COOKIE);
+#endif
+}
+
+
+// finish this frame, wait for the start of the next one, then put everything this frame queued on screen
+void Present_EndFrame(void)
+{
+	// the frame is done. nothing queues into it again until the flush below has emptied it.
+	present_frame.sprite_end_ = present_sprite_tail;
+
+#ifndef HOST_BUILD
+	if (present_frame_started)
+	{
+		++present_frames_late;
+	}
+
+	TELEMETRY_END_FRAME(present_frame_started);
+
+	// the time left over is when binary log records and telemetry go out the UART
+	while (present_frame_started == false)
+	{
+		Keyboard_ProcessEvents();
+		SERIAL_DRAIN();
+	}
+
+	present_frame_started = false;
+#else
+	TELEMETRY_END_FRAME(false);
+	SERIAL_DRAIN();
+#endif
+
+	TELEMETRY_START_FRAME();
+	Present_Flush();
+	present_sprite_tail = present_frame.sprite_;
+}
+
+
+// the player's sprite shape (LO+MED address) and screen position, for the next flush
+void Present_SetPlayerSprite(uint16_t the_lomed_addr, uint16_t the_x, uint16_t the_y)
+{
+	present_frame.player_lomed_ = the_lomed_addr;
+	present_frame.player_x_ = the_x;
+	present_frame.player_y_ = the_y;
+	present_frame.player_dirty_ = true;
+}
+
+
+// tilemap scroll register values, for the next flush
+void Present_SetScroll(uint16_t the_scroll_x, uint16_t the_scroll_y)
+{
+	present_frame.scroll_x_ = the_scroll_x;
+	present_frame.scroll_y_ = the_scroll_y;
+	present_frame.scroll_dirty_ = true;
+}
+
+
+// world column the_col came into the ring as ring column the_ring_col: copy it there at the next flush
+void Present_QueueRingColumn(uint8_t the_col, uint8_t the_ring_col)
+{
+	Present_QueueRingLine(the_col, the_ring_col);
+}
+
+
+// world row the_row came into the ring as ring row the_ring_row: copy it there at the next flush
+void Present_QueueRingRow(uint8_t the_row, uint8_t the_ring_row)
+{
+	Present_QueueRingLine(the_row, the_ring_row | PRESENT_RING_IS_ROW);
+}
+
+
+// world tile col/row changed and may be in the ring: copy it to the ring at the next flush
+void Present_QueueTile(uint8_t the_col, uint8_t the_row)
+{
+	// LOGIC:
+	//   the queue holds world col/row, not ring cells: the flush reads the tile back out of the world map, and works out
+	//   where it is in the ring then. so a tile changed twice in a frame, or scrolled out before the flush, still ends up right.
+	//   a full queue means a burst of changes: draw this one now rather than let the queue grow.
+	if (present_frame.tile_count_ == PRESENT_MAX_TILES)
+	{
+		Playfield_ShowTile(the_col, the_row);
+		return;
+	}
+
+	present_frame.tile_col_[present_frame.tile_count_] = the_col;
+	present_frame.tile_row_[present_frame.tile_count_] = the_row;
+	++present_frame.tile_count_;
+}
+
+
+// set the whole HUD row shadow to spaces without marking anything to draw: the screen has just been cleared to match
+void Present_ClearHud(void)
+{
+	memset(present_frame.hud_, CH_SPACE, SCREEN_NUM_COLS);
+	present_frame.hud_first_dirty_ = PRESENT_HUD_CLEAN;
+}
+
+
+// write the_string into the HUD row shadow at the_col. only characters that differ are drawn at the next flush.
+void Present_SetHudString(uint8_t the_col, char* the_string)
+{
+	while (*the_string != 0 && the_col < SCREEN_NUM_COLS)
+	{
+		Present_SetHudChar(the_col++, *the_string++);
+	}
+}
+
+
+// write one character into the HUD row shadow at the_col
+void Present_SetHudChar(uint8_t the_col, uint8_t the_char)
+{
+	if (present_frame.hud_[the_col] == the_char)
+	{
+		return;
+	}
+
+	present_frame.hud_[the_col] = the_char;
+
+	if (present_frame.hud_first_dirty_ == PRESENT_HUD_CLEAN)
+	{
+		present_frame.hud_first_dirty_ = present_frame.hud_last_dirty_ = the_col;
+	}
+	else if (the_col < present_frame.hud_first_dirty_)
+	{
+		present_frame.hud_first_dirty_ = the_col;
+	}
+	else if (the_col > present_frame.hud_last_dirty_)
+	{
+		present_frame.hud_last_dirty_ = the_col;
+	}
+}
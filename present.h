@@ -0,0 +1,134 @@
+/*
+ * present.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef PRESENT_H_
+#define PRESENT_H_
+
+
+/* about this class: Present
+ *
+ * Holds everything the game wants to show until the start of the next frame, then puts it all on screen at once:
+ *   sprite registers, the tilemap scroll, the ring columns/rows the camera exposed, tiles that changed in view, and HUD characters.
+ *   The frame loop only simulates and queues; nothing reaches VICKY mid-frame, so nothing tears.
+ * There is one of everything. Present_EndFrame() flushes it before it returns, so simulation and the flush never
+ *   overlap, and a second frame to build into while the last one goes out would buy nothing. the flush only reads
+ *   what was queued, never a Sprite or the player, so making it run alongside simulation later wouldn't change callers.
+ *
+ *** things this class needs to be able to do
+ * keep the player sprite, scroll registers, and the stat row as shadows that only go to VICKY when they changed
+ * keep VICKY register images of the humans and missiles that changed, made by Level_RenderSprites()
+ * queue the ring columns/rows a camera move exposed, so they reach the tilemap in the same flush as the scroll that shows them
+ * queue up to PRESENT_MAX_TILES in-view tile changes per frame. past that, tiles go straight to the ring.
+ * wait for start of frame, then apply it all in one bounded pass that leaves the MMU and IO page as it found them
+ *
+ *** how to use it
+ *
+ * Present_Init() once the game is set up: it starts the kernel frame timer
+ * during the frame: Present_SetPlayerSprite(), Present_SetScroll(), Present_QueueRingColumn()/Row(), Present_QueueTile(), Present_SetHudString()
+ * end of simulation: Level_RenderSprites() adds a register image at present_sprite_tail for each human/missile that changed
+ * end of App_RunFrame(): Present_EndFrame()
+ *
+ *** about the frame timer
+ *
+ * the MicroKernel owns the IRQ vector and has no way to chain a handler onto it, so the flush can't run inside the
+ *   start-of-frame interrupt itself. instead the kernel's TIMER_FRAMES timer, which it runs off that interrupt, is set
+ *   one frame ahead each frame. Present_EndFrame() pumps events until it arrives, and flushes straight away.
+ *   if simulation ran over a frame, the event is already waiting and the flush happens late, mid-frame.
+ *   PROFILE_PRESENT logs the flush cost and how often that happens.
+ * host builds have no frame timer: Present_EndFrame() just flushes.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "level.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// F256 includes
+#include "f256.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define PRESENT_MAX_TILES			8		// in-view tile changes queued per frame. Level_MakeTileBloody() makes 1 per kill.
+#define PRESENT_MAX_RING_LINES		4		// ring columns/rows queued per frame. the camera follows the player, so usually 0 or 1.
+#define PRESENT_FRAME_COOKIE		126		// timer cookie for the frame timer. keyboard.c keeps its repeat cookies off it.
+#define PRESENT_MAX_SPRITES			(LEVEL_MAX_HUMANS + LEVEL_MAX_MISSILES)	// register images per frame: each one changes at most once
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+// one sprite's VICKY registers as they should be after the flush.
+typedef struct PresentSprite {
+	uint8_t		regs_[SPRITE_REG_LEN];		// state, addr lo/med/hi, screen x, screen y. same order as in Sprite, up to x1_/y1_.
+	uint8_t*	reg_addr_;					// the sprite's VICKY registers (Sprite.sprite_reg_addr_)
+} PresentSprite;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern PresentSprite*	present_sprite_tail;	// next free register image in the frame being built
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// clear the frame, and start the frame timer. call once the game is set up, before the first frame.
+void Present_Init(void);
+
+// Keyboard_ProcessEvents() passes timer events with PRESENT_FRAME_COOKIE here: notes the new frame, sets the next timer
+void Present_HandleFrameEvent(void);
+
+// finish this frame, wait for the start of the next one, then put everything this frame queued on screen
+void Present_EndFrame(void);
+
+// the player's sprite shape (LO+MED address) and screen position, for the next flush
+void Present_SetPlayerSprite(uint16_t the_lomed_addr, uint16_t the_x, uint16_t the_y);
+
+// tilemap scroll register values, for the next flush
+void Present_SetScroll(uint16_t the_scroll_x, uint16_t the_scroll_y);
+
+// world column the_col came into the ring as ring column the_ring_col: copy it there at the next flush
+void Present_QueueRingColumn(uint8_t the_col, uint8_t the_ring_col);
+
+// world row the_row came into the ring as ring row the_ring_row: copy it there at the next flush
+void Present_QueueRingRow(uint8_t the_row, uint8_t the_ring_row);
+
+// world tile col/row changed and may be in the ring: copy it to the ring at the next flush
+void Present_QueueTile(uint8_t the_col, uint8_t the_row);
+
+// set the whole HUD row shadow to spaces without marking anything to draw: the screen has just been cleared to match
+void Present_ClearHud(void);
+
+// write the_string into the HUD row shadow at the_col. only characters that differ are drawn at the next flush.
+// the HUD row's colors are left alone: whoever drew its background set them.
+void Present_SetHudString(uint8_t the_col, char* the_string);
+
+// write one character into the HUD row shadow at the_col
+void Present_SetHudChar(uint8_t the_col, uint8_t the_char);
+
+
+#endif /* PRESENT_H_ */
@@ -0,0 +1,437 @@
+/*
+ * replay.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "replay.h"
+#include "file_io.h"
+#include "general.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define LOG_FILE_ID		LOG_FILE_REPLAY
+
+// recording can go out the serial logging path instead of to disk, but only if that path has been set up (UART is initialized by General_LogInitialize)
+#if defined INPUT_RECORD && defined USE_SERIAL_LOGGING && (defined LOG_LEVEL_1 || defined LOG_LEVEL_2 || defined LOG_LEVEL_3 || defined LOG_LEVEL_4 || defined LOG_LEVEL_5)
+	#define REPLAY_VIA_SERIAL
+#endif
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint8_t			replay_buffer[REPLAY_BUFFER_LEN];
+static uint8_t			replay_buffer_pos;		// next byte to write (record) or read (playback)
+static uint8_t			replay_key;				// key action of the current run
+static uint8_t			replay_joy;				// ZP_JOY byte of the current run
+static uint8_t			replay_run_len;			// frames seen so far in current run (record), or frames remaining in it (playback)
+static bool				replay_is_open = false;		// stream is open and its header written/checked. stays open across games
+static bool				replay_is_active = false;	// a game is being recorded or played back
+static bool				replay_is_finished = false;	// stream closed, or couldn't be opened. it isn't reopened, so later games are live
+
+#ifndef REPLAY_VIA_SERIAL
+	static uint8_t		replay_file = FILEIO_INVALID_HANDLE;	// a FileIO handle
+#endif
+
+#if defined INPUT_RECORD && !defined REPLAY_VIA_SERIAL
+	static uint8_t		replay_write_buffer[REPLAY_BUFFER_LEN];	// what the kernel is taking, while new runs fill replay_buffer
+#endif
+
+#ifdef INPUT_PLAYBACK
+	static uint8_t		replay_buffer_used;		// number of valid bytes read into the buffer
+#endif
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern uint8_t				zp_joy;
+#pragma zpsym ("zp_joy");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+#ifdef INPUT_RECORD
+	// send whatever is in the buffer to disk or serial, and reset it
+	static void Replay_FlushBuffer(void);
+
+	// add one byte to the outgoing stream, flushing the buffer when it fills
+	static void Replay_WriteByte(uint8_t the_byte);
+
+	// add the current run to the outgoing stream, if there is one
+	static void Replay_WriteRun(void);
+
+	// open the outgoing stream and write its header. returns false if it couldn't be opened
+	static bool Replay_OpenStream(void);
+#else
+	// get the next byte of the incoming stream, refilling the buffer from disk as needed
+	// returns -1 when the stream is exhausted or on any read error
+	static int16_t Replay_ReadByte(void);
+
+	// load the next run from the incoming stream. returns false at the end of the game, or if the stream is exhausted
+	static bool Replay_ReadRun(void);
+
+	// open the incoming stream and check its header. returns false if it couldn't be opened or isn't usable
+	static bool Replay_OpenStream(void);
+#endif
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+#ifdef INPUT_RECORD
+
+// send whatever is in the buffer to disk or serial, and reset it
+static void Replay_FlushBuffer(void)
+{
+	#ifdef REPLAY_VIA_SERIAL
+		uint8_t		i;
+
+		for (i = 0; i < replay_buffer_pos; i++)
+		{
+			Serial_SendByte(replay_buffer[i]);
+		}
+	#else
+		// LOGIC:
+		//   the write before this one went out at least REPLAY_BUFFER_LEN / REPLAY_RUN_LEN frames ago, so it's done
+		//   unless the disk is very slow, and then this waits for it. the game never waits on the write it starts here.
+		FileIO_Wait(replay_file);
+		memcpy(replay_write_buffer, replay_buffer, replay_buffer_pos);
+
+		if (FileIO_Write(replay_file, replay_write_buffer, replay_buffer_pos) == false)
+		{
+			LOG_ERR(("%s %d: %u bytes of the replay stream were lost", __func__, __LINE__, replay_buffer_pos));
+		}
+	#endif
+
+	replay_buffer_pos = 0;
+}
+
+
+// add one byte to the outgoing stream, flushing the buffer when it fills
+static void Replay_WriteByte(uint8_t the_byte)
+{
+	replay_buffer[replay_buffer_pos++] = the_byte;
+
+	if (replay_buffer_pos == REPLAY_BUFFER_LEN)
+	{
+		Replay_FlushBuffer();
+	}
+}
+
+
+// add the current run to the outgoing stream, if there is one
+static void Replay_WriteRun(void)
+{
+	if (replay_run_len == 0)
+	{
+		return;
+	}
+
+	Replay_WriteByte(replay_key);
+	Replay_WriteByte(replay_joy);
+	Replay_WriteByte(replay_run_len);
+
+	replay_run_len = 0;
+}
+
+
+// open the outgoing stream and write its header. returns false if it couldn't be opened
+static bool Replay_OpenStream(void)
+{
+	replay_buffer_pos = 0;
+
+	#ifndef REPLAY_VIA_SERIAL
+		// the open finishes a few frames from now. the header and first runs wait in the buffer until then.
+		replay_file = FileIO_Open(REPLAY_FILE_PATH, true);
+
+		if (replay_file == FILEIO_INVALID_HANDLE || FileIO_GetState(replay_file) == FILEIO_FAILED)
+		{
+			FileIO_Release(replay_file);
+			LOG_ERR(("%s %d: could not open '%s' for recording", __func__, __LINE__, REPLAY_FILE_PATH));
+			return false;
+		}
+	#endif
+
+	Replay_WriteByte(REPLAY_MAGIC_1);
+	Replay_WriteByte(REPLAY_MAGIC_2);
+	Replay_WriteByte(REPLAY_VERSION);
+
+	return true;
+}
+
+#else
+
+// get the next byte of the incoming stream, refilling the buffer from disk as needed
+// returns -1 when the stream is exhausted or on any read error
+static int16_t Replay_ReadByte(void)
+{
+	if (replay_buffer_pos == replay_buffer_used)
+	{
+		// LOGIC: the frame can't go on without its input, so this waits for it. once every REPLAY_BUFFER_LEN bytes.
+		if (FileIO_Read(replay_file, replay_buffer, REPLAY_BUFFER_LEN) == false)
+		{
+			return -1;
+		}
+
+		FileIO_Wait(replay_file);
+
+		if (FileIO_GetState(replay_file) != FILEIO_READY || FileIO_GetCount(replay_file) == 0)
+		{
+			return -1;
+		}
+
+		replay_buffer_used = (uint8_t)FileIO_GetCount(replay_file);
+		replay_buffer_pos = 0;
+	}
+
+	return replay_buffer[replay_buffer_pos++];
+}
+
+
+// load the next run from the incoming stream. returns false at the end of the game, or if the stream is exhausted
+static bool Replay_ReadRun(void)
+{
+	int16_t		the_key;
+	int16_t		the_joy;
+	int16_t		the_len;
+
+	the_key = Replay_ReadByte();
+	the_joy = Replay_ReadByte();
+	the_len = Replay_ReadByte();
+
+	if (the_key < 0 || the_joy < 0 || the_len < 0)
+	{
+		// a session that was cut off mid-game ends without a marker: nothing more to play back, in this game or any later one
+		LOG_INFO(("%s %d: replay stream exhausted", __func__, __LINE__));
+		Replay_Finish();
+		return false;
+	}
+
+	if (the_len == 0)
+	{
+		return false;	// end-of-game marker
+	}
+
+	replay_key = the_key;
+	replay_joy = the_joy;
+	replay_run_len = the_len;
+
+	return true;
+}
+
+
+// open the incoming stream and check its header. returns false if it couldn't be opened or isn't usable
+static bool Replay_OpenStream(void)
+{
+	replay_buffer_pos = 0;
+	replay_buffer_used = 0;
+
+	replay_file = FileIO_Open(REPLAY_FILE_PATH, false);
+	FileIO_Wait(replay_file);
+
+	if (FileIO_GetState(replay_file) != FILEIO_READY)
+	{
+		LOG_ERR(("%s %d: could not open '%s' for playback", __func__, __LINE__, REPLAY_FILE_PATH));
+		FileIO_Release(replay_file);
+		return false;
+	}
+
+	// LOGIC: header read one byte at a time so the buffer stays aligned however many bytes the kernel delivers per read
+	if (Replay_ReadByte() != REPLAY_MAGIC_1 || Replay_ReadByte() != REPLAY_MAGIC_2 || Replay_ReadByte() != REPLAY_VERSION)
+	{
+		LOG_ERR(("%s %d: '%s' is not a replay stream this version can use", __func__, __LINE__, REPLAY_FILE_PATH));
+		FileIO_Release(replay_file);
+		return false;
+	}
+
+	return true;
+}
+
+#endif
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// call at the start of every game: exchanges that game's RNG seed with the stream
+// the first call opens the stream and writes or checks its header
+// when recording, the passed seed is written to the stream and returned unchanged
+// when playing back, the next seed from the stream is returned instead of the passed seed
+// if the stream can't be opened, or playback has run out of games, replay is disabled and the passed seed is returned
+uint16_t Replay_SyncSeed(uint16_t the_seed)
+{
+	#ifdef INPUT_PLAYBACK
+		int16_t		the_seed_lo;
+		int16_t		the_seed_hi;
+	#endif
+
+	replay_run_len = 0;
+
+	if (replay_is_finished)
+	{
+		return the_seed;
+	}
+
+	if (replay_is_open == false)
+	{
+		replay_is_open = Replay_OpenStream();
+
+		if (replay_is_open == false)
+		{
+			replay_is_finished = true;
+			return the_seed;
+		}
+	}
+
+	#ifdef INPUT_RECORD
+		Replay_WriteByte(the_seed & 0xFF);
+		Replay_WriteByte(the_seed >> 8);
+	#else
+		the_seed_lo = Replay_ReadByte();
+		the_seed_hi = Replay_ReadByte();
+
+		if (the_seed_lo < 0 || the_seed_hi < 0)
+		{
+			LOG_INFO(("%s %d: no more recorded games; this one is live", __func__, __LINE__));
+			Replay_Finish();
+			return the_seed;
+		}
+
+		the_seed = the_seed_lo | ((uint16_t)the_seed_hi << 8);
+	#endif
+
+	replay_is_active = true;
+
+	return the_seed;
+}
+
+
+// call once per main loop pass with the key action read from the keyboard
+// when recording, stores the key action and the current ZP_JOY byte, and returns the key action unchanged
+// when playing back, overwrites ZP_JOY with the recorded byte and returns the recorded key action
+uint8_t Replay_ProcessFrame(uint8_t the_user_input)
+{
+	if (replay_is_active == false)
+	{
+		return the_user_input;
+	}
+
+	#ifdef INPUT_RECORD
+		// LOGIC: most frames repeat the previous frame's input, so only emit when input changes or the run counter would overflow
+		if (replay_run_len > 0 && the_user_input == replay_key && zp_joy == replay_joy && replay_run_len < REPLAY_MAX_RUN_FRAMES)
+		{
+			++replay_run_len;
+		}
+		else
+		{
+			Replay_WriteRun();
+			replay_key = the_user_input;
+			replay_joy = zp_joy;
+			replay_run_len = 1;
+		}
+
+		return the_user_input;
+	#else
+		if (replay_run_len == 0)
+		{
+			if (Replay_ReadRun() == false)
+			{
+				// end of the recorded game (or of the stream): hand control back to the player until the next game
+				LOG_INFO(("%s %d: recorded game ran out of input", __func__, __LINE__));
+				replay_is_active = false;
+				zp_joy = 0;
+				return the_user_input;
+			}
+		}
+
+		--replay_run_len;
+		zp_joy = replay_joy;
+
+		return replay_key;
+	#endif
+}
+
+
+// call when a game ends. the stream stays open for the next game's Replay_SyncSeed()
+// when recording, writes the pending run and the end-of-game marker, and flushes the stream
+// when playing back, skips whatever is left of the recorded game, so the next game starts on its own seed
+void Replay_EndGame(void)
+{
+	if (replay_is_active == false)
+	{
+		return;
+	}
+
+	#ifdef INPUT_RECORD
+		Replay_WriteRun();
+		Replay_WriteByte(0);
+		Replay_WriteByte(0);
+		Replay_WriteByte(0);
+		// LOGIC: flush at every game over, so everything up to the last finished game is out even if the session never reaches Replay_Finish()
+		Replay_FlushBuffer();
+	#else
+		// LOGIC: if this game ended sooner than the recorded one, the two have diverged. skip to the marker, so the next game still lines up
+		while (Replay_ReadRun())
+		{
+		}
+	#endif
+
+	replay_is_active = false;
+}
+
+
+// flushes any pending input to the stream and closes it. call once, when the session ends
+void Replay_Finish(void)
+{
+	if (replay_is_open == false)
+	{
+		return;
+	}
+
+	#ifdef INPUT_RECORD
+		Replay_WriteRun();
+		Replay_FlushBuffer();
+	#endif
+
+	#ifndef REPLAY_VIA_SERIAL
+		// the session is ending: see the last write and the close through, so the file is whole
+		FileIO_Release(replay_file);
+		FileIO_Wait(replay_file);
+		replay_file = FILEIO_INVALID_HANDLE;
+	#endif
+
+	replay_is_open = false;
+	replay_is_active = false;
+	replay_is_finished = true;
+}
+
+
+#endif
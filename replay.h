@@ -0,0 +1,110 @@
+/*
+ * replay.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+
+/* about this class: Replay
+ *
+ * Records a play session (RNG seed + per-frame input) so it can be fed back into the main loop later.
+ *   Only compiled in when INPUT_RECORD or INPUT_PLAYBACK is passed by the build script.
+ *   Used to make repeatable workloads for performance comparisons, on hardware or under emulation.
+ *
+ *** things this class needs to be able to do
+ * capture the seed used for the VICKY random number generator, once per game
+ * capture the key action and the ZP_JOY byte for every pass through the main loop
+ * keep one stream open across every game of a session, so game 2 onward replays as well as game 1
+ * write the stream to disk through FileIO (file_io.h), or out the serial logging path
+ * read a stream back from disk and substitute it for live input
+ *
+ *** stream format
+ *
+ * header: 'I' 'R' version
+ * then for each game:
+ *   seed_lo seed_hi
+ *   repeated 3-byte runs of [key action] [ZP_JOY byte] [number of frames, 1-255]
+ *   end of game: a run of 0 frames [0] [0] [0]
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#ifdef HOST_BUILD
+	#define REPLAY_FILE_PATH	"infest_replay.bin"
+#else
+	#define REPLAY_FILE_PATH	"0:infest_replay.bin"
+#endif
+#define REPLAY_MAGIC_1			'I'
+#define REPLAY_MAGIC_2			'R'
+#define REPLAY_VERSION			2
+#define REPLAY_HEADER_LEN		3
+#define REPLAY_SEED_LEN			2	// bytes at the start of each game in the stream
+#define REPLAY_RUN_LEN			3	// bytes per run in the stream: key, joy, frame count
+#define REPLAY_MAX_RUN_FRAMES	255
+#define REPLAY_BUFFER_LEN		(REPLAY_RUN_LEN * 32)	// stream is written/read in chunks of this many bytes
+
+#if defined INPUT_RECORD || defined INPUT_PLAYBACK
+	#define REPLAY_PROCESS_FRAME(x)	Replay_ProcessFrame(x)
+#else
+	#define REPLAY_PROCESS_FRAME(x)	(x)
+#endif
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// call at the start of every game: exchanges that game's RNG seed with the stream
+// the first call opens the stream and writes or checks its header
+// when recording, the passed seed is written to the stream and returned unchanged
+// when playing back, the next seed from the stream is returned instead of the passed seed
+// if the stream can't be opened, or playback has run out of games, replay is disabled and the passed seed is returned
+uint16_t Replay_SyncSeed(uint16_t the_seed);
+
+// call once per main loop pass with the key action read from the keyboard
+// when recording, stores the key action and the current ZP_JOY byte, and returns the key action unchanged
+// when playing back, overwrites ZP_JOY with the recorded byte and returns the recorded key action
+uint8_t Replay_ProcessFrame(uint8_t the_user_input);
+
+// call when a game ends. the stream stays open for the next game's Replay_SyncSeed()
+// when recording, writes the pending run and the end-of-game marker, and flushes the stream
+// when playing back, skips whatever is left of the recorded game, so the next game starts on its own seed
+void Replay_EndGame(void);
+
+// flushes any pending input to the stream and closes it. call once, when the session ends
+void Replay_Finish(void);
+
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,529 @@
+/*
+ * save_state.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  Game snapshots in an EM bank, and on disk
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "save_state.h"
+#include "anim.h"
+#include "app.h"
+#include "comm_buffer.h"
+#include "file_io.h"
+#include "flow_field.h"
+#include "general.h"
+#include "level.h"
+#include "memory.h"
+#include "object.h"
+#include "player.h"
+#include "playfield.h"
+#include "strings.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// F256 includes
+#include "f256.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define LOG_FILE_ID		LOG_FILE_SAVE_STATE
+
+#define SAVE_WORLD_LEN			(PLAYFIELD_WORLD_COLS * PLAYFIELD_WORLD_ROWS)
+#define SAVE_LEN				(sizeof(SaveState) + SAVE_WORLD_LEN)
+#define SAVE_CHUNK_LEN			STORAGE_GETSTRING_BUFFER_LEN	// world map copies go through the interbank buffer
+#define SAVE_DISK_CHUNK_LEN		FILEIO_CHUNK_LEN				// disk I/O goes through SAVE_DISK_BUFFER, one chunk per frame
+
+// LOGIC:
+//   disk I/O gets its own buffer: the interbank buffer is also where General_GetString() and logging write,
+//   and those can happen on any frame while a save is going. it's a STORAGE_ pool, not BSS (app.h).
+#define SAVE_DISK_BUFFER		((uint8_t*)HAL_CPU_PTR(STORAGE_SAVE_DISK_BUFFER))
+
+STORAGE_CHECK_FITS(STORAGE_SAVE_DISK_BUFFER, SAVE_DISK_CHUNK_LEN);
+
+#define SAVE_DISK_IDLE			0
+#define SAVE_DISK_WRITING		1
+#define SAVE_DISK_READING		2
+
+// everything but the world map, which follows it in SAVE_BANK. only ever accessed while SAVE_BANK is mapped.
+typedef struct SaveState {
+	uint8_t		magic_[2];
+	uint8_t		version_;
+	uint16_t	len_;
+	// the zero page game variables (zp_layout.txt). the per-frame scratch doesn't need saving.
+	uint16_t	px_;
+	uint16_t	py_;
+	uint8_t		num_bullets_;
+	uint8_t		num_clips_;
+	uint8_t		num_warps_;
+	uint8_t		speed_;
+	uint16_t	points_;
+	int8_t		hp_;
+	uint8_t		bullet_dmg_;
+	uint8_t		player_dir_;
+	int8_t		lives_;
+	uint16_t	ticktock_;
+	Player		player_;
+	Sprite		humans_[LEVEL_MAX_HUMANS];
+	Sprite		missiles_[LEVEL_MAX_MISSILES];
+	Sprite		chips_[LEVEL_MAX_CHIPS];
+	Sprite		clips_[LEVEL_MAX_CLIPS];
+	Sprite		poo_[LEVEL_MAX_POO];
+} SaveState;
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint8_t		save_disk_job = SAVE_DISK_IDLE;
+static uint8_t		save_disk_file = FILEIO_INVALID_HANDLE;
+static uint16_t		save_disk_offset;			// bytes of the snapshot written, or read into SAVE_BANK, so far
+static bool			save_disk_read_pending;		// a FileIO_Read() has gone out and its bytes aren't in SAVE_BANK yet
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern Player*				global_player;
+extern Sprite				global_missiles[LEVEL_MAX_MISSILES];
+extern Sprite				global_humans[LEVEL_MAX_HUMANS];
+extern Sprite				global_chips[LEVEL_MAX_CHIPS];
+extern Sprite				global_clips[LEVEL_MAX_CLIPS];
+extern Sprite				global_poo[LEVEL_MAX_POO];
+
+extern uint8_t				zp_bank_num;
+#pragma zpsym ("zp_bank_num");
+
+extern uint16_t				zp_px;
+extern uint16_t				zp_py;
+extern uint8_t				zp_num_bullets;
+extern uint8_t				zp_num_clips;
+extern uint8_t				zp_num_warps;
+extern uint8_t				zp_speed;
+extern uint16_t				zp_points;
+extern int8_t				zp_hp;
+extern uint8_t				zp_bullet_dmg;
+extern uint8_t				zp_player_dir;
+extern int8_t				zp_lives;
+extern uint8_t				zp_player_dir_prev;
+extern uint16_t				zp_ticktock;
+
+#pragma zpsym ("zp_px");
+#pragma zpsym ("zp_py");
+#pragma zpsym ("zp_num_bullets");
+#pragma zpsym ("zp_num_clips");
+#pragma zpsym ("zp_num_warps");
+#pragma zpsym ("zp_speed");
+#pragma zpsym ("zp_points");
+#pragma zpsym ("zp_hp");
+#pragma zpsym ("zp_bullet_dmg");
+#pragma zpsym ("zp_player_dir");
+#pragma zpsym ("zp_lives");
+#pragma zpsym ("zp_player_dir_prev");
+#pragma zpsym ("zp_ticktock");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// copy the world map between the playfield bank and SAVE_BANK, a page at a time through the interbank buffer
+// to_save=true copies the world into SAVE_BANK. leaves the playfield bank mapped
+void Save_CopyWorld(bool to_save);
+
+// move the next chunk of the snapshot between SAVE_BANK and SAVE_DISK_BUFFER. to_save=true copies into SAVE_BANK.
+void Save_CopyDiskChunk(bool to_save, uint16_t the_len);
+
+// the disk job is over, one way or the other: free the file, and tell the player how it went
+void Save_FinishDiskJob(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+
+// copy the world map between the playfield bank and SAVE_BANK, a page at a time through the interbank buffer
+// to_save=true copies the world into SAVE_BANK. leaves the playfield bank mapped
+void Save_CopyWorld(bool to_save)
+{
+	uint8_t*	the_world = HAL_CPU_PTR(PLAYFIELD_WORLD_CPU_ADDR);
+	uint8_t*	the_save = HAL_CPU_PTR(SAVE_CPU_ADDR + sizeof(SaveState));
+	uint8_t*	the_buffer = HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER);
+	uint16_t	the_remaining = SAVE_WORLD_LEN;
+	uint16_t	this_len;
+
+	App_LoadOverlay(PLAYFIELD_BANK);
+	zp_bank_num = SAVE_BANK;
+
+	while (the_remaining > 0)
+	{
+		this_len = (the_remaining > SAVE_CHUNK_LEN) ? SAVE_CHUNK_LEN : the_remaining;
+
+		if (to_save == true)
+		{
+			memcpy(the_buffer, the_world, this_len);
+			Memory_SwapInNewBank(SAVE_SLOT);
+			memcpy(the_save, the_buffer, this_len);
+			Memory_RestorePreviousBank(SAVE_SLOT);
+		}
+		else
+		{
+			Memory_SwapInNewBank(SAVE_SLOT);
+			memcpy(the_buffer, the_save, this_len);
+			Memory_RestorePreviousBank(SAVE_SLOT);
+			memcpy(the_world, the_buffer, this_len);
+		}
+
+		// Memory_RestorePreviousBank() leaves zp_bank_num set to the playfield bank
+		zp_bank_num = SAVE_BANK;
+
+		the_world += this_len;
+		the_save += this_len;
+		the_remaining -= this_len;
+	}
+}
+
+
+// move the next chunk of the snapshot between SAVE_BANK and SAVE_DISK_BUFFER. to_save=true copies into SAVE_BANK.
+void Save_CopyDiskChunk(bool to_save, uint16_t the_len)
+{
+	uint8_t*	the_save = HAL_CPU_PTR(SAVE_CPU_ADDR + save_disk_offset);
+
+	zp_bank_num = SAVE_BANK;
+	Memory_SwapInNewBank(SAVE_SLOT);
+
+	if (to_save == true)
+	{
+		memcpy(the_save, SAVE_DISK_BUFFER, the_len);
+	}
+	else
+	{
+		memcpy(SAVE_DISK_BUFFER, the_save, the_len);
+	}
+
+	Memory_RestorePreviousBank(SAVE_SLOT);
+}
+
+
+// the disk job is over, one way or the other: free the file, and tell the player how it went
+void Save_FinishDiskJob(void)
+{
+	bool	is_complete = (FileIO_GetState(save_disk_file) == FILEIO_CLOSED && save_disk_offset == SAVE_LEN);
+
+	FileIO_Release(save_disk_file);
+	save_disk_file = FILEIO_INVALID_HANDLE;
+
+	if (save_disk_job == SAVE_DISK_WRITING)
+	{
+		save_disk_job = SAVE_DISK_IDLE;
+
+		if (is_complete == false)
+		{
+			LOG_ERR(("%s %d: write to '%s' failed", __func__, __LINE__, SAVE_FILE_PATH));
+		}
+
+		Buffer_NewMessage(General_GetString(is_complete ? ID_STR_MSG_GAME_SAVED : ID_STR_MSG_SAVED_NOT_TO_DISK));
+		return;
+	}
+
+	save_disk_job = SAVE_DISK_IDLE;
+
+	if (is_complete == true && Save_Restore() == true)
+	{
+		Buffer_NewMessage(General_GetString(ID_STR_MSG_GAME_RESTORED));
+		return;
+	}
+
+	// LOGIC:
+	//   the file was read straight over the old snapshot, so if it turns out to be short or not ours, that's gone too.
+	//   knock out the header so what's left in SAVE_BANK is never mistaken for a snapshot.
+	//   if nothing was read, the old snapshot (if any) is still good.
+	if (save_disk_offset > 0)
+	{
+		LOG_ERR(("%s %d: '%s' is not a snapshot this version can use", __func__, __LINE__, SAVE_FILE_PATH));
+
+		zp_bank_num = SAVE_BANK;
+		Memory_SwapInNewBank(SAVE_SLOT);
+		*HAL_CPU_PTR(SAVE_CPU_ADDR) = 0;
+		Memory_RestorePreviousBank(SAVE_SLOT);
+	}
+
+	Buffer_NewMessage(General_GetString(ID_STR_MSG_NO_SAVED_GAME));
+}
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// copy the game in progress into SAVE_BANK, replacing any snapshot already there
+// leaves the playfield bank mapped into the overlay slot
+void Save_Snapshot(void)
+{
+	SaveState*	the_state = (SaveState*)HAL_CPU_PTR(SAVE_CPU_ADDR);
+
+	zp_bank_num = SAVE_BANK;
+	Memory_SwapInNewBank(SAVE_SLOT);
+
+	// LOGIC:
+	//   the header goes in last, after the world map: a snapshot cut short never looks like a good one.
+	the_state->magic_[0] = 0;
+
+	the_state->px_ = zp_px;
+	the_state->py_ = zp_py;
+	the_state->num_bullets_ = zp_num_bullets;
+	the_state->num_clips_ = zp_num_clips;
+	the_state->num_warps_ = zp_num_warps;
+	the_state->speed_ = zp_speed;
+	the_state->points_ = zp_points;
+	the_state->hp_ = zp_hp;
+	the_state->bullet_dmg_ = zp_bullet_dmg;
+	the_state->player_dir_ = zp_player_dir;
+	the_state->lives_ = zp_lives;
+	the_state->ticktock_ = zp_ticktock;
+
+	memcpy(&the_state->player_, global_player, sizeof(Player));
+	memcpy(the_state->humans_, global_humans, sizeof(global_humans));
+	memcpy(the_state->missiles_, global_missiles, sizeof(global_missiles));
+	memcpy(the_state->chips_, global_chips, sizeof(global_chips));
+	memcpy(the_state->clips_, global_clips, sizeof(global_clips));
+	memcpy(the_state->poo_, global_poo, sizeof(global_poo));
+
+	Memory_RestorePreviousBank(SAVE_SLOT);
+
+	Save_CopyWorld(true);
+
+	zp_bank_num = SAVE_BANK;
+	Memory_SwapInNewBank(SAVE_SLOT);
+	the_state->version_ = SAVE_VERSION;
+	the_state->len_ = SAVE_LEN;
+	the_state->magic_[1] = SAVE_MAGIC_2;
+	the_state->magic_[0] = SAVE_MAGIC_1;
+	Memory_RestorePreviousBank(SAVE_SLOT);
+}
+
+
+// true if SAVE_BANK holds a snapshot this build can restore
+bool Save_HasSnapshot(void)
+{
+	SaveState*	the_state = (SaveState*)HAL_CPU_PTR(SAVE_CPU_ADDR);
+	bool		is_valid;
+
+	zp_bank_num = SAVE_BANK;
+	Memory_SwapInNewBank(SAVE_SLOT);
+	is_valid = (the_state->magic_[0] == SAVE_MAGIC_1 && the_state->magic_[1] == SAVE_MAGIC_2 && the_state->version_ == SAVE_VERSION && the_state->len_ == SAVE_LEN);
+	Memory_RestorePreviousBank(SAVE_SLOT);
+
+	return is_valid;
+}
+
+
+// put the game back the way it was at the snapshot in SAVE_BANK. returns false (and changes nothing) if there isn't one.
+// the next Present flush shows it. leaves the playfield bank mapped into the overlay slot
+bool Save_Restore(void)
+{
+	SaveState*	the_state = (SaveState*)HAL_CPU_PTR(SAVE_CPU_ADDR);
+	uint8_t		i;
+
+	if (Save_HasSnapshot() == false)
+	{
+		return false;
+	}
+
+	zp_bank_num = SAVE_BANK;
+	Memory_SwapInNewBank(SAVE_SLOT);
+
+	zp_px = the_state->px_;
+	zp_py = the_state->py_;
+	zp_num_bullets = the_state->num_bullets_;
+	zp_num_clips = the_state->num_clips_;
+	zp_num_warps = the_state->num_warps_;
+	zp_speed = the_state->speed_;
+	zp_points = the_state->points_;
+	zp_hp = the_state->hp_;
+	zp_bullet_dmg = the_state->bullet_dmg_;
+	zp_player_dir = the_state->player_dir_;
+	zp_lives = the_state->lives_;
+	zp_ticktock = the_state->ticktock_;
+
+	memcpy(global_player, &the_state->player_, sizeof(Player));
+	memcpy(global_humans, the_state->humans_, sizeof(global_humans));
+	memcpy(global_missiles, the_state->missiles_, sizeof(global_missiles));
+	memcpy(global_chips, the_state->chips_, sizeof(global_chips));
+	memcpy(global_clips, the_state->clips_, sizeof(global_clips));
+	memcpy(global_poo, the_state->poo_, sizeof(global_poo));
+
+	Memory_RestorePreviousBank(SAVE_SLOT);
+
+	Save_CopyWorld(false);
+
+	// LOGIC:
+	//   everything else follows from what was just restored. the camera and ring jump the way they do for a warp,
+	//   and every human/missile gets a fresh register image, so ones that were on and now aren't get turned off.
+	Playfield_SnapToPlayer();
+	FlowField_Reset();
+
+	for (i = 0; i < LEVEL_MAX_HUMANS; i++)
+	{
+		global_humans[i].render_needed_ = 1;
+	}
+
+	for (i = 0; i < LEVEL_MAX_MISSILES; i++)
+	{
+		global_missiles[i].render_needed_ = 1;
+	}
+
+	zp_player_dir_prev = zp_player_dir;
+	Anim_ResetPlayer();
+
+	Buffer_RefreshStatDisplay(false);
+
+	return true;
+}
+
+
+// start writing the snapshot in SAVE_BANK to SAVE_FILE_PATH. Save_Service() does the rest, and says how it went.
+// returns false if there isn't a snapshot, the disk is already busy with one, or the file couldn't be opened
+bool Save_WriteToDisk(void)
+{
+	if (save_disk_job != SAVE_DISK_IDLE || Save_HasSnapshot() == false)
+	{
+		return false;
+	}
+
+	save_disk_file = FileIO_Open(SAVE_FILE_PATH, true);
+
+	if (save_disk_file == FILEIO_INVALID_HANDLE || FileIO_GetState(save_disk_file) == FILEIO_FAILED)
+	{
+		LOG_ERR(("%s %d: could not open '%s' for writing", __func__, __LINE__, SAVE_FILE_PATH));
+		FileIO_Release(save_disk_file);
+		save_disk_file = FILEIO_INVALID_HANDLE;
+		return false;
+	}
+
+	save_disk_job = SAVE_DISK_WRITING;
+	save_disk_offset = 0;
+
+	return true;
+}
+
+
+// start reading SAVE_FILE_PATH into SAVE_BANK. once it's all in, Save_Service() restores it if it's a snapshot this build can use.
+// returns false if the disk is already busy with one, or the file couldn't be opened
+bool Save_ReadFromDisk(void)
+{
+	if (save_disk_job != SAVE_DISK_IDLE)
+	{
+		return false;
+	}
+
+	save_disk_file = FileIO_Open(SAVE_FILE_PATH, false);
+
+	if (save_disk_file == FILEIO_INVALID_HANDLE || FileIO_GetState(save_disk_file) == FILEIO_FAILED)
+	{
+		LOG_ERR(("%s %d: could not open '%s' for reading", __func__, __LINE__, SAVE_FILE_PATH));
+		FileIO_Release(save_disk_file);
+		save_disk_file = FILEIO_INVALID_HANDLE;
+		return false;
+	}
+
+	save_disk_job = SAVE_DISK_READING;
+	save_disk_offset = 0;
+	save_disk_read_pending = false;
+
+	return true;
+}
+
+
+// true while a Save_WriteToDisk() or Save_ReadFromDisk() is still going
+bool Save_IsDiskBusy(void)
+{
+	return (save_disk_job != SAVE_DISK_IDLE);
+}
+
+
+// move a disk save or load along by at most one chunk. call once per frame, before the player moves.
+// a load that completes is restored here, so the player may be somewhere else afterwards.
+void Save_Service(void)
+{
+	uint16_t	this_len;
+
+	if (save_disk_job == SAVE_DISK_IDLE)
+	{
+		return;
+	}
+
+	switch (FileIO_GetState(save_disk_file))
+	{
+		case FILEIO_READY:
+			if (save_disk_read_pending == true)
+			{
+				this_len = FileIO_GetCount(save_disk_file);
+				Save_CopyDiskChunk(true, this_len);
+				save_disk_offset += this_len;
+				save_disk_read_pending = false;
+			}
+
+			this_len = SAVE_LEN - save_disk_offset;
+
+			if (this_len == 0)
+			{
+				FileIO_Close(save_disk_file);
+				break;
+			}
+
+			if (this_len > SAVE_DISK_CHUNK_LEN)
+			{
+				this_len = SAVE_DISK_CHUNK_LEN;
+			}
+
+			if (save_disk_job == SAVE_DISK_WRITING)
+			{
+				Save_CopyDiskChunk(false, this_len);
+
+				if (FileIO_Write(save_disk_file, SAVE_DISK_BUFFER, this_len) == true)
+				{
+					save_disk_offset += this_len;
+				}
+			}
+			else
+			{
+				save_disk_read_pending = FileIO_Read(save_disk_file, SAVE_DISK_BUFFER, (uint8_t)this_len);
+			}
+			break;
+
+		case FILEIO_AT_END:
+			// a file shorter than a snapshot. Save_FinishDiskJob() sees save_disk_offset never got to SAVE_LEN.
+			save_disk_read_pending = false;
+			FileIO_Close(save_disk_file);
+			break;
+
+		case FILEIO_CLOSED:
+		case FILEIO_FAILED:
+			Save_FinishDiskJob();
+			break;
+
+		default:
+			// the kernel is still working on it
+			break;
+	}
+}
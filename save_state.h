@@ -0,0 +1,119 @@
+/*
+ * save_state.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef SAVE_STATE_H_
+#define SAVE_STATE_H_
+
+
+/* about this class: Save
+ *
+ * Snapshots a game in progress into an EM bank, and puts it back, without going through any of the new-game setup.
+ *   The same snapshot can go to disk and come back, so a session can pick up where it left off after a reboot.
+ *
+ *** things this class needs to be able to do
+ * copy the zero page game variables, the player, the sprite arrays, and the world map (blood and all) into SAVE_BANK
+ * copy them all back, and bring the camera, the ring tilemap, sprites, and HUD up to date, inside one frame
+ * write SAVE_BANK's snapshot to SAVE_FILE_PATH, and read it back into SAVE_BANK, a chunk a frame, without holding up the game
+ *
+ *** snapshot layout (at the start of SAVE_BANK, and in the file)
+ *
+ * header: 'I' 'S' version len_lo len_hi. len is the whole snapshot, header included.
+ * then the zero page variables, the Player, the humans, missiles, chips, clips, and poo, then the world map.
+ *   ~4.3K in all. Sprites hold CPU pointers to their VICKY registers, so a snapshot only makes sense to the build
+ *   that wrote it: bump SAVE_VERSION whenever Sprite, Player, or the world size change.
+ *
+ *** how the copies go
+ *
+ * DMA would do this without the CPU, but it isn't stable yet (see memory.asm), so it's memcpy with the MMU:
+ *   SAVE_BANK goes into the overlay slot, and everything in MAIN copies straight to/from it.
+ *   the world map lives in the playfield bank, which also only ever maps into the overlay slot, so it goes through
+ *   the interbank buffer (STORAGE_GETSTRING_BUFFER) a page at a time.
+ * the VICKY random number generator can't be saved: a restored game plays on with different dice.
+ *
+ *** how the disk goes
+ *
+ * Save_WriteToDisk()/Save_ReadFromDisk() only open the file. Save_Service() moves one FILEIO_CHUNK_LEN chunk
+ *   between SAVE_BANK and a buffer of its own per frame, and FileIO (file_io.h) gets it to and from the disk
+ *   while the game carries on. when the job is over, it posts a message saying how it went.
+ *   a load that comes in whole and checks out is restored straight away, from inside Save_Service().
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "memory.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define SAVE_BANK				EM_STORAGE_START_PHYS_BANK_NUM	// 0x14. asset_stream.c has the banks after it.
+#define SAVE_SLOT				EM_STORAGE_START_SLOT
+#define SAVE_CPU_ADDR			EM_STORAGE_START_CPU_ADDR
+
+#define SAVE_FILE_PATH			"0:infest_save.bin"		// host builds drop the drive (file_io.h)
+#define SAVE_MAGIC_1			'I'
+#define SAVE_MAGIC_2			'S'
+#define SAVE_VERSION			2		// 2: humans are OBJECT_TYPE_HUMAN, which sizes their hitbox
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// copy the game in progress into SAVE_BANK, replacing any snapshot already there
+// leaves the playfield bank mapped into the overlay slot
+void Save_Snapshot(void);
+
+// true if SAVE_BANK holds a snapshot this build can restore
+bool Save_HasSnapshot(void);
+
+// put the game back the way it was at the snapshot in SAVE_BANK. returns false (and changes nothing) if there isn't one.
+// the next Present flush shows it. leaves the playfield bank mapped into the overlay slot
+bool Save_Restore(void);
+
+// start writing the snapshot in SAVE_BANK to SAVE_FILE_PATH. Save_Service() does the rest, and says how it went.
+// returns false if there isn't a snapshot, the disk is already busy with one, or the file couldn't be opened
+bool Save_WriteToDisk(void);
+
+// start reading SAVE_FILE_PATH into SAVE_BANK. once it's all in, Save_Service() restores it if it's a snapshot this build can use.
+// returns false if the disk is already busy with one, or the file couldn't be opened
+bool Save_ReadFromDisk(void);
+
+// true while a Save_WriteToDisk() or Save_ReadFromDisk() is still going. SAVE_BANK mustn't be touched until it's done.
+bool Save_IsDiskBusy(void);
+
+// move a disk save or load along by at most one chunk. call once per frame, before the player moves.
+// a load that completes is restored here, so the player may be somewhere else afterwards.
+void Save_Service(void);
+
+
+#endif /* SAVE_STATE_H_ */
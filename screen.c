@@ -54,7 +54,6 @@
 /*                             Global Variables                              */
 /*****************************************************************************/
 
-extern char*				global_string[NUM_STRINGS];
 extern char*				global_string_buff1;
 // extern char*				global_string_buff2;
 
@@ -99,16 +98,18 @@ void Screen_ShowGameOver(void)
 {
 	Text_ClearScreen(APP_FOREGROUND_COLOR, APP_BACKGROUND_COLOR);
 	
-	Text_DrawStringAtXY(15, 2, "GAME OVER!", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 4, "The Humans have colonized your planet", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 5, "Everything that is not poo is now the", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 6, "property of the M.U.S.K. corporation,", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 7, "including all robots and robot parts.", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 9, "Your fellow robots are disappointed in", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 10, "your lack of productivity. You are", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(1, 11, "being reassigned to street sweeper.", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
-	Text_DrawStringAtXY(5, 14, "= Press any key to continue =", COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(15, 2, General_GetString(ID_STR_GAME_OVER_TITLE), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 4, General_GetString(ID_STR_GAME_OVER_1), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 5, General_GetString(ID_STR_GAME_OVER_2), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 6, General_GetString(ID_STR_GAME_OVER_3), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 7, General_GetString(ID_STR_GAME_OVER_4), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 9, General_GetString(ID_STR_GAME_OVER_5), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 10, General_GetString(ID_STR_GAME_OVER_6), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(1, 11, General_GetString(ID_STR_GAME_OVER_7), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(5, 14, General_GetString(ID_STR_PRESS_ANY_KEY), COLOR_BRIGHT_WHITE, COLOR_BRIGHT_WHITE);
 	
+	// the frame loop has stopped, so this screen won't be flushed unless it's done here
+	TEXT_FLUSH();
 	Keyboard_GetChar();
 
 	Text_ClearScreen(APP_FOREGROUND_COLOR, APP_BACKGROUND_COLOR);
@@ -126,6 +127,6 @@ void Screen_Render(void)
 void Screen_ShowAppAboutInfo(void)
 {
 	// show app name, version, and credit
-	Text_DrawStringAtXY(0, 59, "This game made during April 5-7, 2024 F256 Game Jam", COLOR_BRIGHT_BLUE, COLOR_BRIGHT_WHITE);
+	Text_DrawStringAtXY(0, 59, General_GetString(ID_STR_ABOUT_CREDIT), COLOR_BRIGHT_BLUE, COLOR_BRIGHT_WHITE);
 
 }
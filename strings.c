@@ -1,5 +1,5 @@
 /*
- * general.c
+ * strings.c
  *
  *  Created on: Feb 19, 2022
  *      Author: micahbly
@@ -18,7 +18,9 @@
 // project includes
 #include "strings.h"
 #include "app.h"
+#include "general.h"
 #include "memory.h"
+#include "pgz_layout.h"
 #include "sys.h"
 #include "text.h"
 
@@ -26,6 +28,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 // F256 includes
 #include "f256.h"
@@ -35,48 +38,126 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_STRINGS
+
+// the packed strings (tools/string_pack.py) live in the STRINGS asset's bank, and are read with it in the overlay slot
+#define STRINGS_BANK				((uint8_t)(STRINGS_PHYS_ADDR / 0x2000))
+#define STRINGS_SLOT				EM_STORAGE_START_SLOT
+#define STRINGS_CPU_ADDR			((STRINGS_PHYS_ADDR & 0x1FFF) + EM_STORAGE_START_CPU_ADDR)
+
+// recently used strings are kept decoded in STORAGE_STRING_CACHE, so the same message again is a copy, not a bank swap
+#define STRINGS_CACHE_SLOTS			4		// power of 2
+#define STRINGS_CACHE_SLOT_LEN		(STORAGE_STRING_CACHE_LEN / STRINGS_CACHE_SLOTS)	// strings shorter than this get cached
 
 
 /*****************************************************************************/
 /*                          File-scoped Variables                            */
 /*****************************************************************************/
 
+static uint8_t			strings_cache_id[STRINGS_CACHE_SLOTS] = {STRINGS_NO_ID, STRINGS_NO_ID, STRINGS_NO_ID, STRINGS_NO_ID};
+static uint8_t			strings_cache_next;		// cache slot the next decoded string goes in
+
 
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
-char*					global_string[NUM_STRINGS] = 
-{
-	"Hello",
-	"goodbye"
-};
-
-
+extern uint8_t			zp_bank_num;
+#pragma zpsym ("zp_bank_num");
 
 
 /*****************************************************************************/
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// map in the string bank and decode the_string_id into the_buffer. returns the length, not counting the terminator.
+static uint8_t Strings_Decode(uint8_t the_string_id, char* the_buffer);
 
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
-
-
-
+// map in the string bank and decode the_string_id into the_buffer. returns the length, not counting the terminator.
+static uint8_t Strings_Decode(uint8_t the_string_id, char* the_buffer)
+{
+	uint16_t*	the_dict = (uint16_t*)HAL_CPU_PTR(STRINGS_CPU_ADDR + STRINGS_DICT_INDEX_OFFSET);
+	uint8_t*	the_code;
+	uint8_t*	the_entry;
+	uint8_t*	the_entry_end;
+	char*		the_dst = the_buffer;
+
+	zp_bank_num = STRINGS_BANK;
+	Memory_SwapInNewBank(STRINGS_SLOT);
+
+	// LOGIC:
+	//   a code below STRINGS_FIRST_CODE is a character. the rest are dictionary entries, whose text runs from their
+	//   offset to the next entry's. string_pack.py checked nothing decodes longer than STORAGE_GETSTRING_BUFFER.
+	the_code = HAL_CPU_PTR(STRINGS_CPU_ADDR + ((uint16_t*)HAL_CPU_PTR(STRINGS_CPU_ADDR))[the_string_id]);
+
+	for (; *the_code != 0; ++the_code)
+	{
+		if (*the_code < STRINGS_FIRST_CODE)
+		{
+			*the_dst++ = *the_code;
+			continue;
+		}
+
+		the_entry = HAL_CPU_PTR(STRINGS_CPU_ADDR + the_dict[*the_code - STRINGS_FIRST_CODE]);
+		the_entry_end = HAL_CPU_PTR(STRINGS_CPU_ADDR + the_dict[*the_code - STRINGS_FIRST_CODE + 1]);
+
+		while (the_entry < the_entry_end)
+		{
+			*the_dst++ = *the_entry++;
+		}
+	}
+
+	*the_dst = 0;
+
+	Memory_RestorePreviousBank(STRINGS_SLOT);
+
+	return the_dst - the_buffer;
+}
 
 
 /*****************************************************************************/
 /*                        Public Function Definitions                        */
 /*****************************************************************************/
 
-// retrieves a string from extended memory and stashes in the first page of STORAGE_DOS_BOOT_BUFFER for the calling program to retrieve
-// returns a pointer to the string (pointer will always be to STORAGE_DOS_BOOT_BUFFER)
+// decode a string from the string bank into STORAGE_GETSTRING_BUFFER, for the calling program to use
+// returns a pointer to STORAGE_GETSTRING_BUFFER. it's good until something else uses that buffer (logging, the asset streamer, saves).
 char* General_GetString(uint8_t the_string_id)
 {
-	return global_string[the_string_id];
+	char*		the_buffer = (char*)HAL_CPU_PTR(STORAGE_GETSTRING_BUFFER);
+	char*		the_cached;
+	uint8_t		the_len;
+	uint8_t		i;
+
+	if (the_string_id >= NUM_STRINGS)
+	{
+		LOG_ERR(("%s %d: no string with ID %u", __func__, __LINE__, the_string_id));
+		the_buffer[0] = 0;
+		return the_buffer;
+	}
+
+	for (i = 0; i < STRINGS_CACHE_SLOTS; i++)
+	{
+		if (strings_cache_id[i] == the_string_id)
+		{
+			return strcpy(the_buffer, (char*)HAL_CPU_PTR(STORAGE_STRING_CACHE + i * STRINGS_CACHE_SLOT_LEN));
+		}
+	}
+
+	the_len = Strings_Decode(the_string_id, the_buffer);
+
+	// the longer strings are the one-off screens, which aren't worth pushing a short message out of the cache for
+	if (the_len < STRINGS_CACHE_SLOT_LEN)
+	{
+		the_cached = (char*)HAL_CPU_PTR(STORAGE_STRING_CACHE + strings_cache_next * STRINGS_CACHE_SLOT_LEN);
+		memcpy(the_cached, the_buffer, the_len + 1);
+		strings_cache_id[strings_cache_next] = the_string_id;
+		strings_cache_next = (strings_cache_next + 1) & (STRINGS_CACHE_SLOTS - 1);
+	}
+
+	return the_buffer;
 }
@@ -1,14 +1,53 @@
+/*
+ * strings.h
+ *
+ *  GENERATED by tools/string_pack.py from strings.txt. Do not edit: change the strings file instead.
+ *
+ *  IDs for General_GetString(), and the layout of the packed strings (strings.bin) it decodes them from.
+ *    strings.bin loads into an EM bank (STRINGS_PHYS_ADDR, pgz_layout.h); see string_pack.py for its format.
+ */
+
+#ifndef STRINGS_H_
+#define STRINGS_H_
+
 // C includes
 #include <stdint.h>
-#include <stdbool.h>
 
 
-#define ID_STR_MACHINE_K 0
-#define ID_STR_MACHINE_UNKNOWN 1
-#define NUM_STRINGS 2
-#define TOTAL_STRING_BYTES 606
+#define ID_STR_MSG_INFESTATION				0
+#define ID_STR_MSG_GAME_LOST				1
+#define ID_STR_MSG_CHANGING_CLIPS			2
+#define ID_STR_MSG_CLICK					3
+#define ID_STR_MSG_SAVE_BUSY				4
+#define ID_STR_MSG_GAME_SAVED				5
+#define ID_STR_MSG_SAVED_NOT_TO_DISK		6
+#define ID_STR_MSG_GAME_RESTORED			7
+#define ID_STR_MSG_LOADING_SAVE				8
+#define ID_STR_MSG_NO_SAVED_GAME			9
+#define ID_STR_GAME_OVER_TITLE				10
+#define ID_STR_GAME_OVER_1					11
+#define ID_STR_GAME_OVER_2					12
+#define ID_STR_GAME_OVER_3					13
+#define ID_STR_GAME_OVER_4					14
+#define ID_STR_GAME_OVER_5					15
+#define ID_STR_GAME_OVER_6					16
+#define ID_STR_GAME_OVER_7					17
+#define ID_STR_PRESS_ANY_KEY				18
+#define ID_STR_ABOUT_CREDIT					19
+
+#define NUM_STRINGS							20
+#define STRINGS_NO_ID						0xFF	// never an ID
+#define STRINGS_TEXT_BYTES					585	// what they'd take in MAIN RODATA as C literals
+#define STRINGS_PACKED_BYTES				562	// size of strings.bin
+#define STRINGS_MAX_LEN						51	// longest string, not counting the terminator
+#define STRINGS_DICT_ENTRIES				13
+#define STRINGS_DICT_INDEX_OFFSET			40	// in strings.bin: where the dictionary offsets start, after the string offsets
+#define STRINGS_FIRST_CODE					0x80	// codes from here up are dictionary entries
+
+
+// decode a string from the string bank into STORAGE_GETSTRING_BUFFER, for the calling program to use
+// returns a pointer to STORAGE_GETSTRING_BUFFER. it's good until something else uses that buffer (logging, the asset streamer, saves).
+char* General_GetString(uint8_t the_string_id);
 
 
-// retrieves a string from extended memory and stashes in the first page of STORAGE_DOS_BOOT_BUFFER for the calling program to retrieve
-// returns a pointer to the string (pointer will always be to STORAGE_DOS_BOOT_BUFFER)
-char* General_GetString(uint8_t the_string_id);
\ No newline at end of file
+#endif /* STRINGS_H_ */
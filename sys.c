@@ -28,6 +28,7 @@
 
 // cc65 includes
 #include "f256.h"
+#include "telemetry.h"
 #include "text.h"
 
 
@@ -35,6 +36,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_SYS
+
 uint8_t			io_bank_value_kernel;	// stores value for the physical bank pointing to C000-DFFF whenever we change it, so we can restore it.
 uint8_t			overlay_bank_value_kernel;	// stores value for the physical bank pointing to A000-BFFF whenever we change it, so we can restore it.
 
@@ -288,6 +291,9 @@ void Sys_EnableTextModeCursor(bool enable_it)
 }
 
 
+// host builds emulate the MMU in host/hal_host.c instead
+#ifndef HOST_BUILD
+
 // disable the I/O bank to allow RAM to be mapped into it
 // current MMU setting is saved to the 6502 stack
 void Sys_DisableIOBank(void)
@@ -302,6 +308,13 @@ void Sys_DisableIOBank(void)
 // current IO setting is saved for later restoration
 void Sys_SwapIOPage(uint8_t the_page_number)
 {
+#ifdef USE_TELEMETRY
+	if (global_telemetry_io_swaps != 0xFF)
+	{
+		++global_telemetry_io_swaps;
+	}
+#endif
+
 	asm("lda $01");	// Stash the current IO page at ZP_OLD_IO_PAGE
 	asm("sta %b", ZP_OLD_IO_PAGE);
 	R8(MMU_IO_CTRL) = the_page_number;
@@ -314,6 +327,32 @@ void Sys_RestoreIOPage(void)
 	asm("lda %b", ZP_OLD_IO_PAGE);	// we stashed the previous IO page at ZP_OLD_IO_PAGE
 	asm("sta $01");	// switch back to the previous IO setting
 }	
+
+#endif
+
+
+// clear timer 0 and start it counting up at the dot clock (TIMER0_TICKS_PER_MS per ms)
+void Sys_Timer0Start(void)
+{
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	R8(TIMER0_CTRL) = TIMER_CTRL_CLEAR;
+	R8(TIMER0_CTRL) = TIMER_CTRL_ENABLE | TIMER_CTRL_COUNT_UP;
+	Sys_RestoreIOPage();
+}
+
+
+// stop timer 0 and return the ticks counted since Sys_Timer0Start()
+uint32_t Sys_Timer0Stop(void)
+{
+	uint32_t	the_ticks;
+	
+	Sys_SwapIOPage(VICKY_IO_PAGE_REGISTERS);
+	R8(TIMER0_CTRL) = 0;
+	the_ticks = R8(TIMER0_VALUE_LOW) | ((uint16_t)R8(TIMER0_VALUE_MED) << 8) | ((uint32_t)R8(TIMER0_VALUE_HI) << 16);
+	Sys_RestoreIOPage();
+	
+	return the_ticks;
+}
 	
 
 // // update the system clock with a date/time string in YY/MM/DD HH:MM format
@@ -182,6 +182,12 @@ void Sys_SwapIOPage(uint8_t the_page_number);
 // restore the previous MMU setting, which was saved by Sys_SwapIOPage()
 void Sys_RestoreIOPage(void);
 
+// clear timer 0 and start it counting up at the dot clock (TIMER0_TICKS_PER_MS per ms)
+void Sys_Timer0Start(void);
+
+// stop timer 0 and return the ticks counted since Sys_Timer0Start()
+uint32_t Sys_Timer0Stop(void);
+
 // // update the system clock with a date/time string in YY/MM/DD HH:MM format
 // // returns true if format was acceptable (and thus update of RTC has been performed).
 // bool Sys_UpdateRTC(char* datetime_from_user);
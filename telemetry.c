@@ -0,0 +1,156 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ *
+ *  One checksummed packet of game and timing stats per frame, out the serial port
+ *
+ */
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "telemetry.h"
+#include "app.h"
+#include "general.h"
+#include "level.h"
+#include "object.h"
+#include "sys.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+// F256 includes
+#include "f256.h"
+
+
+#ifdef USE_TELEMETRY
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+typedef char telemetry_packet_len_check[(sizeof(TelemetryPacket) == TELEMETRY_PACKET_LEN) ? 1 : -1];
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static TelemetryPacket	telemetry_packet;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+uint8_t					global_telemetry_io_swaps;
+
+extern Sprite			global_missiles[LEVEL_MAX_MISSILES];
+extern Sprite			global_humans[LEVEL_MAX_HUMANS];
+extern Sprite			global_chips[LEVEL_MAX_CHIPS];
+extern Sprite			global_clips[LEVEL_MAX_CLIPS];
+extern Sprite			global_poo[LEVEL_MAX_POO];
+
+extern uint16_t			zp_px;
+extern uint16_t			zp_py;
+extern int8_t			zp_hp;
+extern int8_t			zp_lives;
+#pragma zpsym ("zp_px");
+#pragma zpsym ("zp_py");
+#pragma zpsym ("zp_hp");
+#pragma zpsym ("zp_lives");
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// how many of the_count sprites starting at the_sprites are active
+static uint8_t Telemetry_CountActive(Sprite* the_sprites, uint8_t the_count);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+
+// how many of the_count sprites starting at the_sprites are active
+static uint8_t Telemetry_CountActive(Sprite* the_sprites, uint8_t the_count)
+{
+	uint8_t		num_active = 0;
+
+	for (; the_count > 0; --the_count, ++the_sprites)
+	{
+		num_active += the_sprites->is_active_;
+	}
+
+	return num_active;
+}
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// set up the serial port for telemetry (it may already be, for serial logging)
+// LOGIC: this is early in startup; the first frame's timing starts in Present_Init(), with the frame timer
+void Telemetry_Initialize(void)
+{
+	Serial_InitUART();
+	telemetry_packet.sync_ = TELEMETRY_SYNC;
+	telemetry_packet.seq_ = 0;
+}
+
+
+// the frame wait is over: start timing this frame. use TELEMETRY_START_FRAME()
+void Telemetry_StartFrame(void)
+{
+	Sys_Timer0Start();
+	global_telemetry_io_swaps = 0;
+}
+
+
+// the frame's work is done: fill in this frame's packet and queue it. use TELEMETRY_END_FRAME()
+// is_late: the frame timer went off before the work was done
+void Telemetry_EndFrame(bool is_late)
+{
+	uint8_t*	the_byte = (uint8_t*)&telemetry_packet;
+	uint8_t		the_sum = 0;
+	uint8_t		i;
+
+	// LOGIC:
+	//   timer 0 counts 4 per CPU cycle and wraps at 24 bits. cycles / 4 fits 16 bits for anything up to ~2.5 frames long.
+	telemetry_packet.io_swaps_ = global_telemetry_io_swaps;		// before stopping the timer, which swaps too
+	telemetry_packet.busy_ = Sys_Timer0Stop() / (TIMER0_TICKS_PER_CPU_CYCLE * 4);
+	telemetry_packet.px_ = zp_px;
+	telemetry_packet.py_ = zp_py;
+	telemetry_packet.hp_ = zp_hp;
+	telemetry_packet.lives_ = zp_lives;
+	telemetry_packet.humans_ = Telemetry_CountActive(global_humans, LEVEL_MAX_HUMANS);
+	telemetry_packet.missiles_ = Telemetry_CountActive(global_missiles, LEVEL_MAX_MISSILES);
+	telemetry_packet.pickups_ = Telemetry_CountActive(global_chips, LEVEL_MAX_CHIPS) + Telemetry_CountActive(global_clips, LEVEL_MAX_CLIPS) + Telemetry_CountActive(global_poo, LEVEL_MAX_POO);
+	telemetry_packet.flags_ = is_late ? TELEMETRY_LATE : 0;
+	telemetry_packet.checksum_ = 0;
+
+	for (i = 0; i < TELEMETRY_PACKET_LEN; i++)
+	{
+		the_sum += the_byte[i];
+	}
+
+	telemetry_packet.checksum_ = -the_sum;
+
+	// a full ring drops the packet. the capture tool sees the gap in seq_.
+	Serial_QueueData(the_byte, TELEMETRY_PACKET_LEN);
+
+	++telemetry_packet.seq_;
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: micahbly
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+
+/* about this class: Telemetry
+ *
+ * With USE_TELEMETRY, sends one small packet per frame over the serial port, for watching how a session goes over time:
+ *   player position and HP, how many humans, missiles, and pickups are out, how busy the frame was, and IO page swaps.
+ *   tools/telemetry_capture.py turns the stream into CSV and a plot.
+ *
+ *** things this class needs to be able to do
+ * time each frame from the end of the frame wait to the start of the next one
+ * fill in a TelemetryPacket at the end of each frame, checksum it, and queue it (Serial_QueueData(), general.h)
+ * never wait on the UART: a packet that doesn't fit in the TX ring is dropped, and the sequence number shows the gap
+ *
+ *** packet (TELEMETRY_PACKET_LEN bytes, little-endian)
+ *
+ * the same size as a binary log record (general.h), with its own sync byte, so the two can share the wire and
+ *   each decoder steps over the other's packets. the bytes of a packet add up to 0 (mod 256).
+ *
+ *** host builds
+ *
+ * packets go to whatever infest_host's -t was given (a file, or a pty from telemetry_capture.py --pty).
+ *   timer 0 isn't emulated, so busy_ is always 0 there.
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define TELEMETRY_PACKET_LEN		16
+#define TELEMETRY_SYNC				0x5A	// first byte of every packet. binary log records start with LOG_RECORD_SYNC.
+#define TELEMETRY_LATE				0x01	// flags_: this frame ran past the frame timer
+
+#ifdef USE_TELEMETRY
+	#if defined PROFILE_SPRITE_LOOPS || defined PROFILE_PRESENT
+		#error "USE_TELEMETRY times frames with timer 0, which the PROFILE_ builds use too: pick one"
+	#endif
+	#define TELEMETRY_START_FRAME()		Telemetry_StartFrame()
+	#define TELEMETRY_END_FRAME(late)	Telemetry_EndFrame(late)
+#else
+	#define TELEMETRY_START_FRAME()
+	#define TELEMETRY_END_FRAME(late)
+#endif
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+typedef struct TelemetryPacket
+{
+	uint8_t		sync_;			// TELEMETRY_SYNC
+	uint8_t		seq_;			// +1 every frame, whether or not the packet made it into the TX ring
+	uint16_t	px_;			// zp_px, zp_py: player world position
+	uint16_t	py_;
+	int8_t		hp_;			// zp_hp
+	int8_t		lives_;			// zp_lives
+	uint8_t		humans_;		// humans alive
+	uint8_t		missiles_;		// missiles in flight
+	uint8_t		pickups_;		// chips, clips, and poo lying around
+	uint8_t		io_swaps_;		// Sys_SwapIOPage() calls this frame (255 = 255 or more)
+	uint16_t	busy_;			// CPU cycles / 4 from the end of the last frame wait to the start of this one
+	uint8_t		flags_;			// TELEMETRY_LATE
+	uint8_t		checksum_;		// makes the packet's bytes add up to 0
+} TelemetryPacket;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+#ifdef USE_TELEMETRY
+	extern uint8_t		global_telemetry_io_swaps;	// Sys_SwapIOPage() counts itself here
+#endif
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                         */
+/*****************************************************************************/
+
+// set up the serial port for telemetry (it may already be, for serial logging)
+void Telemetry_Initialize(void);
+
+// the frame wait is over: start timing this frame. use TELEMETRY_START_FRAME()
+void Telemetry_StartFrame(void);
+
+// the frame's work is done: fill in this frame's packet and queue it. use TELEMETRY_END_FRAME()
+// is_late: the frame timer went off before the work was done
+void Telemetry_EndFrame(bool is_late);
+
+
+#endif /* TELEMETRY_H_ */
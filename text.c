@@ -40,6 +40,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LOG_FILE_ID		LOG_FILE_TEXT
+
 
 
 /*****************************************************************************/
@@ -55,12 +57,29 @@
 uint8_t		last_x;
 uint8_t		last_y;
 
+#ifdef USE_TEXT_SHADOW
+	// what char [0] and attr [1] memory will hold after the next flush, and per row, the columns that changed since
+	//   the last one: text_dirty_start_col to text_dirty_end_col - 1. an end of 0 means nothing in the row changed.
+	static uint8_t		text_shadow[2][SCREEN_TOTAL_BYTES];
+	static uint8_t		text_dirty_start_col[2][SCREEN_NUM_ROWS];
+	static uint8_t		text_dirty_end_col[2][SCREEN_NUM_ROWS];
+	static bool			text_shadow_is_dirty;
+#endif
+
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+#if defined PROFILE_PRESENT || defined HOST_BUILD
+	uint32_t			global_text_vram_bytes;
+#endif
+
 extern System*			global_system;
 
+extern uint8_t			zp_old_io_page;
+
+#pragma zpsym ("zp_old_io_page");
+
 
 /*****************************************************************************/
 /*                       Private Function Prototypes                         */
@@ -100,6 +119,29 @@ bool Text_FillMemoryBoxBoth(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
 //! @return	Returns false on any error/invalid input.
 bool Text_FillMemoryBox(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool for_attr, uint8_t the_fill);
 
+#ifndef USE_TEXT_SHADOW
+	//! Fill height + 1 rows of a box, in whichever of char or attribute memory is paged in
+	//! @param	the_write_loc: the box's upper left cell, from Text_GetMemLocForXY()
+	//! @param	width: width, in character cells, of the rectangle to be filled
+	//! @param	height: height, in character cells, of the rectangle to be filled, less 1
+	//! @param	the_fill: either a 1-byte character code, or a 1-byte attribute code
+	static void Text_FillRows(uint8_t* the_write_loc, uint8_t width, uint8_t height, uint8_t the_fill);
+#endif
+
+#ifdef USE_TEXT_SHADOW
+	// note that columns first_col to last_col of row y changed in the char or attr shadow
+	static void Text_MarkDirty(bool for_attr, uint8_t first_col, uint8_t last_col, uint8_t y);
+
+	// fill the_len cells of row y of the char or attr shadow from x, stopping at the right edge. off-screen rows are dropped.
+	static void Text_ShadowFill(uint8_t x, uint8_t y, uint8_t the_len, uint8_t the_fill, bool for_attr);
+
+	// copy the_len bytes into row y of the char or attr shadow from x, stopping at the right edge. off-screen rows are dropped.
+	static void Text_ShadowCopy(uint8_t x, uint8_t y, uint8_t* the_src, uint8_t the_len, bool for_attr);
+
+	// copy the dirty span of every row of the char or attr shadow into whichever of the two is paged in, and mark them clean
+	static void Text_FlushShadowMemory(bool for_attr);
+#endif
+
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
@@ -116,6 +158,22 @@ bool Text_FillMemoryBox(uint8_t x, uint8_t y, uint8_t width, uint8_t height, boo
 //! @return	Returns false on any error/invalid input.
 bool Text_FillMemory(bool for_attr, uint8_t the_fill)
 {
+#ifdef USE_TEXT_SHADOW
+	uint8_t		y;
+	
+	// LOGIC:
+	//   every row goes out whole, whatever the shadow held: what's in VRAM before the first clear isn't known,
+	//   so this is what makes the shadow and the screen agree from the next flush on
+	memset(text_shadow[for_attr], the_fill, SCREEN_TOTAL_BYTES);
+	
+	for (y = 0; y < SCREEN_NUM_ROWS; y++)
+	{
+		text_dirty_start_col[for_attr][y] = 0;
+		text_dirty_end_col[for_attr][y] = SCREEN_NUM_COLS;
+	}
+	
+	text_shadow_is_dirty = true;
+#else
 	uint16_t	the_write_len;
 	uint8_t*	the_write_loc;
 
@@ -132,10 +190,12 @@ bool Text_FillMemory(bool for_attr, uint8_t the_fill)
 	}
 
 	the_write_len = SCREEN_TOTAL_BYTES;
-	the_write_loc = (uint8_t*)SCREEN_TEXT_MEMORY_LOC;
+	the_write_loc = HAL_CPU_PTR(SCREEN_TEXT_MEMORY_LOC);
 	memset(the_write_loc, the_fill, the_write_len);
+	TEXT_COUNT_VRAM(the_write_len);
 		
 	Sys_RestoreIOPage();
+#endif
 
 	//printf("Text_FillMemory: done \n");
 	//DEBUG_OUT(("%s %d: done (for_attr=%u, the_fill=%u)", __func__, __LINE__, for_attr, the_fill));
@@ -144,6 +204,37 @@ bool Text_FillMemory(bool for_attr, uint8_t the_fill)
 }
 
 
+#ifndef USE_TEXT_SHADOW
+
+//! Fill height + 1 rows of a box, in whichever of char or attribute memory is paged in
+//! @param	the_write_loc: the box's upper left cell, from Text_GetMemLocForXY()
+//! @param	width: width, in character cells, of the rectangle to be filled
+//! @param	height: height, in character cells, of the rectangle to be filled, less 1
+//! @param	the_fill: either a 1-byte character code, or a 1-byte attribute code
+static void Text_FillRows(uint8_t* the_write_loc, uint8_t width, uint8_t height, uint8_t the_fill)
+{
+	// LOGIC:
+	//   a box as wide as the screen is one unbroken run of memory, so it's a single memset, not one per row.
+	//   DMA's 2D fill can't help here: it only reaches system RAM, and text memory is in VICKY's IO pages.
+	
+	TEXT_COUNT_VRAM((uint16_t)width * (height + 1));
+	
+	if (width == SCREEN_NUM_COLS)
+	{
+		memset(the_write_loc, the_fill, (uint16_t)SCREEN_NUM_COLS * (height + 1));
+		return;
+	}
+	
+	for (++height; height > 0; --height)
+	{
+		memset(the_write_loc, the_fill, width);
+		the_write_loc += SCREEN_NUM_COLS;
+	}
+}
+
+#endif
+
+
 //! Fill character and attribute memory for a specific box area
 //! calling function must validate screen id, coords, attribute value before passing!
 //! @param	the_screen: valid pointer to the target screen to operate on
@@ -155,28 +246,34 @@ bool Text_FillMemory(bool for_attr, uint8_t the_fill)
 //! @return	Returns false on any error/invalid input.
 bool Text_FillMemoryBoxBoth(uint8_t x, uint8_t y, uint8_t width, uint8_t height, uint8_t the_char, uint8_t the_attribute_value)
 {
+#ifdef USE_TEXT_SHADOW
+	for (++height; height > 0; --height, ++y)
+	{
+		Text_ShadowFill(x, y, width, the_char, SCREEN_FOR_TEXT_CHAR);
+		Text_ShadowFill(x, y, width, the_attribute_value, SCREEN_FOR_TEXT_ATTR);
+	}
+#else
 	uint8_t*	the_write_loc;
-	uint8_t		max_row;
+	uint8_t		the_old_io_page;
 
 	// LOGIC: 
 	//   On F256jr, the write len and write locs are same for char and attr memory, difference is IO page 2 or 3
+	//   so do every row in char memory, then every row in attr memory: 2 page swaps, however tall the box is.
+	//   the second swap stashes the char page, so put the caller's page back in the stash before restoring.
 
 	// set up initial loc
 	the_write_loc = Text_GetMemLocForXY(x, y);
 	
-	max_row = y + height;
-	
-	for (; y <= max_row; y++)
-	{
-		Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
-		memset(the_write_loc, the_attribute_value, width);
-		Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
-		memset(the_write_loc, the_char, width);
+	Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
+	the_old_io_page = zp_old_io_page;
+	Text_FillRows(the_write_loc, width, height, the_char);
 
-		the_write_loc += SCREEN_NUM_COLS;
-	}
-		
+	Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
+	Text_FillRows(the_write_loc, width, height, the_attribute_value);
+
+	zp_old_io_page = the_old_io_page;
 	Sys_RestoreIOPage();
+#endif
 			
 	return true;
 }
@@ -194,8 +291,13 @@ bool Text_FillMemoryBoxBoth(uint8_t x, uint8_t y, uint8_t width, uint8_t height,
 //! @return	Returns false on any error/invalid input.
 bool Text_FillMemoryBox(uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool for_attr, uint8_t the_fill)
 {
+#ifdef USE_TEXT_SHADOW
+	for (++height; height > 0; --height, ++y)
+	{
+		Text_ShadowFill(x, y, width, the_fill, for_attr);
+	}
+#else
 	uint8_t*	the_write_loc;
-	uint8_t		max_row;
 
 	// LOGIC: 
 	//   On F256jr, the write len and write locs are same for char and attr memory, difference is IO page 2 or 3
@@ -212,21 +314,159 @@ bool Text_FillMemoryBox(uint8_t x, uint8_t y, uint8_t width, uint8_t height, boo
 	// set up initial loc
 	the_write_loc = Text_GetMemLocForXY(x, y);
 	
-	max_row = y + height;
-	
-	for (; y <= max_row; y++)
-	{
-		memset(the_write_loc, the_fill, width);
-		the_write_loc += SCREEN_NUM_COLS;
-	}
+	Text_FillRows(the_write_loc, width, height, the_fill);
 		
 	Sys_RestoreIOPage();
+#endif
 			
 	return true;
 }
 
 
 
+#ifdef USE_TEXT_SHADOW
+
+// note that columns first_col to last_col of row y changed in the char or attr shadow
+static void Text_MarkDirty(bool for_attr, uint8_t first_col, uint8_t last_col, uint8_t y)
+{
+	uint8_t*	the_start = &text_dirty_start_col[for_attr][y];
+	uint8_t*	the_end = &text_dirty_end_col[for_attr][y];
+	
+	if (*the_end == 0)
+	{
+		*the_start = first_col;
+		*the_end = last_col + 1;
+	}
+	else
+	{
+		if (first_col < *the_start)
+		{
+			*the_start = first_col;
+		}
+		
+		if (last_col >= *the_end)
+		{
+			*the_end = last_col + 1;
+		}
+	}
+	
+	text_shadow_is_dirty = true;
+}
+
+
+// fill the_len cells of row y of the char or attr shadow from x, stopping at the right edge. off-screen rows are dropped.
+static void Text_ShadowFill(uint8_t x, uint8_t y, uint8_t the_len, uint8_t the_fill, bool for_attr)
+{
+	uint8_t*	the_loc;
+	uint8_t		first;
+	uint8_t		last;
+	
+	if (y > SCREEN_LAST_ROW || x > SCREEN_LAST_COL || the_len == 0)
+	{
+		return;
+	}
+	
+	if (the_len > SCREEN_NUM_COLS - x)
+	{
+		the_len = SCREEN_NUM_COLS - x;
+	}
+	
+	the_loc = &text_shadow[for_attr][SCREEN_NUM_COLS * y + x];
+	
+	// LOGIC:
+	//   only the cells that actually change go in the dirty span, so drawing what is already there costs no VRAM writes
+	first = 0;
+	
+	while (first < the_len && the_loc[first] == the_fill)
+	{
+		++first;
+	}
+	
+	if (first == the_len)
+	{
+		return;
+	}
+	
+	last = the_len - 1;
+	
+	while (the_loc[last] == the_fill)
+	{
+		--last;
+	}
+
+	memset(&the_loc[first], the_fill, last - first + 1);
+	Text_MarkDirty(for_attr, x + first, x + last, y);
+}
+
+
+// copy the_len bytes into row y of the char or attr shadow from x, stopping at the right edge. off-screen rows are dropped.
+static void Text_ShadowCopy(uint8_t x, uint8_t y, uint8_t* the_src, uint8_t the_len, bool for_attr)
+{
+	uint8_t*	the_loc;
+	uint8_t		first;
+	uint8_t		last;
+	
+	if (y > SCREEN_LAST_ROW || x > SCREEN_LAST_COL || the_len == 0)
+	{
+		return;
+	}
+	
+	if (the_len > SCREEN_NUM_COLS - x)
+	{
+		the_len = SCREEN_NUM_COLS - x;
+	}
+	
+	the_loc = &text_shadow[for_attr][SCREEN_NUM_COLS * y + x];
+	
+	first = 0;
+	
+	while (first < the_len && the_loc[first] == the_src[first])
+	{
+		++first;
+	}
+	
+	if (first == the_len)
+	{
+		return;
+	}
+	
+	last = the_len - 1;
+	
+	while (the_loc[last] == the_src[last])
+	{
+		--last;
+	}
+
+	memcpy(&the_loc[first], &the_src[first], last - first + 1);
+	Text_MarkDirty(for_attr, x + first, x + last, y);
+}
+
+
+// copy the dirty span of every row of the char or attr shadow into whichever of the two is paged in, and mark them clean
+static void Text_FlushShadowMemory(bool for_attr)
+{
+	uint8_t*	the_vram_loc = HAL_CPU_PTR(SCREEN_TEXT_MEMORY_LOC);
+	uint8_t*	the_shadow_loc = text_shadow[for_attr];
+	uint8_t*	the_start = text_dirty_start_col[for_attr];
+	uint8_t*	the_end = text_dirty_end_col[for_attr];
+	uint8_t		y;
+	
+	for (y = 0; y < SCREEN_NUM_ROWS; y++)
+	{
+		if (the_end[y] != 0)
+		{
+			memcpy(&the_vram_loc[the_start[y]], &the_shadow_loc[the_start[y]], the_end[y] - the_start[y]);
+			TEXT_COUNT_VRAM(the_end[y] - the_start[y]);
+			the_end[y] = 0;
+		}
+		
+		the_vram_loc += SCREEN_NUM_COLS;
+		the_shadow_loc += SCREEN_NUM_COLS;
+	}
+}
+
+#endif
+
 
 /*****************************************************************************/
 /*                        Public Function Definitions                        */
@@ -235,6 +475,35 @@ bool Text_FillMemoryBox(uint8_t x, uint8_t y, uint8_t width, uint8_t height, boo
 // ** NOTE: there is no destructor or constructor for this library, as it does not track any allocated memory. It works on the basis of a screen ID, which corresponds to the text memory for Vicky's Channel A and Channel B video memory.
 
 
+#ifdef USE_TEXT_SHADOW
+
+// copy the cells of the shadow that changed since the last flush into char and attr memory. use TEXT_FLUSH()
+void Text_FlushShadow(void)
+{
+	uint8_t		the_old_io_page;
+
+	if (text_shadow_is_dirty == false)
+	{
+		return;
+	}
+
+	// LOGIC: same 2 page swaps as Text_FillMemoryBoxBoth(), and the same putting back of the caller's page
+	Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
+	the_old_io_page = zp_old_io_page;
+	Text_FlushShadowMemory(SCREEN_FOR_TEXT_CHAR);
+
+	Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
+	Text_FlushShadowMemory(SCREEN_FOR_TEXT_ATTR);
+
+	zp_old_io_page = the_old_io_page;
+	Sys_RestoreIOPage();
+
+	text_shadow_is_dirty = false;
+}
+
+#endif
+
+
 // **** Block copy functions ****
 
 
@@ -277,7 +546,7 @@ bool Text_FillMemoryBox(uint8_t x, uint8_t y, uint8_t width, uint8_t height, boo
 // 	//the_write_len = (y2 - y1 + 1) * 80;
 // 	the_write_len = 80;
 // 
-// 	vram_from_loc = (uint8_t*)SCREEN_TEXT_MEMORY_LOC + initial_offset;
+// 	vram_from_loc = HAL_CPU_PTR(SCREEN_TEXT_MEMORY_LOC) + initial_offset;
 // 	vram_to_loc = vram_from_loc - 80;
 // 	
 // 	for (i = 0; i < num_rows; i++)
@@ -344,6 +613,30 @@ bool Text_CopyMemBoxLinearBuffer(uint8_t* the_buffer, uint8_t x1, uint8_t y1, ui
 		y2 = SCREEN_LAST_ROW;
 	}
 
+	// get initial read/write locs
+	initial_offset = (SCREEN_NUM_COLS * y1) + x1;
+	the_buffer_loc = the_buffer;
+	the_write_len = x2 - x1 + 1;
+
+#ifdef USE_TEXT_SHADOW
+	// LOGIC: reading back comes from the shadow too: it's what the screen will show, even if not flushed yet
+	the_vram_loc = &text_shadow[for_attr][initial_offset];
+
+	for (; y1 <= y2; y1++)
+	{
+		if (to_screen)
+		{
+			Text_ShadowCopy(x1, y1, the_buffer_loc, the_write_len, for_attr);
+		}
+		else
+		{
+			memcpy(the_buffer_loc, the_vram_loc, the_write_len);
+		}
+		
+		the_buffer_loc += the_write_len;
+		the_vram_loc += SCREEN_NUM_COLS;
+	}
+#else
 	if (for_attr)
 	{
 		Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
@@ -353,12 +646,7 @@ bool Text_CopyMemBoxLinearBuffer(uint8_t* the_buffer, uint8_t x1, uint8_t y1, ui
 		Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
 	}
 		
-	// get initial read/write locs
-	initial_offset = (SCREEN_NUM_COLS * y1) + x1;
-	the_buffer_loc = the_buffer;
-	the_write_len = x2 - x1 + 1;
-
-	the_vram_loc = (uint8_t*)SCREEN_TEXT_MEMORY_LOC + initial_offset;
+	the_vram_loc = HAL_CPU_PTR(SCREEN_TEXT_MEMORY_LOC) + initial_offset;
 	
 	// do copy one line at a time	
 
@@ -369,6 +657,7 @@ bool Text_CopyMemBoxLinearBuffer(uint8_t* the_buffer, uint8_t x1, uint8_t y1, ui
 		if (to_screen)
 		{
 			memcpy(the_vram_loc, the_buffer_loc, the_write_len);
+			TEXT_COUNT_VRAM(the_write_len);
 		}
 		else
 		{
@@ -380,6 +669,7 @@ bool Text_CopyMemBoxLinearBuffer(uint8_t* the_buffer, uint8_t x1, uint8_t y1, ui
 	}
 		
 	Sys_RestoreIOPage();
+#endif
 
 	return true;
 }
@@ -419,7 +709,7 @@ bool Text_CopyMemBoxLinearBuffer(uint8_t* the_buffer, uint8_t x1, uint8_t y1, ui
 // 	the_buffer_loc = the_buffer + initial_offset;
 // 	the_write_len = x2 - x1 + 1;
 // 
-// 	the_vram_loc = (uint8_t*)SCREEN_TEXT_MEMORY_LOC + initial_offset;
+// 	the_vram_loc = HAL_CPU_PTR(SCREEN_TEXT_MEMORY_LOC) + initial_offset;
 // 	
 // 	// do copy one line at a time	
 // 
@@ -575,13 +865,23 @@ bool Text_InvertBox(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
 	uint8_t			back_nibble;
 	uint8_t			fore_nibble;
 	
-	// get initial read/write loc
-	the_write_loc = Text_GetMemLocForXY(x1, y1);	
-	
 	// amount of cells to skip past once we have written the specified line len
 	skip_len = SCREEN_NUM_COLS - (x2 - x1) - 1;
 
+#ifdef USE_TEXT_SHADOW
+	if (x2 > SCREEN_LAST_COL || y2 > SCREEN_LAST_ROW)
+	{
+		return false;
+	}
+	
+	the_write_loc = &text_shadow[SCREEN_FOR_TEXT_ATTR][(SCREEN_NUM_COLS * y1) + x1];
+#else
+	// get initial read/write loc
+	the_write_loc = Text_GetMemLocForXY(x1, y1);	
+	
 	Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
+	TEXT_COUNT_VRAM((uint16_t)(x2 - x1 + 1) * (y2 - y1 + 1));
+#endif
 	
 	for (; y1 <= y2; y1++)
 	{
@@ -597,10 +897,16 @@ bool Text_InvertBox(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
 			*the_write_loc++ = the_inversed_value;
 		}
 
+#ifdef USE_TEXT_SHADOW
+		Text_MarkDirty(SCREEN_FOR_TEXT_ATTR, x1, x2, y1);
+#endif
+
 		the_write_loc += skip_len;
 	}
 		
+#ifndef USE_TEXT_SHADOW
 	Sys_RestoreIOPage();
+#endif
 
 	return true;
 }
@@ -620,14 +926,19 @@ bool Text_InvertBox(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
 //! @return	Returns false on any error/invalid input.
 bool Text_SetCharAtXY(uint8_t x, uint8_t y, uint8_t the_char)
 {
+#ifdef USE_TEXT_SHADOW
+	Text_ShadowFill(x, y, 1, the_char, SCREEN_FOR_TEXT_CHAR);
+#else
 	uint8_t*	the_write_loc;
 	
 	Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
 	
 	the_write_loc = Text_GetMemLocForXY(x, y);	
 	*the_write_loc = the_char;
+	TEXT_COUNT_VRAM(1);
 		
 	Sys_RestoreIOPage();
+#endif
 
 	last_x = x;
 	last_y = y;
@@ -644,14 +955,19 @@ bool Text_SetCharAtXY(uint8_t x, uint8_t y, uint8_t the_char)
 //! @return	Returns false on any error/invalid input.
 bool Text_SetAttrAtXY(uint8_t x, uint8_t y, uint8_t the_attribute_value)
 {
+#ifdef USE_TEXT_SHADOW
+	Text_ShadowFill(x, y, 1, the_attribute_value, SCREEN_FOR_TEXT_ATTR);
+#else
 	uint8_t*	the_write_loc;
 	
 	Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
 	
 	the_write_loc = Text_GetMemLocForXY(x, y);	
 	*the_write_loc = the_attribute_value;
+	TEXT_COUNT_VRAM(1);
 		
 	Sys_RestoreIOPage();
+#endif
 
 	last_x = x;
 	last_y = y;
@@ -721,13 +1037,19 @@ bool Text_SetColorAtXY(uint8_t x, uint8_t y, uint8_t fore_color, uint8_t back_co
 //! @return	Returns false on any error/invalid input.
 bool Text_SetCharAndColorAtXY(uint8_t x, uint8_t y, uint8_t the_char, uint8_t fore_color, uint8_t back_color)
 {
+#ifndef USE_TEXT_SHADOW
 	uint8_t*		the_write_loc;
+#endif
 	uint8_t			the_attribute_value;
 			
 	// calculate attribute value from passed fore and back colors
 	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
 	the_attribute_value = ((fore_color << 4) | back_color);
 
+#ifdef USE_TEXT_SHADOW
+	Text_ShadowFill(x, y, 1, the_attribute_value, SCREEN_FOR_TEXT_ATTR);
+	Text_ShadowFill(x, y, 1, the_char, SCREEN_FOR_TEXT_CHAR);
+#else
 	the_write_loc = Text_GetMemLocForXY(x, y);	
 	
 	Sys_SwapIOPage(VICKY_IO_PAGE_ATTR_MEM);
@@ -737,6 +1059,8 @@ bool Text_SetCharAndColorAtXY(uint8_t x, uint8_t y, uint8_t the_char, uint8_t fo
 	Sys_SwapIOPage(VICKY_IO_PAGE_CHAR_MEM);
 	*the_write_loc = the_char;
 	Sys_RestoreIOPage();
+	TEXT_COUNT_VRAM(2);
+#endif
 
 	last_x = x;
 	last_y = y;
@@ -759,6 +1083,10 @@ bool Text_SetCharAndColorAtXY(uint8_t x, uint8_t y, uint8_t the_char, uint8_t fo
 // copy n-bytes into display memory, at the X/Y position specified
 bool Text_DrawCharsAtXY(uint8_t x, uint8_t y, uint8_t* the_buffer, uint16_t the_len)
 {
+#ifdef USE_TEXT_SHADOW
+	// LOGIC: the shadow stops at the end of the row; nothing that draws chars draws more than one
+	Text_ShadowCopy(x, y, the_buffer, the_len > SCREEN_NUM_COLS ? SCREEN_NUM_COLS : the_len, SCREEN_FOR_TEXT_CHAR);
+#else
 	uint8_t*		the_char_loc;
 	uint16_t		i;
 		
@@ -774,8 +1102,10 @@ bool Text_DrawCharsAtXY(uint8_t x, uint8_t y, uint8_t* the_buffer, uint16_t the_
 	}
 
 	Sys_RestoreIOPage();
+	TEXT_COUNT_VRAM(the_len);
+#endif
 
-	last_x = x + i;
+	last_x = x + the_len;
 	last_y = y;
 	
 	return true;
@@ -972,10 +1302,12 @@ void Text_DrawBoxCoordsFancy(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uin
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawStringAtXY(uint8_t x, uint8_t y, char* the_string, uint8_t fore_color, uint8_t back_color)
 {
+#ifndef USE_TEXT_SHADOW
 	uint8_t*		the_char_loc;
 	uint8_t*		the_attr_loc;
-	uint8_t			the_attribute_value;
 	uint8_t			i;
+#endif
+	uint8_t			the_attribute_value;
 	uint8_t			max_col;
 	uint8_t			draw_len;
 	
@@ -994,6 +1326,10 @@ bool Text_DrawStringAtXY(uint8_t x, uint8_t y, char* the_string, uint8_t fore_co
 	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
 	the_attribute_value = ((fore_color << 4) | back_color);
 
+#ifdef USE_TEXT_SHADOW
+	Text_ShadowCopy(x, y, (uint8_t*)the_string, draw_len, SCREEN_FOR_TEXT_CHAR);
+	Text_ShadowFill(x, y, draw_len, the_attribute_value, SCREEN_FOR_TEXT_ATTR);
+#else
 	// set up char and attribute memory initial loc
 	the_attr_loc = the_char_loc = Text_GetMemLocForXY(x, y);
 
@@ -1017,8 +1353,10 @@ bool Text_DrawStringAtXY(uint8_t x, uint8_t y, char* the_string, uint8_t fore_co
 	memset(the_attr_loc, the_attribute_value, draw_len);
 		
 	Sys_RestoreIOPage();
+	TEXT_COUNT_VRAM(draw_len * 2);
+#endif
 
-	last_x = x + i;
+	last_x = x + draw_len;
 	last_y = y;
 	
 	return true;
@@ -1044,7 +1382,7 @@ uint8_t* Text_GetMemLocForXY(uint8_t x, uint8_t y)
 	//   So even if only 72 are showing, the screen is arranged from 0-71 for row 1, then 80-151 for row 2, etc. 
 	
 	initial_offset = (SCREEN_NUM_COLS * y) + x;
-	the_write_loc = (uint8_t*)SCREEN_TEXT_MEMORY_LOC + initial_offset;
+	the_write_loc = HAL_CPU_PTR(SCREEN_TEXT_MEMORY_LOC) + initial_offset;
 	
 	//DEBUG_OUT(("%s %d: screen=%i, x=%i, y=%i, for-attr=%i, calc=%i, loc=%p", __func__, __LINE__, (int16_t)the_screen_id, x, y, for_attr, (the_screen->text_mem_cols_ * y) + x, the_write_loc));
 
@@ -1410,6 +1748,9 @@ bool Text_GetStringFromUser(char* the_buffer, int8_t the_max_length, uint8_t sta
 	Text_SetCharAtXY(x, start_y, the_cursor_char_code);
 	//gotoxy(x, SPLASH_GET_NAME_INPUT_Y);
 	
+	// no frames go by while waiting on a key, so nothing else will flush what was just drawn
+	TEXT_FLUSH();
+	
 	while ( (the_char = Keyboard_GetChar() ) != CH_ENTER)
 	{
 		//DEBUG_OUT(("%s %d: input=%x ('%c')", __func__, __LINE__, the_char, the_char));
@@ -1558,6 +1899,8 @@ bool Text_GetStringFromUser(char* the_buffer, int8_t the_max_length, uint8_t sta
 // 				//gotoxy(x, SPLASH_GET_NAME_INPUT_Y);
 // 			}
 		}
+		
+		TEXT_FLUSH();
 	}
 
 	// user hit enter - make sure we terminate the string at the end, not where the cursor may be
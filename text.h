@@ -78,6 +78,22 @@
 #define SCREEN_COPY_TO_SCREEN	true	// param for functions doing block copy to/from screen / off-screen buffer
 #define SCREEN_COPY_FROM_SCREEN	false	// param for functions doing block copy to/from screen / off-screen buffer
 
+// USE_TEXT_SHADOW: Text_* functions draw into a copy of the screen in RAM, and Text_FlushShadow() puts only the cells
+//   that changed since the last flush into char and attr memory. Present_EndFrame() flushes every frame; anything
+//   that waits on the keyboard outside the frame loop flushes first with TEXT_FLUSH().
+#ifdef USE_TEXT_SHADOW
+	#define TEXT_FLUSH()			Text_FlushShadow()
+#else
+	#define TEXT_FLUSH()
+#endif
+
+// bytes written to char + attr memory, for PROFILE_PRESENT and infest_host to report per frame
+#if defined PROFILE_PRESENT || defined HOST_BUILD
+	#define TEXT_COUNT_VRAM(n)		global_text_vram_bytes += (n)
+#else
+	#define TEXT_COUNT_VRAM(n)
+#endif
+
 // named F256JR Default Colors (at least in SuperBASIC)
 #define COLOR_BLACK				(uint8_t)0x00
 #define COLOR_MEDIUM_GRAY		(uint8_t)0x01
@@ -196,6 +212,9 @@ typedef struct TextDialogTemplate
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+#if defined PROFILE_PRESENT || defined HOST_BUILD
+	extern uint32_t		global_text_vram_bytes;
+#endif
 
 /*****************************************************************************/
 /*                       Public Function Prototypes                          */
@@ -205,6 +224,12 @@ typedef struct TextDialogTemplate
 // ** NOTE: there is no destructor or constructor for this library, as it does not track any allocated memory.
 
 
+#ifdef USE_TEXT_SHADOW
+	// copy the cells of the shadow that changed since the last flush into char and attr memory. use TEXT_FLUSH()
+	void Text_FlushShadow(void);
+#endif
+
+
 // **** Block copy functions ****
 
 // scrolls the text and attribute memory up ONE row. e.g, row 0 is lost. row 1 becomes row 0, row 49 becomes row 48, row 49 is cleared.
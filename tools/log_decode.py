@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+#
+# log_decode.py
+#
+#  Created on: Oct 19, 2026
+#      Author: micahbly
+#
+#  Turns the binary log records a USE_BINARY_LOGGING build sends over serial back into log lines
+#
+#  usage:
+#    log_decode.py log_table.json [capture]
+#      log_table.json: the table log_table.py wrote for the build that's running. a different build's table gives nonsense.
+#      capture: a file, or the serial device itself (set it up first, e.g. stty -f /dev/tty.usbserial-xxx 57600 raw).
+#        default: stdin. lines are printed as records come in.
+#
+#  a record is LOG_RECORD_LEN bytes: sync, file ID, line (2 bytes), then argument words, all little-endian.
+#    the format's conversions say how many words were sent and what they are:
+#    %d/%i signed, %u/%x/%X/%o unsigned, %c a character, %l 2 words. %s and %p only had their address sent:
+#    __func__ is filled in from the table, other strings show as <str $xxxx>.
+#    a format starting with LOG_RECORD_PREFIX didn't send its __func__, __LINE__ at all: the message ID gives both.
+#  bytes that don't start a known record are skipped (and counted) until one does. telemetry packets (TELEMETRY_SYNC,
+#    telemetry.h) are the same length as records, and are stepped over without counting them.
+#
+
+import json
+import os
+import re
+import sys
+
+
+# **** definitions *****
+
+TELEMETRY_SYNC = 0x5A
+CONVERSION_RE = re.compile(r'%([-+ #0]*[0-9]*(?:\.[0-9]+)?)(h|l)?([diuxXocsp%])')
+C_ESCAPES = {"n": "", "r": "", "t": "\t", "\\": "\\", "\"": "\"", "'": "'"}
+
+
+# **** helpers *****
+
+def unescape(fmt):
+	# log lines are printed 1 per line already, so the \n some formats end in is dropped
+	return re.sub(r'\\(.)', lambda m: C_ESCAPES.get(m.group(1), m.group(1)), fmt)
+
+
+def expand(message, words, prefix, line):
+	args = message["args"]
+	fmt = message["format"]
+	state = {"arg": 0, "word": 0}
+
+	# the record doesn't carry __func__, __LINE__ for a format that starts with the prefix (log_table.py checked them)
+	if fmt.startswith(prefix):
+		fmt = fmt[len(prefix):]
+		args = args[2:]
+		lead = "%s %d: " % (message["function"] or "?", line)
+	else:
+		lead = ""
+
+	def next_word():
+		if state["word"] < len(words):
+			value = words[state["word"]]
+		else:
+			value = None
+		state["word"] += 1
+		return value
+
+	def convert(m):
+		flags, size, kind = m.group(1), m.group(2), m.group(3)
+
+		if kind == "%":
+			return "%"
+
+		arg_text = args[state["arg"]] if state["arg"] < len(args) else ""
+		state["arg"] += 1
+
+		# compile-time arguments: the decoder knows these better than the record does
+		if arg_text == "__func__":
+			next_word()
+			return message["function"] or "?"
+
+		if size == "l":
+			lo = next_word()
+			hi = next_word()
+			value = None if lo is None or hi is None else lo | (hi << 16)
+			bits = 32
+		else:
+			value = next_word()
+			bits = 16
+
+		if value is None:
+			return "?"
+		if kind == "s":
+			return "<str $%04x>" % value
+		if kind == "p":
+			return "$%04x" % value
+		if kind == "c":
+			return chr(value & 0xFF)
+		if kind in "di" and value >= 1 << (bits - 1):
+			value -= 1 << bits
+		if kind in "di":
+			kind = "d"
+		return ("%" + flags + kind) % value
+
+	return lead + CONVERSION_RE.sub(convert, unescape(fmt))
+
+
+def decode(table, stream, out):
+	record_len = table["record_len"]
+	sync = table["sync"]
+	dropped_id = table["dropped_file_id"]
+	messages = table["messages"]
+	buffer = b""
+	skipped = 0
+
+	while True:
+		chunk = stream.read(1) if len(buffer) < record_len else b""
+
+		if chunk:
+			buffer += chunk
+			continue
+
+		if len(buffer) < record_len:
+			break
+
+		file_id = buffer[1]
+		line = buffer[2] | (buffer[3] << 8)
+		key = "%d:%d" % (file_id, line)
+
+		# LOGIC:
+		#   a byte is only taken as the start of a record if the record it starts is one the table knows.
+		#   otherwise drop it and look again from the next byte.
+		if buffer[0] == TELEMETRY_SYNC and sum(buffer[:record_len]) & 0xFF == 0:
+			buffer = buffer[record_len:]
+			continue
+
+		if buffer[0] != sync or (file_id != dropped_id and key not in messages):
+			buffer = buffer[1:]
+			skipped += 1
+			continue
+
+		if skipped:
+			out.write("[DECODE] %d bytes skipped\n" % skipped)
+			skipped = 0
+
+		if file_id == dropped_id:
+			out.write("[DECODE] %d records dropped: the ring was full\n" % line)
+		else:
+			words = [buffer[i] | (buffer[i + 1] << 8) for i in range(4, record_len, 2)]
+			message = messages[key]
+			out.write("%s %s\n" % (message["level"], expand(message, words, table["prefix"], line)))
+
+		out.flush()
+		buffer = buffer[record_len:]
+
+	if skipped:
+		out.write("[DECODE] %d bytes skipped\n" % skipped)
+
+
+def main(argv):
+	if len(argv) not in (2, 3):
+		sys.stderr.write("usage: %s log_table.json [capture]\n" % os.path.basename(argv[0]))
+		return 2
+
+	with open(argv[1], "r") as f:
+		table = json.load(f)
+
+	if len(argv) == 3:
+		with open(argv[2], "rb", buffering=0) as stream:
+			decode(table, stream, sys.stdout)
+	else:
+		decode(table, sys.stdin.buffer, sys.stdout)
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+#
+# log_table.py
+#
+#  Created on: Oct 19, 2026
+#      Author: micahbly
+#
+#  Finds every log call in the game's sources and writes the table log_decode.py turns binary log records back into text with,
+#    and the header that turns each log call into a General_LogRecord() call with no format in it
+#
+#  usage:
+#    log_table.py general.h -o log_table.json -s log_sites.h source.c [source.c...] [-v]
+#      general.h: where the LOG_FILE_* IDs and the LOG_RECORD_* sizes are defined
+#      -o: the table to write
+#      -s: the header to write. general.h includes it with USE_BINARY_LOGGING, so it has to be on the include path.
+#      -v: print the table
+#
+#  with USE_BINARY_LOGGING, a log call sends a record holding its LOG_FILE_ID and __LINE__ (the message ID), and
+#    the raw words of its arguments. the table has, for each message ID: the level, the function it's in, the format,
+#    and the source text of each argument (so __func__ and __LINE__ can be filled in without being sent).
+#  the header has a LOG_SITE_<file ID>_<line> macro for each log call, taking the call's arguments. LOG_RECORD() (general.h)
+#    pastes the name together. the macro drops the format, and the __func__, __LINE__ that go with LOG_RECORD_PREFIX,
+#    and passes General_LogRecord() the message ID, the layout of what's left (LOG_RECORD_LAYOUT_*), and what's left.
+#    any other __func__ is sent as 0. so no format or function name is left in the binary.
+#
+#  checks (any failure: nothing is written, exit 1):
+#    every source with a log call defines LOG_FILE_ID as one of the LOG_FILE_* IDs, and no 2 sources use the same one
+#    no log call's arguments need more words than a record holds, and each call passes what its format takes
+#    formats starting with LOG_RECORD_PREFIX pass __func__, __LINE__ first, since those 2 are never sent
+#    conversions in the formats are ones log_decode.py knows
+#    no line has 2 log calls on it, since they'd both be LOG_SITE_<file ID>_<line>
+#
+
+import json
+import os
+import re
+import sys
+
+
+# **** definitions *****
+
+LOG_MACROS = {
+	"LOG_ERR": "[ERROR]",
+	"LOG_WARN": "[WARNING]",
+	"LOG_INFO": "[INFO]",
+	"DEBUG_OUT": "[DEBUG]",
+	"LOG_ALLOC": "[ALLOC]",
+}
+
+# a whole log call on one line: LOG_xxx(("format", arg, arg...));
+CALL_RE = re.compile(r'\b(' + "|".join(LOG_MACROS) + r')\s*\(\(\s*"((?:[^"\\]|\\.)*)"\s*(?:,(.*))?\)\)\s*;')
+FILE_ID_RE = re.compile(r'^\s*#define\s+LOG_FILE_ID\s+(LOG_FILE_\w+)')
+DEFINE_RE = re.compile(r'^\s*#define\s+(LOG_FILE_\w+|LOG_RECORD_\w+)\s+(\w+|"[^"]*")')
+DEFINES_NEEDED = ("LOG_RECORD_LEN", "LOG_RECORD_MAX_WORDS", "LOG_RECORD_SYNC", "LOG_RECORD_PREFIX", "LOG_FILE_DROPPED", "LOG_RECORD_LAYOUT_LONG")
+FUNCTION_RE = re.compile(r'^\s*(?:static\s+)?[A-Za-z_][\w\s\*]*?[\s\*](\w+)\s*\([^;]*\)\s*$')
+CONVERSION_RE = re.compile(r'%[-+ #0]*[0-9]*(?:\.[0-9]+)?(h|l)?([diuxXocsp%])')
+NOT_FUNCTIONS = ("if", "while", "for", "switch", "return", "sizeof")
+
+
+# **** helpers *****
+
+def fail(msg):
+	sys.stderr.write("log_table: %s\n" % msg)
+	sys.exit(1)
+
+
+def read_defines(header_path):
+	defines = {}
+
+	with open(header_path, "r") as f:
+		for line in f:
+			m = DEFINE_RE.match(line)
+			if m:
+				defines[m.group(1)] = m.group(2)[1:-1] if m.group(2).startswith('"') else int(m.group(2), 0)
+
+	for name in DEFINES_NEEDED:
+		if name not in defines:
+			fail("%s: no #define for %s" % (header_path, name))
+
+	return defines
+
+
+def split_args(text):
+	# split on commas that aren't inside brackets or quotes
+	args = []
+	depth = 0
+	quote = None
+	start = 0
+
+	for i, c in enumerate(text):
+		if quote:
+			if c == quote and text[i - 1] != "\\":
+				quote = None
+		elif c in "\"'":
+			quote = c
+		elif c in "([{":
+			depth += 1
+		elif c in ")]}":
+			depth -= 1
+		elif c == "," and depth == 0:
+			args.append(text[start:i].strip())
+			start = i + 1
+
+	args.append(text[start:].strip())
+	return args
+
+
+def layout_args(fmt, args, prefix, where):
+	# returns the arguments the record carries, and whether each is a long (2 words) or not (1 word)
+	skipped = 0
+	sent = []
+
+	# the LOG_SITE_ macro drops the prefix's 2 arguments, and the format itself
+	if fmt.startswith(prefix):
+		if args[:2] != ["__func__", "__LINE__"]:
+			fail("%s: a format starting \"%s\" must be passed __func__, __LINE__ first" % (where, prefix))
+		fmt = fmt[len(prefix):]
+		skipped = 2
+
+	for m in CONVERSION_RE.finditer(fmt):
+		if m.group(2) == "%":
+			continue
+		if m.group(1) == "l" and m.group(2) in "cps":
+			fail("%s: %%l%s isn't something a log record can carry" % (where, m.group(2)))
+		sent.append(m.group(1) == "l")
+
+	if len(args) - skipped != len(sent):
+		fail("%s: passes %d arguments, the format takes %d" % (where, len(args) - skipped, len(sent)))
+
+	return skipped, sent
+
+
+def scan_source(source_path, file_ids):
+	file_id = None
+	function = None
+	messages = []
+	in_block_comment = False
+
+	with open(source_path, "r", encoding="latin-1") as f:
+		lines = f.read().replace("\r\n", "\n").split("\n")
+
+	for i, line in enumerate(lines):
+		# block comments only ever hold commented-out code here. drop them, and // comments, before looking.
+		if in_block_comment:
+			if "*/" not in line:
+				continue
+			line = line[line.index("*/") + 2:]
+			in_block_comment = False
+
+		while "/*" in line:
+			if "*/" in line[line.index("/*"):]:
+				line = line[:line.index("/*")] + line[line.index("*/", line.index("/*")) + 2:]
+			else:
+				line = line[:line.index("/*")]
+				in_block_comment = True
+
+		if line.lstrip().startswith("//"):
+			continue
+
+		m = FILE_ID_RE.match(line)
+		if m:
+			if m.group(1) not in file_ids:
+				fail("%s:%d: %s is not one of the LOG_FILE_* IDs" % (source_path, i + 1, m.group(1)))
+			file_id = file_ids[m.group(1)]
+			continue
+
+		m = FUNCTION_RE.match(line)
+		if m and m.group(1) not in NOT_FUNCTIONS and i + 1 < len(lines) and lines[i + 1].strip() == "{":
+			function = m.group(1)
+			continue
+
+		calls = list(CALL_RE.finditer(line))
+		if len(calls) > 1:
+			fail("%s:%d: 2 log calls on one line get the same message ID" % (source_path, i + 1))
+		m = calls[0] if calls else None
+		if m:
+			messages.append((i + 1, m.group(1), function, m.group(2), split_args(m.group(3)) if m.group(3) else []))
+
+	if messages and file_id is None:
+		fail("%s: has log calls, but doesn't #define LOG_FILE_ID" % source_path)
+
+	return file_id, messages
+
+
+def write_table(out_path, header_path, defines, files, messages):
+	table = {
+		"generated_by": "tools/log_table.py from %s. do not edit." % os.path.basename(header_path),
+		"record_len": defines["LOG_RECORD_LEN"],
+		"max_words": defines["LOG_RECORD_MAX_WORDS"],
+		"sync": defines["LOG_RECORD_SYNC"],
+		"prefix": defines["LOG_RECORD_PREFIX"],
+		"dropped_file_id": defines["LOG_FILE_DROPPED"],
+		"files": files,
+		"messages": messages,
+	}
+
+	with open(out_path, "w") as f:
+		json.dump(table, f, indent=1, sort_keys=True)
+		f.write("\n")
+
+
+def write_sites(out_path, header_path, defines, sites):
+	with open(out_path, "w") as f:
+		f.write("// generated by tools/log_table.py from %s. do not edit.\n" % os.path.basename(header_path))
+		f.write("// one macro per log call, named for its message ID. see LOG_RECORD() in general.h.\n\n")
+		f.write("#ifndef LOG_SITES_H_\n#define LOG_SITES_H_\n\n")
+
+		for file_id, line, args, skipped, sent in sites:
+			params = ["p%d" % n for n in range(len(args) + 1)]
+			layout = len(sent)
+			values = []
+
+			for n, is_long in enumerate(sent):
+				arg = args[skipped + n]
+				if is_long:
+					layout |= defines["LOG_RECORD_LAYOUT_LONG"] << n
+					values.append("(uint32_t)(%s)" % params[skipped + n + 1])
+				elif arg == "__func__":
+					values.append("0")
+				else:
+					values.append("(uint16_t)(%s)" % params[skipped + n + 1])
+
+			f.write("#define LOG_SITE_%d_%d(%s)\tGeneral_LogRecord(%d, %d, 0x%04X%s)\n" % (file_id, line, ", ".join(params), file_id, line, layout, "".join(", " + v for v in values)))
+
+		f.write("\n#endif /* LOG_SITES_H_ */\n")
+
+
+def main(argv):
+	header_path = None
+	out_path = None
+	sites_path = None
+	source_paths = []
+	verbose = False
+
+	i = 1
+	while i < len(argv):
+		arg = argv[i]
+		if arg == "-o" and i + 1 < len(argv):
+			i += 1
+			out_path = argv[i]
+		elif arg == "-s" and i + 1 < len(argv):
+			i += 1
+			sites_path = argv[i]
+		elif arg == "-v":
+			verbose = True
+		elif header_path is None and not arg.startswith("-"):
+			header_path = arg
+		elif not arg.startswith("-"):
+			source_paths.append(arg)
+		else:
+			header_path = None
+			break
+		i += 1
+
+	if header_path is None or out_path is None or sites_path is None or not source_paths:
+		sys.stderr.write("usage: %s general.h -o log_table.json -s log_sites.h source.c [source.c...] [-v]\n" % os.path.basename(argv[0]))
+		return 2
+
+	defines = read_defines(header_path)
+	file_ids = {name: value for name, value in defines.items() if name.startswith("LOG_FILE_")}
+	files = {}
+	messages = {}
+	sites = []
+
+	for source_path in source_paths:
+		file_id, found = scan_source(source_path, file_ids)
+
+		if not found:
+			continue
+
+		if str(file_id) in files:
+			fail("%s and %s both use LOG_FILE_ID %d" % (files[str(file_id)], os.path.basename(source_path), file_id))
+
+		if file_id == defines["LOG_FILE_DROPPED"]:
+			fail("%s: LOG_FILE_ID %d is kept for the records-dropped record" % (source_path, file_id))
+
+		files[str(file_id)] = os.path.basename(source_path)
+
+		for line, macro, function, fmt, args in found:
+			where = "%s:%d" % (source_path, line)
+			skipped, sent = layout_args(fmt, args, defines["LOG_RECORD_PREFIX"], where)
+			words = len(sent) + sent.count(True)
+
+			if words > defines["LOG_RECORD_MAX_WORDS"]:
+				fail("%s: needs %d argument words, a record holds %d" % (where, words, defines["LOG_RECORD_MAX_WORDS"]))
+
+			messages["%d:%d" % (file_id, line)] = {
+				"level": LOG_MACROS[macro],
+				"function": function,
+				"format": fmt,
+				"args": args,
+			}
+			sites.append((file_id, line, args, skipped, sent))
+
+			if verbose:
+				print("log_table: %3d:%-5d %-9s %s" % (file_id, line, LOG_MACROS[macro], fmt))
+
+	write_table(out_path, header_path, defines, files, messages)
+	write_sites(sites_path, header_path, defines, sites)
+
+	if verbose:
+		print("log_table: %d messages in %d files" % (len(messages), len(files)))
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
@@ -0,0 +1,462 @@
+#!/usr/bin/env python3
+#
+# pgz_pack.py
+#
+#  Created on: Oct 19, 2026
+#      Author: micahbly
+#
+#  Builds the F256 pgZ from a manifest of segments, and generates the C header with the asset addresses
+#
+#  usage:
+#    pgz_pack.py manifest [-d dir]... [-o out.pgZ] [-H layout.h] [--lz4] [-v]
+#      -d: directory to look for segment files in. may be repeated; first match wins. default: the manifest's folder.
+#      -o: write the pgZ. every code/asset file must exist.
+#      -H: write the C address header. files that don't exist yet (e.g., code before it is linked) are skipped.
+#      --lz4: carry assets LZ4-compressed instead of loading them in place (see below). use the same setting for -H and -o.
+#      -v: list segments and the records they were merged into
+#
+#  manifest: one entry per line, # starts a comment
+#    code     NAME  file  phys_addr  [multibank]   program/overlay file
+#    asset    NAME  file  phys_addr  [multibank]   data file. gets NAME_PHYS_ADDR etc. in the header
+#    reserve  NAME  -     phys_addr  size          memory that nothing may be loaded over
+#    start    NAME                                 segment whose address the kernel jumps to
+#    lz4_home NAME                                 overlay whose bank carries the compressed assets in --lz4 mode
+#
+#  checks (any failure: nothing is written, exit 1):
+#    everything must fit in the F256's 512K of RAM
+#    a segment must not cross an 8K bank boundary, unless marked multibank
+#      (assets are mapped into one CPU slot to be edited, overlays are one bank each)
+#    no two segments/reserves may overlap
+#
+#  pgZ: 'Z', then records of 24-bit LE address, 24-bit LE length, data. a record of length 0 gives the start address.
+#    physically adjacent segments are merged into one record, so the kernel loader has fewer records to process.
+#
+#  --lz4: each asset is compressed (LZ4 block format, what cc65's decompress_lz4() reads) and the blobs are packed
+#    together at the top of the lz4_home overlay's bank, so they are in CPU space whenever that overlay is.
+#    the asset's own address range stays reserved; Startup_ExpandAssets() decompresses into it at boot.
+#    the header gets PGZ_ASSETS_LZ4 and the table that function walks. if the overlay's code grows into
+#    the blobs, the overlap check fails the pack.
+#
+
+import os
+import sys
+
+
+# **** definitions *****
+
+PHYS_RAM_SIZE = 0x80000		# 512K
+BANK_SIZE = 0x2000			# 8K MMU bank
+PGZ_SIGNATURE = b'Z'
+OVERLAY_CPU_ADDR = 0xA000	# overlays run from CPU slot 5 (OVERLAY_START_ADDR in app.h)
+LZ4_SEGMENT_NAME = "LZ4_ASSETS"
+
+LZ4_MIN_MATCH = 4			# LZ4 block format rules
+LZ4_LAST_LITERALS = 5		# last 5 bytes of a block are always literals
+LZ4_MF_LIMIT = 12			# last match must start at least this far from the end
+LZ4_MAX_OFFSET = 0xFFFF
+LZ4_SEARCH_DEPTH = 256
+
+HEADER_VALUE_COLUMN = 44	# column the value goes in, in generated #defines (same as app.h, tabs at 4)
+
+
+# **** manifest parsing *****
+
+class Segment:
+	def __init__(self, kind, name, file_name, addr, size, multibank, line_num):
+		self.kind = kind
+		self.name = name
+		self.file_name = file_name
+		self.addr = addr
+		self.size = size			# None if file not found (header-only runs)
+		self.multibank = multibank
+		self.line_num = line_num
+		self.loaded = (kind != "reserve")	# False: the range is only checked, nothing is put there by the pgZ
+		self.path = None
+		self.data = None
+
+	def end(self):
+		return self.addr + self.size
+
+
+def fail(msg):
+	sys.stderr.write("pgz_pack: %s\n" % msg)
+	sys.exit(1)
+
+
+def parse_number(text, where):
+	try:
+		return int(text, 0)
+	except ValueError:
+		fail("%s: '%s' is not a number" % (where, text))
+
+
+def find_file(file_name, search_dirs):
+	for d in search_dirs:
+		path = os.path.join(d, file_name)
+		if os.path.isfile(path):
+			return path
+	return None
+
+
+def read_manifest(manifest_path, search_dirs):
+	segments = []
+	start_name = None
+	lz4_home_name = None
+
+	with open(manifest_path, "r") as f:
+		lines = f.readlines()
+
+	for line_num, line in enumerate(lines, 1):
+		words = line.split("#", 1)[0].split()
+		where = "%s:%d" % (manifest_path, line_num)
+
+		if len(words) == 0:
+			continue
+
+		kind = words[0]
+
+		if kind in ("start", "lz4_home"):
+			if len(words) != 2:
+				fail("%s: expected '%s NAME'" % (where, kind))
+			if kind == "start":
+				start_name = words[1]
+			else:
+				lz4_home_name = words[1]
+			continue
+
+		if kind not in ("code", "asset", "reserve") or len(words) < 4:
+			fail("%s: expected 'code|asset|reserve NAME file phys_addr [...]'" % where)
+
+		name = words[1]
+		addr = parse_number(words[3], where)
+
+		if kind == "reserve":
+			if len(words) != 5:
+				fail("%s: expected 'reserve NAME - phys_addr size'" % where)
+			segments.append(Segment(kind, name, None, addr, parse_number(words[4], where), True, line_num))
+			continue
+
+		options = words[4:]
+		for o in options:
+			if o != "multibank":
+				fail("%s: unknown option '%s'" % (where, o))
+
+		seg = Segment(kind, name, words[2], addr, None, "multibank" in options, line_num)
+		seg.path = find_file(seg.file_name, search_dirs)
+		if seg.path is not None:
+			with open(seg.path, "rb") as data_file:
+				seg.data = data_file.read()
+			seg.size = len(seg.data)
+		segments.append(seg)
+
+	names = [s.name for s in segments]
+	for n in names:
+		if names.count(n) > 1:
+			fail("%s: '%s' is defined more than once" % (manifest_path, n))
+
+	if start_name is not None and start_name not in names:
+		fail("%s: start segment '%s' is not defined" % (manifest_path, start_name))
+
+	if lz4_home_name is not None and lz4_home_name not in names:
+		fail("%s: lz4_home segment '%s' is not defined" % (manifest_path, lz4_home_name))
+
+	return segments, start_name, lz4_home_name
+
+
+# **** LZ4 *****
+
+def lz4_write_length(out, value):
+	while value >= 255:
+		out.append(255)
+		value -= 255
+	out.append(value)
+
+
+def lz4_write_sequence(out, literals, offset, match_len):
+	lit_len = len(literals)
+	token = min(lit_len, 15) << 4
+
+	if match_len is not None:
+		token |= min(match_len - LZ4_MIN_MATCH, 15)
+
+	out.append(token)
+	if lit_len >= 15:
+		lz4_write_length(out, lit_len - 15)
+	out += literals
+
+	if match_len is not None:
+		out += offset.to_bytes(2, "little")
+		if match_len - LZ4_MIN_MATCH >= 15:
+			lz4_write_length(out, match_len - LZ4_MIN_MATCH - 15)
+
+
+# greedy LZ4 block compressor, longest match over the last LZ4_SEARCH_DEPTH places each 4-byte sequence was seen.
+# assets are a few K, so plain dicts of positions are fast enough.
+def lz4_compress(data):
+	out = bytearray()
+	n = len(data)
+	seen = {}
+	anchor = 0
+	i = 0
+
+	while i + LZ4_MF_LIMIT <= n:
+		key = data[i:i + LZ4_MIN_MATCH]
+		best_len = 0
+		best_pos = 0
+		max_len = n - LZ4_LAST_LITERALS - i
+
+		for candidate in reversed(seen.get(key, [])[-LZ4_SEARCH_DEPTH:]):
+			if i - candidate > LZ4_MAX_OFFSET:
+				break
+			match_len = LZ4_MIN_MATCH
+			while match_len < max_len and data[candidate + match_len] == data[i + match_len]:
+				match_len += 1
+			if match_len > best_len:
+				best_len = match_len
+				best_pos = candidate
+
+		if best_len == 0:
+			seen.setdefault(key, []).append(i)
+			i += 1
+			continue
+
+		lz4_write_sequence(out, data[anchor:i], i - best_pos, best_len)
+
+		for j in range(i, i + best_len):
+			seen.setdefault(data[j:j + LZ4_MIN_MATCH], []).append(j)
+
+		i += best_len
+		anchor = i
+
+	lz4_write_sequence(out, data[anchor:], None, None)
+	return bytes(out)
+
+
+# compress every asset into one blob at the top of the home overlay's bank. the assets stop being loaded in place.
+# returns a list of (asset segment, CPU address of its compressed data while the overlay is mapped, compressed size)
+def pack_lz4_assets(segments, lz4_home_name):
+	if lz4_home_name is None:
+		fail("--lz4 needs an 'lz4_home' entry in the manifest")
+
+	home = [s for s in segments if s.name == lz4_home_name][0]
+	blob = bytearray()
+	offsets = []
+
+	for s in segments:
+		if s.kind != "asset":
+			continue
+		if s.data is None:
+			fail("can't compress %s, not found" % s.file_name)
+		packed = lz4_compress(s.data)
+		offsets.append((s, len(blob), len(packed)))
+		blob += packed
+		s.loaded = False
+
+	if len(blob) > BANK_SIZE:
+		fail("compressed assets are %d bytes, more than one bank" % len(blob))
+
+	bank_base = home.addr - home.addr % BANK_SIZE
+	blob_addr = bank_base + BANK_SIZE - len(blob)
+	lz4_seg = Segment("lz4", LZ4_SEGMENT_NAME, None, blob_addr, len(blob), False, 0)
+	lz4_seg.data = bytes(blob)
+	segments.append(lz4_seg)
+
+	return [(s, OVERLAY_CPU_ADDR + (blob_addr - bank_base) + offset, size) for s, offset, size in offsets]
+
+
+# **** validation *****
+
+def validate(segments):
+	errors = []
+	sized = [s for s in segments if s.size is not None]
+
+	for s in sized:
+		if s.size == 0 and s.kind != "reserve":
+			errors.append("%s (%s) is empty" % (s.name, s.file_name))
+			continue
+		if s.end() > PHYS_RAM_SIZE:
+			errors.append("%s: $%05X-$%05X is past the end of RAM ($%05X)" % (s.name, s.addr, s.end() - 1, PHYS_RAM_SIZE))
+		if not s.multibank and s.addr // BANK_SIZE != (s.end() - 1) // BANK_SIZE:
+			errors.append("%s: $%05X-$%05X crosses from bank $%02X into bank $%02X (mark it multibank if that is intended)" % (s.name, s.addr, s.end() - 1, s.addr // BANK_SIZE, (s.end() - 1) // BANK_SIZE))
+
+	sized.sort(key=lambda s: s.addr)
+	for i in range(1, len(sized)):
+		a = sized[i - 1]
+		b = sized[i]
+		if b.addr < a.end():
+			errors.append("%s ($%05X-$%05X) overlaps %s ($%05X-$%05X)" % (b.name, b.addr, b.end() - 1, a.name, a.addr, a.end() - 1))
+
+	if len(errors) > 0:
+		for e in errors:
+			sys.stderr.write("pgz_pack: %s\n" % e)
+		sys.exit(1)
+
+
+# **** pgZ *****
+
+# merge physically adjacent segments into one load record. returns a list of (addr, bytes, [segment names])
+def build_records(segments):
+	loadable = sorted([s for s in segments if s.loaded], key=lambda s: s.addr)
+	records = []
+
+	for s in loadable:
+		if len(records) > 0 and records[-1][0] + len(records[-1][1]) == s.addr:
+			records[-1][1].extend(s.data)
+			records[-1][2].append(s.name)
+		else:
+			records.append((s.addr, bytearray(s.data), [s.name]))
+
+	return records
+
+
+def write_pgz(out_path, segments, start_name, verbose):
+	missing = [s for s in segments if s.loaded and s.data is None]
+	if len(missing) > 0:
+		fail("can't build pgZ, missing: %s" % ", ".join(s.file_name for s in missing))
+	if start_name is None:
+		fail("can't build pgZ, manifest has no 'start' entry")
+
+	start_addr = [s for s in segments if s.name == start_name][0].addr
+	records = build_records(segments)
+	out = bytearray(PGZ_SIGNATURE)
+
+	for addr, data, names in records:
+		out += addr.to_bytes(3, "little") + len(data).to_bytes(3, "little") + data
+		if verbose:
+			print("  $%05X  %6d bytes  %s" % (addr, len(data), " + ".join(names)))
+
+	out += start_addr.to_bytes(3, "little") + (0).to_bytes(3, "little")
+
+	with open(out_path, "wb") as f:
+		f.write(out)
+
+	num_loadable = len([s for s in segments if s.loaded])
+	print("pgz_pack: %s: %d segments in %d records, %d bytes, start $%04X" % (out_path, num_loadable, len(records), len(out), start_addr))
+
+
+# **** C header *****
+
+def define(name, value, comment=None):
+	text = "#define %s" % name
+	text += "\t" * max(1, (HEADER_VALUE_COLUMN - (len(text) // 4) * 4) // 4) + value
+	if comment is not None:
+		text += "\t// " + comment
+	return text + "\n"
+
+
+def write_header(out_path, manifest_path, segments, lz4_assets):
+	guard = os.path.basename(out_path).upper().replace(".", "_") + "_"
+	lines = []
+
+	lines.append("/*\n")
+	lines.append(" * %s\n" % os.path.basename(out_path))
+	lines.append(" *\n")
+	lines.append(" *  GENERATED by tools/pgz_pack.py from %s. Do not edit: change the manifest instead.\n" % os.path.basename(manifest_path))
+	lines.append(" *\n")
+	lines.append(" *  Where each asset is loaded in physical memory, so code and the pgZ can't drift apart.\n")
+	lines.append(" *    _PHYS_ADDR is the 20-bit address; _LOMED/_LO/_MED/_HI are the pieces VICKY registers want.\n")
+	lines.append(" *    _LEN is the size of the asset file at the time this was generated.\n")
+	lines.append(" */\n\n")
+	lines.append("#ifndef %s\n#define %s\n\n" % (guard, guard))
+
+	for s in segments:
+		if s.kind != "asset":
+			continue
+
+		if s.size is None:
+			fail("can't write header, %s not found" % s.file_name)
+
+		lines.append(define(s.name + "_PHYS_ADDR", "0x%05X" % s.addr, s.file_name))
+		lines.append(define(s.name + "_LOMED_ADDR", "0x%04X" % (s.addr & 0xFFFF)))
+		lines.append(define(s.name + "_LO_ADDR", "0x%02X" % (s.addr & 0xFF)))
+		lines.append(define(s.name + "_MED_ADDR", "0x%02X" % ((s.addr >> 8) & 0xFF)))
+		lines.append(define(s.name + "_HI_ADDR", "0x%02X" % ((s.addr >> 16) & 0xFF)))
+		lines.append(define(s.name + "_LEN", "%d" % s.size))
+		lines.append("\n")
+
+	if lz4_assets is not None:
+		lines.append("// assets are in the pgZ LZ4-compressed. Startup_ExpandAssets() puts them at the addresses above.\n")
+		lines.append("// table: CPU address of compressed data (with the overlay mapped), dest bank, offset in bank, uncompressed size\n")
+		lines.append("#define PGZ_ASSETS_LZ4\n")
+		lines.append(define("PGZ_LZ4_ASSET_COUNT", "%d" % len(lz4_assets)))
+		lines.append("#define PGZ_LZ4_ASSET_TABLE")
+		for s, src_addr, packed_size in lz4_assets:
+			lines.append(" \\\n\t{0x%04X, 0x%02X, 0x%04X, %d},\t/* %s, %d bytes packed */" % (src_addr, s.addr // BANK_SIZE, s.addr % BANK_SIZE, s.size, s.name, packed_size))
+		lines.append("\n\n")
+
+	lines.append("#endif /* %s */\n" % guard)
+	text = "".join(lines)
+
+	# don't touch the file if nothing changed, so make-style tools don't rebuild for nothing
+	if os.path.isfile(out_path):
+		with open(out_path, "r") as f:
+			if f.read() == text:
+				return
+
+	with open(out_path, "w") as f:
+		f.write(text)
+
+	print("pgz_pack: wrote %s" % out_path)
+
+
+# **** main *****
+
+def main(argv):
+	manifest_path = None
+	search_dirs = []
+	pgz_path = None
+	header_path = None
+	use_lz4 = False
+	verbose = False
+
+	i = 1
+	while i < len(argv):
+		arg = argv[i]
+		if arg in ("-d", "-o", "-H") and i + 1 < len(argv):
+			i += 1
+			if arg == "-d":
+				search_dirs.append(argv[i])
+			elif arg == "-o":
+				pgz_path = argv[i]
+			else:
+				header_path = argv[i]
+		elif arg == "-v":
+			verbose = True
+		elif arg == "--lz4":
+			use_lz4 = True
+		elif manifest_path is None and not arg.startswith("-"):
+			manifest_path = arg
+		else:
+			manifest_path = None
+			break
+		i += 1
+
+	if manifest_path is None or (pgz_path is None and header_path is None):
+		sys.stderr.write("usage: %s manifest [-d dir]... [-o out.pgZ] [-H layout.h] [--lz4] [-v]\n" % os.path.basename(argv[0]))
+		return 2
+
+	if len(search_dirs) == 0:
+		search_dirs.append(os.path.dirname(os.path.abspath(manifest_path)))
+
+	segments, start_name, lz4_home_name = read_manifest(manifest_path, search_dirs)
+	lz4_assets = pack_lz4_assets(segments, lz4_home_name) if use_lz4 else None
+	validate(segments)
+
+	if verbose or pgz_path is not None:
+		raw_size = sum(s.size for s in segments if s.kind == "asset" and s.size is not None)
+		if lz4_assets is not None:
+			print("pgz_pack: assets: %d bytes raw, %d bytes LZ4" % (raw_size, sum(size for s, addr, size in lz4_assets)))
+		else:
+			print("pgz_pack: assets: %d bytes raw (uncompressed mode)" % raw_size)
+
+	if header_path is not None:
+		write_header(header_path, manifest_path, segments, lz4_assets)
+
+	if pgz_path is not None:
+		write_pgz(pgz_path, segments, start_name, verbose)
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
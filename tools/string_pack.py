@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+#
+# string_pack.py
+#
+#  Created on: Oct 19, 2026
+#      Author: micahbly
+#
+#  Packs the game's UI strings into a dictionary-compressed blob for an EM bank, and generates the C header with their IDs
+#
+#  usage:
+#    string_pack.py strings.txt [-o strings.bin] [-H strings.h] [-v]
+#      -o: write the packed strings. pgz_manifest.txt loads it into the STRINGS bank.
+#      -H: write the C header: ID_STR_* for General_GetString(), and the blob layout strings.c reads it with
+#      -v: print the dictionary
+#    either way, prints how many bytes of MAIN the strings would have taken as C literals (that they no longer do).
+#
+#  strings file: one string per line, lines starting with # are comments
+#    ID_NAME  text to the end of the line
+#
+#  blob (all offsets from the start of the blob, little-endian):
+#    NUM_STRINGS 16-bit offsets of each string's codes
+#    STRINGS_DICT_ENTRIES + 1 16-bit offsets of the dictionary entries: entry n is the bytes from offset n to offset n+1
+#    dictionary entries: plain text
+#    the strings' codes, each ending in a 0: a byte below STRINGS_FIRST_CODE is itself;
+#      STRINGS_FIRST_CODE + n is dictionary entry n
+#
+#  the dictionary: pieces of text that come up more than once, picked greedily by how many bytes each saves
+#    (including the 2-byte offset each entry costs). entries are never made of other entries, so decoding is a table lookup.
+#
+#  checks (any failure: nothing is written, exit 1):
+#    IDs are unique names, at most 255 of them (STRINGS_NO_ID is 255)
+#    text is printable ASCII, and no longer than the STORAGE_GETSTRING_BUFFER it is decoded into
+#    the blob fits in an 8K bank
+#
+
+import os
+import re
+import sys
+
+
+# **** definitions *****
+
+BANK_SIZE = 0x2000				# 8K MMU bank. pgz_pack.py also checks the STRINGS asset doesn't cross one.
+MAX_STRINGS = 255				# IDs are uint8_t, and 255 is STRINGS_NO_ID
+MAX_TEXT_LEN = 255				# STORAGE_GETSTRING_BUFFER_LEN, less the terminator
+FIRST_CODE = 0x80				# codes from here up are dictionary entries
+MAX_DICT_ENTRIES = 0x100 - FIRST_CODE
+MAX_ENTRY_LEN = 16				# longer repeats than this are rare in UI text, and slow the search
+
+ID_RE = re.compile(r'^[A-Z_][A-Z0-9_]*$')
+
+HEADER_VALUE_COLUMN = 44		# column the value goes in, in generated #defines (same as pgz_pack.py)
+
+
+# **** helpers *****
+
+def fail(msg):
+	sys.stderr.write("string_pack: %s\n" % msg)
+	sys.exit(1)
+
+
+def pad_to(text, column):
+	return text + "\t" * max(1, (column - (len(text) // 4) * 4) // 4)
+
+
+def write_if_changed(out_path, data, is_binary):
+	# don't touch the file if nothing changed, so make-style tools don't rebuild for nothing
+	if os.path.isfile(out_path):
+		with open(out_path, "rb" if is_binary else "r") as f:
+			if f.read() == data:
+				return
+
+	with open(out_path, "wb" if is_binary else "w") as f:
+		f.write(data)
+
+	print("string_pack: wrote %s" % out_path)
+
+
+# **** reading *****
+
+def read_strings(strings_path):
+	strings = []
+
+	with open(strings_path, "r") as f:
+		lines = f.read().split("\n")
+
+	for line_num, line in enumerate(lines, 1):
+		where = "%s:%d" % (strings_path, line_num)
+
+		if line.strip() == "" or line.lstrip().startswith("#"):
+			continue
+
+		words = line.split(None, 1)
+		name = words[0]
+		text = words[1].rstrip("\r") if len(words) > 1 else ""
+
+		if not ID_RE.match(name):
+			fail("%s: '%s' isn't a usable C name for an ID" % (where, name))
+		if text == "":
+			fail("%s: %s has no text" % (where, name))
+		if len(text) > MAX_TEXT_LEN:
+			fail("%s: %s is %d characters, more than the %d the string buffer holds" % (where, name, len(text), MAX_TEXT_LEN))
+		for c in text:
+			if not " " <= c <= "~":
+				fail("%s: %s has a character that isn't printable ASCII" % (where, name))
+
+		strings.append((name, text))
+
+	names = [name for name, text in strings]
+	for name in names:
+		if names.count(name) > 1:
+			fail("%s: '%s' is defined more than once" % (strings_path, name))
+
+	if len(strings) == 0:
+		fail("%s: no strings" % strings_path)
+	if len(strings) > MAX_STRINGS:
+		fail("%s: %d strings, more than the %d an ID can name" % (strings_path, len(strings), MAX_STRINGS))
+
+	return strings
+
+
+# **** packing *****
+
+# pick dictionary entries and encode the strings with them. each encoded string is a str of code points below 0x100.
+def build_dictionary(texts):
+	encoded = list(texts)
+	dictionary = []
+
+	while len(dictionary) < MAX_DICT_ENTRIES:
+		# LOGIC:
+		#   candidates are runs of plain text (no codes), 2 to MAX_ENTRY_LEN long. str.count() doesn't count overlaps,
+		#   which is what replace() will actually find. ties go to the longer piece, then the first alphabetically,
+		#   so the same strings always pack the same way.
+		candidates = set()
+		for e in encoded:
+			for run in re.split("[\x80-\xff]", e):
+				for length in range(2, min(MAX_ENTRY_LEN, len(run)) + 1):
+					for i in range(len(run) - length + 1):
+						candidates.add(run[i:i + length])
+
+		best = None
+		best_key = (0, 0, "")
+		for piece in candidates:
+			uses = sum(e.count(piece) for e in encoded)
+			saving = uses * (len(piece) - 1) - len(piece) - 2
+			key = (saving, len(piece), "".join(chr(0x7F - ord(c)) for c in piece))
+			if saving > 0 and key > best_key:
+				best = piece
+				best_key = key
+
+		if best is None:
+			break
+
+		code = chr(FIRST_CODE + len(dictionary))
+		encoded = [e.replace(best, code) for e in encoded]
+		dictionary.append(best)
+
+	return dictionary, encoded
+
+
+def build_blob(strings, dictionary, encoded):
+	num_strings = len(strings)
+	dict_index_offset = num_strings * 2
+	dict_offset = dict_index_offset + (len(dictionary) + 1) * 2
+
+	dict_offsets = []
+	offset = dict_offset
+	for entry in dictionary:
+		dict_offsets.append(offset)
+		offset += len(entry)
+	dict_offsets.append(offset)
+
+	string_offsets = []
+	for e in encoded:
+		string_offsets.append(offset)
+		offset += len(e) + 1
+
+	blob = bytearray()
+	for o in string_offsets + dict_offsets:
+		blob += o.to_bytes(2, "little")
+	for entry in dictionary:
+		blob += entry.encode("ascii")
+	for e in encoded:
+		blob += bytes(ord(c) for c in e) + b"\0"
+
+	if len(blob) > BANK_SIZE:
+		fail("packed strings are %d bytes, more than one bank" % len(blob))
+
+	return bytes(blob), dict_index_offset
+
+
+# decode the blob the way General_GetString() does, to be sure it gives back what went in
+def check_blob(blob, strings, dictionary, dict_index_offset):
+	def word(at):
+		return blob[at] | (blob[at + 1] << 8)
+
+	for i, (name, text) in enumerate(strings):
+		at = word(i * 2)
+		out = ""
+		while blob[at] != 0:
+			code = blob[at]
+			if code < FIRST_CODE:
+				out += chr(code)
+			else:
+				n = dict_index_offset + (code - FIRST_CODE) * 2
+				out += blob[word(n):word(n + 2)].decode("ascii")
+			at += 1
+		if out != text:
+			fail("%s didn't decode back to its text. this is a bug in string_pack.py" % name)
+
+
+# **** C header *****
+
+def write_header(out_path, strings_path, strings, dictionary, blob, dict_index_offset, text_bytes):
+	guard = os.path.basename(out_path).upper().replace(".", "_") + "_"
+	lines = []
+
+	lines.append("/*\n")
+	lines.append(" * %s\n" % os.path.basename(out_path))
+	lines.append(" *\n")
+	lines.append(" *  GENERATED by tools/string_pack.py from %s. Do not edit: change the strings file instead.\n" % os.path.basename(strings_path))
+	lines.append(" *\n")
+	lines.append(" *  IDs for General_GetString(), and the layout of the packed strings (strings.bin) it decodes them from.\n")
+	lines.append(" *    strings.bin loads into an EM bank (STRINGS_PHYS_ADDR, pgz_layout.h); see string_pack.py for its format.\n")
+	lines.append(" */\n\n")
+	lines.append("#ifndef %s\n#define %s\n\n" % (guard, guard))
+	lines.append("// C includes\n#include <stdint.h>\n\n\n")
+
+	for i, (name, text) in enumerate(strings):
+		lines.append(pad_to("#define %s" % name, HEADER_VALUE_COLUMN) + "%d\n" % i)
+	lines.append("\n")
+
+	lines.append(pad_to("#define NUM_STRINGS", HEADER_VALUE_COLUMN) + "%d\n" % len(strings))
+	lines.append(pad_to("#define STRINGS_NO_ID", HEADER_VALUE_COLUMN) + "0xFF\t// never an ID\n")
+	lines.append(pad_to("#define STRINGS_TEXT_BYTES", HEADER_VALUE_COLUMN) + "%d\t// what they'd take in MAIN RODATA as C literals\n" % text_bytes)
+	lines.append(pad_to("#define STRINGS_PACKED_BYTES", HEADER_VALUE_COLUMN) + "%d\t// size of strings.bin\n" % len(blob))
+	lines.append(pad_to("#define STRINGS_MAX_LEN", HEADER_VALUE_COLUMN) + "%d\t// longest string, not counting the terminator\n" % max(len(text) for name, text in strings))
+	lines.append(pad_to("#define STRINGS_DICT_ENTRIES", HEADER_VALUE_COLUMN) + "%d\n" % len(dictionary))
+	lines.append(pad_to("#define STRINGS_DICT_INDEX_OFFSET", HEADER_VALUE_COLUMN) + "%d\t// in strings.bin: where the dictionary offsets start, after the string offsets\n" % dict_index_offset)
+	lines.append(pad_to("#define STRINGS_FIRST_CODE", HEADER_VALUE_COLUMN) + "0x%02X\t// codes from here up are dictionary entries\n" % FIRST_CODE)
+	lines.append("\n\n")
+
+	lines.append("// decode a string from the string bank into STORAGE_GETSTRING_BUFFER, for the calling program to use\n")
+	lines.append("// returns a pointer to STORAGE_GETSTRING_BUFFER. it's good until something else uses that buffer (logging, the asset streamer, saves).\n")
+	lines.append("char* General_GetString(uint8_t the_string_id);\n\n\n")
+
+	lines.append("#endif /* %s */\n" % guard)
+
+	write_if_changed(out_path, "".join(lines), False)
+
+
+# **** main *****
+
+def main(argv):
+	strings_path = None
+	bin_path = None
+	header_path = None
+	verbose = False
+
+	i = 1
+	while i < len(argv):
+		arg = argv[i]
+		if arg in ("-o", "-H") and i + 1 < len(argv):
+			i += 1
+			if arg == "-o":
+				bin_path = argv[i]
+			else:
+				header_path = argv[i]
+		elif arg == "-v":
+			verbose = True
+		elif strings_path is None and not arg.startswith("-"):
+			strings_path = arg
+		else:
+			strings_path = None
+			break
+		i += 1
+
+	if strings_path is None or (bin_path is None and header_path is None):
+		sys.stderr.write("usage: %s strings.txt [-o strings.bin] [-H strings.h] [-v]\n" % os.path.basename(argv[0]))
+		return 2
+
+	strings = read_strings(strings_path)
+	texts = [text for name, text in strings]
+	dictionary, encoded = build_dictionary(texts)
+	blob, dict_index_offset = build_blob(strings, dictionary, encoded)
+	check_blob(blob, strings, dictionary, dict_index_offset)
+
+	text_bytes = sum(len(t) + 1 for t in texts)
+
+	if verbose:
+		for n, entry in enumerate(dictionary):
+			print("string_pack: $%02X  \"%s\"" % (FIRST_CODE + n, entry))
+
+	print("string_pack: %d strings: %d bytes out of MAIN, %d bytes packed in their bank (%d dictionary entries)" % (len(strings), text_bytes, len(blob), len(dictionary)))
+
+	if bin_path is not None:
+		write_if_changed(bin_path, blob, True)
+
+	if header_path is not None:
+		write_header(header_path, strings_path, strings, dictionary, blob, dict_index_offset, text_bytes)
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
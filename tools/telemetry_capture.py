@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+#
+# telemetry_capture.py
+#
+#  Created on: Oct 19, 2026
+#      Author: micahbly
+#
+#  Reads the per-frame telemetry packets a USE_TELEMETRY build sends over serial, and writes them out as CSV and a plot
+#
+#  usage:
+#    telemetry_capture.py [-o out.csv] [-p plot.svg] [-q] [capture | --pty]
+#      capture: a file, or the serial device itself (set it up first, e.g. stty -f /dev/tty.usbserial-xxx 57600 raw).
+#        default: stdin.
+#      --pty: open a pseudo-terminal, print the name of its far end, and read from it. it stands in for the serial port:
+#        give the name to infest_host -t (a USE_TELEMETRY host build), or anything else that writes packets.
+#      -o: CSV, 1 row per packet. default: stdout.
+#      -p: an SVG plot of every column over the session (no plotting packages needed)
+#      -q: don't print the summary at the end
+#    stops at end of capture, or on ctrl-c. a pty ends when the game closes it.
+#
+#  a packet is TELEMETRY_PACKET_LEN bytes, starting with TELEMETRY_SYNC, whose bytes add up to 0 (see telemetry.h for the fields).
+#    binary log records (LOG_RECORD_SYNC) share the wire: they're the same length, and are stepped over whole.
+#    other bytes are skipped until a packet starts. a jump in seq is packets the game dropped (its TX ring was full).
+#
+
+import os
+import struct
+import sys
+
+
+# **** definitions *****
+
+TELEMETRY_PACKET_LEN = 16
+TELEMETRY_SYNC = 0x5A
+TELEMETRY_LATE = 0x01
+LOG_RECORD_SYNC = 0xA5
+
+# TelemetryPacket, after sync_. checksum_ is left off the CSV.
+PACKET_FORMAT = "<BHHbbBBBBHB"
+COLUMNS = ["seq", "px", "py", "hp", "lives", "humans", "missiles", "pickups", "io_swaps", "busy", "late"]
+PLOT_COLUMNS = ["px", "py", "hp", "lives", "humans", "missiles", "pickups", "io_swaps", "busy", "late"]
+
+PLOT_WIDTH = 900
+PLOT_ROW_HEIGHT = 70
+PLOT_MARGIN = 80
+
+
+# **** helpers *****
+
+def read_packets(stream, stats):
+	buffer = b""
+
+	while True:
+		try:
+			chunk = stream.read(256)
+		except OSError:
+			# a pty whose other end closed reads as an error, not end of file
+			chunk = b""
+		except KeyboardInterrupt:
+			chunk = b""
+
+		if not chunk:
+			break
+
+		buffer += chunk
+
+		while len(buffer) >= TELEMETRY_PACKET_LEN:
+			# LOGIC:
+			#   only a sync byte whose 16 bytes add to 0 starts a packet. a log record is stepped over whole so that its
+			#   argument bytes can't be mistaken for one. anything else: drop a byte and look again.
+			if buffer[0] == TELEMETRY_SYNC and sum(buffer[:TELEMETRY_PACKET_LEN]) & 0xFF == 0:
+				fields = struct.unpack(PACKET_FORMAT, buffer[1:TELEMETRY_PACKET_LEN - 1])
+				buffer = buffer[TELEMETRY_PACKET_LEN:]
+				yield dict(zip(COLUMNS, fields[:-1] + (1 if fields[-1] & TELEMETRY_LATE else 0,)))
+			elif buffer[0] == LOG_RECORD_SYNC:
+				buffer = buffer[TELEMETRY_PACKET_LEN:]
+				stats["log_records"] += 1
+			else:
+				buffer = buffer[1:]
+				stats["skipped"] += 1
+
+
+def write_plot(path, rows):
+	height = PLOT_MARGIN // 2 + PLOT_ROW_HEIGHT * len(PLOT_COLUMNS)
+	span = max(len(rows) - 1, 1)
+	x_scale = (PLOT_WIDTH - PLOT_MARGIN - 10) / span
+	out = ['<svg xmlns="http://www.w3.org/2000/svg" width="%d" height="%d" font-family="monospace" font-size="11">' % (PLOT_WIDTH, height)]
+	out.append('<rect width="100%" height="100%" fill="white"/>')
+
+	for n, column in enumerate(PLOT_COLUMNS):
+		values = [row[column] for row in rows]
+		lo = min(values) if values else 0
+		hi = max(values) if values else 0
+		top = 10 + n * PLOT_ROW_HEIGHT
+		bottom = top + PLOT_ROW_HEIGHT - 20
+		y_scale = (bottom - top) / max(hi - lo, 1)
+		points = " ".join("%.1f,%.1f" % (PLOT_MARGIN + i * x_scale, bottom - (v - lo) * y_scale) for i, v in enumerate(values))
+
+		out.append('<text x="4" y="%d">%s</text>' % (top + 12, column))
+		out.append('<text x="4" y="%d" fill="gray">%d..%d</text>' % (top + 26, lo, hi))
+		out.append('<line x1="%d" y1="%d" x2="%d" y2="%d" stroke="lightgray"/>' % (PLOT_MARGIN, bottom, PLOT_WIDTH - 10, bottom))
+		out.append('<polyline fill="none" stroke="steelblue" points="%s"/>' % points)
+
+	out.append('<text x="%d" y="%d" fill="gray">frames (%d packets)</text>' % (PLOT_MARGIN, height - 8, len(rows)))
+	out.append("</svg>")
+
+	with open(path, "w") as f:
+		f.write("\n".join(out) + "\n")
+
+
+def open_pty():
+	master, slave = os.openpty()
+	sys.stderr.write("telemetry_capture: waiting on %s\n" % os.ttyname(slave))
+	sys.stderr.flush()
+
+	# raw, so the line discipline leaves the bytes alone
+	try:
+		import tty
+		tty.setraw(slave)
+	except (ImportError, OSError):
+		pass
+
+	# the slave stays open here until the game has it open too, or the first read would see the pty as hung up
+	return os.fdopen(master, "rb", buffering=0), slave
+
+
+def main(argv):
+	csv_path = None
+	plot_path = None
+	capture = None
+	use_pty = False
+	quiet = False
+
+	i = 1
+	while i < len(argv):
+		arg = argv[i]
+		if arg == "-o" and i + 1 < len(argv):
+			i += 1
+			csv_path = argv[i]
+		elif arg == "-p" and i + 1 < len(argv):
+			i += 1
+			plot_path = argv[i]
+		elif arg == "-q":
+			quiet = True
+		elif arg == "--pty" and capture is None:
+			use_pty = True
+		elif not arg.startswith("-") and capture is None and not use_pty:
+			capture = arg
+		else:
+			sys.stderr.write("usage: %s [-o out.csv] [-p plot.svg] [-q] [capture | --pty]\n" % os.path.basename(argv[0]))
+			return 2
+		i += 1
+
+	slave = None
+	if use_pty:
+		stream, slave = open_pty()
+	elif capture:
+		stream = open(capture, "rb", buffering=0)
+	else:
+		stream = sys.stdin.buffer
+
+	out = open(csv_path, "w") if csv_path else sys.stdout
+	stats = {"skipped": 0, "log_records": 0, "missing": 0, "late": 0}
+	rows = []
+	last_seq = None
+
+	out.write(",".join(COLUMNS) + "\n")
+
+	for row in read_packets(stream, stats):
+		if slave is not None:
+			# the first packet means the game has the pty open: from here, its closing it ends the capture
+			os.close(slave)
+			slave = None
+
+		if last_seq is not None:
+			stats["missing"] += (row["seq"] - last_seq - 1) & 0xFF
+		last_seq = row["seq"]
+		stats["late"] += row["late"]
+
+		rows.append(row)
+		out.write(",".join(str(row[column]) for column in COLUMNS) + "\n")
+		out.flush()
+
+	if out is not sys.stdout:
+		out.close()
+
+	if plot_path:
+		write_plot(plot_path, rows)
+
+	if not quiet:
+		sys.stderr.write("telemetry_capture: %d packets, %d missing, %d late frames, %d log records stepped over, %d bytes skipped\n" %
+			(len(rows), stats["missing"], stats["late"], stats["log_records"], stats["skipped"]))
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
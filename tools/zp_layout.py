@@ -0,0 +1,302 @@
+#!/usr/bin/env python3
+#
+# zp_layout.py
+#
+#  Created on: Oct 19, 2026
+#      Author: micahbly
+#
+#  Lays out the game's zero page variables from zp_layout.txt, and generates the asm and C views of that layout
+#
+#  usage:
+#    zp_layout.py layout.txt -c linker.cfg [-i zp_layout.inc] [-H zp_layout.h] [-v]
+#      -c: the ld65 config. the ZP_LK memory area in it is where the variables go.
+#      -i: write the ca65 include: .exportzp list and the ZEROPAGE_LK segment. memory.asm includes it.
+#      -H: write the C header: ZP_* addresses, and ZP_LAYOUT_VARS(X) for host builds to define the variables with.
+#      -v: print the layout
+#
+#  layout file: one variable per line, # starts a comment
+#    name  size  C-type  comment...
+#    addresses are handed out in file order, from the start of ZP_LK. nothing else may put anything in ZEROPAGE_LK,
+#      or ld65 will move things out from under the addresses in the header.
+#
+#  checks (any failure: nothing is written, exit 1):
+#    names are unique, and sizes agree with the C type where the tool knows the type's size
+#    the variables fit in ZP_LK
+#    the zero page memory areas in the linker config don't overlap each other, or the MMU registers at $00/$01
+#
+
+import os
+import re
+import sys
+
+
+# **** definitions *****
+
+ZP_AREA_NAME = "ZP_LK"			# memory area in the linker config the variables go in
+ZP_END = 0x100
+ZP_FIRST_FREE = 0x02			# $00/$01 are MMU_MEM_CTRL/MMU_IO_CTRL
+POINTER_SIZE = 2
+KNOWN_SIZES = {
+	"uint8_t": 1, "int8_t": 1, "char": 1, "bool": 1,
+	"uint16_t": 2, "int16_t": 2,
+	"uint32_t": 4, "int32_t": 4,
+}
+
+HEADER_VALUE_COLUMN = 44		# column the value goes in, in generated #defines (same as pgz_pack.py)
+ASM_RES_COLUMN = 28				# column .res goes in, in the generated include
+
+
+# **** helpers *****
+
+def fail(msg):
+	sys.stderr.write("zp_layout: %s\n" % msg)
+	sys.exit(1)
+
+
+def parse_number(text, where):
+	try:
+		return int(text.replace("$", "0x"), 0)
+	except ValueError:
+		fail("%s: '%s' is not a number" % (where, text))
+
+
+def pad_to(text, column):
+	return text + "\t" * max(1, (column - (len(text) // 4) * 4) // 4)
+
+
+def write_if_changed(out_path, text):
+	# don't touch the file if nothing changed, so make-style tools don't rebuild for nothing
+	if os.path.isfile(out_path):
+		with open(out_path, "r") as f:
+			if f.read() == text:
+				return
+
+	with open(out_path, "w") as f:
+		f.write(text)
+
+	print("zp_layout: wrote %s" % out_path)
+
+
+# **** reading *****
+
+class Var:
+	def __init__(self, name, size, c_type, comment):
+		self.name = name
+		self.size = size
+		self.c_type = c_type
+		self.comment = comment
+		self.addr = None
+
+
+def read_layout(layout_path):
+	variables = []
+	seen = {}
+
+	with open(layout_path, "r") as f:
+		for line_num, line in enumerate(f, 1):
+			where = "%s:%d" % (os.path.basename(layout_path), line_num)
+			line = line.split("#", 1)[0].strip()
+			if line == "":
+				continue
+
+			fields = line.split(None, 3)
+			if len(fields) < 3:
+				fail("%s: expected name, size, C type" % where)
+
+			name, size_text, c_type = fields[0], fields[1], fields[2]
+			comment = fields[3] if len(fields) > 3 else ""
+
+			if not re.match(r"^zp_[a-z0-9_]+$", name):
+				fail("%s: '%s' should be a lowercase C name starting with zp_" % (where, name))
+			if name in seen:
+				fail("%s: %s already defined at line %d" % (where, name, seen[name]))
+			seen[name] = line_num
+
+			size = parse_number(size_text, where)
+			if size < 1:
+				fail("%s: %s has size %d" % (where, name, size))
+
+			expected = POINTER_SIZE if c_type.endswith("*") else KNOWN_SIZES.get(c_type)
+			if expected is not None and expected != size:
+				fail("%s: %s is a %s, which is %d bytes on the 6502, not %d" % (where, name, c_type, expected, size))
+
+			variables.append(Var(name, size, c_type, comment))
+
+	return variables
+
+
+def read_zp_areas(cfg_path):
+	# MEMORY { NAME: ... start = $xx, ... size = $yy; } -> {NAME: (start, size)} for the ones in zero page
+	with open(cfg_path, "r") as f:
+		text = f.read()
+
+	block = re.search(r"MEMORY\s*\{(.*?)\}", text, re.S)
+	if block is None:
+		fail("%s: no MEMORY block" % cfg_path)
+
+	areas = {}
+	for entry in block.group(1).split(";"):
+		m = re.match(r"\s*(\w+)\s*:(.*)", entry, re.S)
+		if m is None:
+			continue
+		start = re.search(r"\bstart\s*=\s*([$\w]+)\s*,", m.group(2))
+		size = re.search(r"\bsize\s*=\s*([$\w]+)(?:\s*-\s*([$\w]+))?\s*$", m.group(2).strip(), re.S)
+		if start is None or size is None:
+			continue	# computed from symbols: not a zero page area
+		try:
+			start_addr = int(start.group(1).replace("$", "0x"), 0)
+			area_size = int(size.group(1).replace("$", "0x"), 0)
+			if size.group(2) is not None:
+				area_size -= int(size.group(2).replace("$", "0x"), 0)
+		except ValueError:
+			continue
+		if start_addr < ZP_END:
+			areas[m.group(1)] = (start_addr, area_size)
+
+	return areas
+
+
+# **** checking *****
+
+def validate(variables, areas, cfg_path):
+	if ZP_AREA_NAME not in areas:
+		fail("%s: no %s memory area in zero page" % (cfg_path, ZP_AREA_NAME))
+
+	spans = sorted((start, start + size, name) for name, (start, size) in areas.items())
+	for start, end, name in spans:
+		if start < ZP_FIRST_FREE or end > ZP_END:
+			fail("%s: %s ($%02X-$%02X) is outside $%02X-$%02X" % (cfg_path, name, start, end - 1, ZP_FIRST_FREE, ZP_END - 1))
+	for (a_start, a_end, a_name), (b_start, b_end, b_name) in zip(spans, spans[1:]):
+		if b_start < a_end:
+			fail("%s: %s ($%02X-$%02X) overlaps %s ($%02X-$%02X)" % (cfg_path, a_name, a_start, a_end - 1, b_name, b_start, b_end - 1))
+
+	area_start, area_size = areas[ZP_AREA_NAME]
+	addr = area_start
+	for v in variables:
+		v.addr = addr
+		addr += v.size
+
+	used = addr - area_start
+	if used > area_size:
+		fail("variables need %d bytes, %s only has %d ($%02X-$%02X). last one that fits: %s" %
+			(used, ZP_AREA_NAME, area_size, area_start, area_start + area_size - 1,
+			([v.name for v in variables if v.addr + v.size <= area_start + area_size] or ["(none)"])[-1]))
+
+	return area_start, area_size, used
+
+
+# **** writing *****
+
+def generated_by(layout_path, comment_prefix):
+	return "%s GENERATED by tools/zp_layout.py from %s. Do not edit: change the layout file instead.\n" % (comment_prefix, os.path.basename(layout_path))
+
+
+def write_include(out_path, layout_path, variables, area_start, area_size, used):
+	lines = []
+
+	lines.append("; %s\n" % os.path.basename(out_path))
+	lines.append(";\n")
+	lines.append(generated_by(layout_path, ";"))
+	lines.append(";\n\n")
+
+	lines.append("; ZP_LK exports:\n")
+	for v in variables:
+		lines.append("\t.exportzp\t_%s\n" % v.name)
+	lines.append("\n")
+
+	lines.append(".segment \"ZEROPAGE_LK\" : zeropage\n\n")
+	lines.append("; -- ZEROPAGE_LK starts at $%02X, size = $%02X; %d bytes used\n\n" % (area_start, area_size, used))
+	for v in variables:
+		lines.append("%s.res %d\t; $%02X\n" % (pad_to("_%s:" % v.name, ASM_RES_COLUMN), v.size, v.addr))
+	lines.append("\n")
+
+	write_if_changed(out_path, "".join(lines))
+
+
+def write_header(out_path, layout_path, variables, area_start, area_size, used):
+	guard = os.path.basename(out_path).upper().replace(".", "_") + "_"
+	lines = []
+
+	lines.append("/*\n")
+	lines.append(" * %s\n" % os.path.basename(out_path))
+	lines.append(" *\n")
+	lines.append(generated_by(layout_path, " *"))
+	lines.append(" *\n")
+	lines.append(" *  Zero page addresses of the variables in memory.asm, for inline asm.\n")
+	lines.append(" *    C code uses the variables by name: extern + #pragma zpsym.\n")
+	lines.append(" */\n\n")
+	lines.append("#ifndef %s\n#define %s\n\n" % (guard, guard))
+
+	lines.append(pad_to("#define ZP_LK_START", HEADER_VALUE_COLUMN) + "0x%02X\n" % area_start)
+	lines.append(pad_to("#define ZP_LK_SIZE", HEADER_VALUE_COLUMN) + "0x%02X\n" % area_size)
+	lines.append(pad_to("#define ZP_LK_USED", HEADER_VALUE_COLUMN) + "%d\t// bytes free: %d\n\n" % (used, area_size - used))
+
+	for v in variables:
+		text = pad_to("#define %s" % v.name.upper(), HEADER_VALUE_COLUMN) + "0x%02X" % v.addr
+		text += "\t// %d byte%s: %s" % (v.size, "" if v.size == 1 else "s", v.comment) if v.comment else ""
+		lines.append(text.rstrip() + "\n")
+	lines.append("\n")
+
+	lines.append("// X(C type, name) for each variable, in address order\n")
+	lines.append("#define ZP_LAYOUT_VARS(X)")
+	for v in variables:
+		lines.append(" \\\n\tX(%s, %s)" % (v.c_type, v.name))
+	lines.append("\n\n")
+
+	lines.append("#endif /* %s */\n" % guard)
+
+	write_if_changed(out_path, "".join(lines))
+
+
+# **** main *****
+
+def main(argv):
+	layout_path = None
+	cfg_path = None
+	include_path = None
+	header_path = None
+	verbose = False
+
+	i = 1
+	while i < len(argv):
+		arg = argv[i]
+		if arg in ("-c", "-i", "-H") and i + 1 < len(argv):
+			i += 1
+			if arg == "-c":
+				cfg_path = argv[i]
+			elif arg == "-i":
+				include_path = argv[i]
+			else:
+				header_path = argv[i]
+		elif arg == "-v":
+			verbose = True
+		elif layout_path is None and not arg.startswith("-"):
+			layout_path = arg
+		else:
+			layout_path = None
+			break
+		i += 1
+
+	if layout_path is None or cfg_path is None:
+		sys.stderr.write("usage: %s layout.txt -c linker.cfg [-i zp_layout.inc] [-H zp_layout.h] [-v]\n" % os.path.basename(argv[0]))
+		return 2
+
+	variables = read_layout(layout_path)
+	area_start, area_size, used = validate(variables, read_zp_areas(cfg_path), cfg_path)
+
+	if verbose:
+		for v in variables:
+			print("zp_layout: $%02X  %-24s %d" % (v.addr, v.name, v.size))
+		print("zp_layout: %s %d of %d bytes used" % (ZP_AREA_NAME, used, area_size))
+
+	if include_path is not None:
+		write_include(include_path, layout_path, variables, area_start, area_size, used)
+
+	if header_path is not None:
+		write_header(header_path, layout_path, variables, area_start, area_size, used)
+
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv))
@@ -0,0 +1,67 @@
+/*
+ * zp_layout.h
+ *
+ * GENERATED by tools/zp_layout.py from zp_layout.txt. Do not edit: change the layout file instead.
+ *
+ *  Zero page addresses of the variables in memory.asm, for inline asm.
+ *    C code uses the variables by name: extern + #pragma zpsym.
+ */
+
+#ifndef ZP_LAYOUT_H_
+#define ZP_LAYOUT_H_
+
+#define ZP_LK_START							0x10
+#define ZP_LK_SIZE							0x2C
+#define ZP_LK_USED							36	// bytes free: 8
+
+#define ZP_BANK_SLOT						0x10	// 1 byte: LUT slot to be modified (0-7) (eg, if 0, will be $08, if 1, $09, etc.)
+#define ZP_BANK_NUM							0x11	// 1 byte: new LUT bank number to be set in zp_bank_slot
+#define ZP_OLD_BANK_NUM						0x12	// 1 byte: the original LUT bank number before being changed
+#define ZP_OLD_IO_PAGE						0x13	// 1 byte: the original IO page number before being changed
+#define ZP_PX								0x14	// 2 bytes: x coord for player
+#define ZP_PY								0x16	// 2 bytes: y coord for player
+#define ZP_JOY								0x18	// 1 byte: current state of the joysticks (both mapped to same thing; single-player game)
+#define ZP_NUM_BULLETS						0x19	// 1 byte: count of bullets left in current clip for the current weapon
+#define ZP_NUM_CLIPS						0x1A	// 1 byte: count of clips for the current weapon
+#define ZP_NUM_WARPS						0x1B	// 1 byte: count of warp modules owned by player
+#define ZP_SPEED							0x1C	// 1 byte: num. pixels that player moves per round
+#define ZP_POINTS							0x1D	// 2 bytes: point count
+#define ZP_HP								0x1F	// 1 byte: count of HP remaining
+#define ZP_BULLET_DMG						0x20	// 1 byte: damage to be caused by each bullet of current player weapon
+#define ZP_PLAYER_DIR						0x21	// 1 byte: direction player is facing. 0=north, 1=east, 2=south, 3=west. for showing which icon to use.
+#define ZP_LIVES							0x22	// 1 byte: remaining lives before end of game. if 0, and player's HP runs out, game is over.
+#define ZP_PLAYER_DIR_PREV					0x23	// 1 byte: direction player was facing last time checked
+#define ZP_TICKTOCK							0x24	// 2 bytes: frame counter, one tick per pass of App_RunFrame()
+#define ZP_SPRITE_IDX						0x26	// 1 byte: index of the sprite the outer loop is on
+#define ZP_OTHER_IDX						0x27	// 1 byte: index of the sprite the inner (collision) loop is on
+#define ZP_SPRITE							0x28	// 2 bytes: the sprite the outer loop is on
+#define ZP_OTHER							0x2A	// 2 bytes: the sprite the inner (collision) loop is on
+#define ZP_PLAYER_BOX						0x2C	// 8 bytes: the player's bounding box, for this frame's collision checks
+
+// X(C type, name) for each variable, in address order
+#define ZP_LAYOUT_VARS(X) \
+	X(uint8_t, zp_bank_slot) \
+	X(uint8_t, zp_bank_num) \
+	X(uint8_t, zp_old_bank_num) \
+	X(uint8_t, zp_old_io_page) \
+	X(uint16_t, zp_px) \
+	X(uint16_t, zp_py) \
+	X(uint8_t, zp_joy) \
+	X(uint8_t, zp_num_bullets) \
+	X(uint8_t, zp_num_clips) \
+	X(uint8_t, zp_num_warps) \
+	X(uint8_t, zp_speed) \
+	X(uint16_t, zp_points) \
+	X(int8_t, zp_hp) \
+	X(uint8_t, zp_bullet_dmg) \
+	X(uint8_t, zp_player_dir) \
+	X(int8_t, zp_lives) \
+	X(uint8_t, zp_player_dir_prev) \
+	X(uint16_t, zp_ticktock) \
+	X(uint8_t, zp_sprite_idx) \
+	X(uint8_t, zp_other_idx) \
+	X(Sprite*, zp_sprite) \
+	X(Sprite*, zp_other) \
+	X(Rectangle, zp_player_box)
+
+#endif /* ZP_LAYOUT_H_ */